@@ -0,0 +1,60 @@
+/* applets.c */
+#include <stdio.h>
+#include <string.h>
+
+#include "applets.h"
+
+/* 애플릿 표 (이름순) */
+const struct applet applets[] = {
+    { "cat",   cat_main },
+    { "cp",    cp_main },
+    { "grep",  grep_main },
+    { "ln",    ln_main },
+    { "ls",    ls_main },
+    { "mkdir", mkdir_main },
+    { "mv",    mv_main },
+    { "pwd",   pwd_main },
+    { "rm",    rm_main },
+    { "rmdir", rmdir_main },
+};
+
+const int num_applets = sizeof(applets) / sizeof(applets[0]);
+
+/*
+ * 애플릿 검색 함수
+ * 설명: 경로 부분과 "my_" 접두사를 떼고 찾으므로 "/usr/local/bin/my_ls"는 "ls"가 됩니다.
+ * 반환값: 애플릿, 없으면 NULL
+ */
+const struct applet *applet_find(const char *name) {
+    const char *base = strrchr(name, '/');
+
+    base = (base != NULL) ? base + 1 : name;
+    if (strncmp(base, "my_", 3) == 0) base += 3;
+    for (int k = 0; k < num_applets; k++) {
+        if (strcmp(applets[k].name, base) == 0) return &applets[k];
+    }
+    return NULL;
+}
+
+/*
+ * 애플릿 실행 함수 (argv만 있는 호출자용: 쉘, parallel)
+ * 설명: argc를 세어 main을 부르고, 같은 프로세스에서 계속 쓰일 수 있도록
+ *       애플릿이 stdio에 남긴 출력을 비웁니다.
+ * 반환값: 애플릿의 종료 상태
+ */
+int applet_run(const struct applet *a, char *argv[]) {
+    int argc = 0;
+    int status;
+
+    while (argv[argc] != NULL) argc++;
+    status = a->main(argc, argv);
+    fflush(stdout);
+    return status;
+}
+
+/* 애플릿 이름 목록 출력 */
+void applet_list(FILE *out) {
+    for (int k = 0; k < num_applets; k++)
+        fprintf(out, "%s%s", k > 0 ? " " : "", applets[k].name);
+    fprintf(out, "\n");
+}
@@ -0,0 +1,37 @@
+/* applets.h */
+#ifndef APPLETS_H
+#define APPLETS_H
+
+#include <stdio.h>
+
+/*
+ * 유틸리티(애플릿) 진입점
+ * 설명: 각 my_*.c의 main 본체입니다. -DMULTICALL로 빌드하면 파일별 main은 빠지고
+ *       다중 호출 바이너리(mybox)와 my_shell이 같은 구현을 함수로 직접 호출합니다.
+ */
+typedef int (*applet_main)(int argc, char *argv[]);
+
+struct applet {
+    const char *name;    // 명령어 이름 ("ls", "my_ls" 모두 이 이름으로 찾음)
+    applet_main main;
+};
+
+int cat_main(int argc, char *argv[]);
+int cp_main(int argc, char *argv[]);
+int grep_main(int argc, char *argv[]);
+int ln_main(int argc, char *argv[]);
+int ls_main(int argc, char *argv[]);
+int mkdir_main(int argc, char *argv[]);
+int mv_main(int argc, char *argv[]);
+int pwd_main(int argc, char *argv[]);
+int rm_main(int argc, char *argv[]);
+int rmdir_main(int argc, char *argv[]);
+
+extern const struct applet applets[];
+extern const int num_applets;
+
+const struct applet *applet_find(const char *name);
+int applet_run(const struct applet *a, char *argv[]);
+void applet_list(FILE *out);
+
+#endif
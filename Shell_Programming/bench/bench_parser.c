@@ -0,0 +1,107 @@
+/*
+ * bench_parser.c
+ * 설명: 인자가 많은 명령어 줄을 생성하여 반복 파싱하고 처리량을 측정합니다.
+ *       줄마다 아레나를 재사용하므로 첫 줄 이후에는 malloc이 거의 일어나지 않으며,
+ *       인자 수를 늘려도 단어당 시간이 일정(선형)한지 확인할 수 있습니다.
+ *
+ * 빌드: gcc -O2 -I.. -o bench_parser bench_parser.c ../shell_parser.c
+ * 사용: ./bench_parser [-n 줄 수] [-a 줄당 인자 수]   (기본: -n 2000 -a 1000)
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "shell_parser.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * 테스트 줄 생성
+ * 설명: 일반 단어, 작은/큰따옴표, 역슬래시, 재지향, 파이프, &&, ;를 섞어
+ *       대략 nargs개의 단어가 들어간 한 줄을 만듭니다.
+ */
+static char *make_line(int nargs, size_t *len) {
+    char *line = NULL;
+    FILE *out = open_memstream(&line, len);
+
+    if (out == NULL) return NULL;
+    fputs("cmd", out);
+    for (int k = 1; k < nargs; k++) {
+        switch (k % 16) {
+            case 3:  fprintf(out, " 'quoted arg %d'", k); break;
+            case 5:  fprintf(out, " \"dq \\\"%d\\\" $x\"", k); break;
+            case 7:  fprintf(out, " back\\ slash%d", k); break;
+            case 9:  fprintf(out, " > out%d.txt", k); break;
+            case 11: fputs(" | filter", out); break;
+            case 13: fputs(" && next", out); break;
+            case 15: fputs(" ; cmd", out); break;
+            default: fprintf(out, " arg%d", k); break;
+        }
+    }
+    fclose(out);
+    return line;
+}
+
+int main(int argc, char *argv[]) {
+    struct shell_parser p;
+    int nlines = 2000, nargs = 1000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:a:")) != -1) {
+        switch (opt) {
+            case 'n': nlines = atoi(optarg); break;
+            case 'a': nargs = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-n lines] [-a args_per_line]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    size_t len;
+    char *line = make_line(nargs, &len);
+    if (line == NULL) {
+        perror("make_line");
+        return 1;
+    }
+
+    parser_init(&p);
+
+    // 결과 확인용: 한 줄의 단어/명령어 수
+    struct ast_list *list = parse_line(&p, line, len);
+    long words = 0, cmds = 0;
+    if (list == NULL) {
+        fprintf(stderr, "parse failed\n");
+        return 1;
+    }
+    for (int i = 0; i < list->nitems; i++) {
+        const struct ast_and_or *ao = &list->items[i].and_or;
+        for (int j = 0; j < ao->npipes; j++) {
+            for (int k = 0; k < ao->pipes[j].ncmds; k++) {
+                words += ao->pipes[j].cmds[k].argc + ao->pipes[j].cmds[k].nredirs;
+                cmds++;
+            }
+        }
+    }
+
+    double start = now_sec();
+    for (int i = 0; i < nlines; i++) {
+        if (parse_line(&p, line, len) == NULL) return 1;
+    }
+    double elapsed = now_sec() - start;
+
+    printf("line: %zu bytes, %ld words, %ld commands\n", len, words, cmds);
+    printf("parsed %d lines in %.3fs: %.1f MB/s, %.0f lines/s, %.1f ns/word\n",
+           nlines, elapsed, (double)len * nlines / elapsed / 1e6, nlines / elapsed,
+           elapsed * 1e9 / ((double)words * nlines));
+
+    parser_free(&p);
+    free(line);
+    return 0;
+}
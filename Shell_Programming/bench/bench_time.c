@@ -0,0 +1,204 @@
+/*
+ * bench_time.c
+ * 설명: 명령어 하나를 여러 번 실행하여 벽시계/user/sys 시간과 최대 RSS를 재고
+ *       결과를 JSON 한 줄로 출력합니다 (run_bench.sh가 모아서 하나의 문서로 만듦).
+ *       -p로 준 준비 명령어(sh -c)는 매 실행 전에 돌리며 시간에 넣지 않습니다
+ *       (rm -r 전에 트리 다시 만들기, cp 전에 대상 지우기 등).
+ *       표준 출력은 /dev/null이 아니라 이 프로그램이 비우는 파이프로 연결합니다.
+ *       GNU grep은 출력이 /dev/null이면 첫 매칭에서 끝내므로 (-q처럼) 공정하지 않기 때문입니다.
+ *
+ * 빌드: make bench  (또는 gcc -O2 -o bench_time bench_time.c)
+ * 사용: ./bench_time [-n 횟수] [-w 예열 횟수] [-p 준비 명령어] [-i 입력 파일]
+ *                    [-k 작업 수] [-t 이름] [-m 구현] -- 명령어 [인자...]
+ *       -k: 한 번 실행이 처리하는 작업 수 (쉘 스크립트의 명령어 줄 수 등), ops_per_s 계산에 사용
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+struct sample {
+    double real, user, sys;
+    long maxrss;      // KB
+    int status;
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double tv_sec(struct timeval tv) {
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* 준비 명령어 실행 (시간 측정 밖) */
+static int run_prep(const char *prep) {
+    int status = system(prep);
+    return (status == 0) ? 0 : -1;
+}
+
+/* 자식의 출력 비우기 (splice로 /dev/null에 넘기고, 안 되면 read) */
+static void drain(int fd) {
+    static char buf[1 << 16];
+    int null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+
+    for (;;) {
+        ssize_t n = (null_fd >= 0) ? splice(fd, NULL, null_fd, NULL, 1 << 20, SPLICE_F_MOVE) : -1;
+        if (n < 0) n = read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+    }
+    if (null_fd >= 0) close(null_fd);
+}
+
+/* 한 번 실행: 표준 출력은 파이프 (부모가 비움), 표준 입력은 input (없으면 /dev/null) */
+static int run_once(char *argv[], const char *input, struct sample *s) {
+    struct rusage ru;
+    int status;
+    int pfd[2];
+    double start;
+    pid_t pid;
+
+    if (pipe2(pfd, O_CLOEXEC) < 0) {
+        perror("pipe");
+        return -1;
+    }
+    start = now_sec();
+    pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(pfd[0]);
+        close(pfd[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        int in = open(input != NULL ? input : "/dev/null", O_RDONLY);
+
+        if (in < 0) {
+            perror(input != NULL ? input : "/dev/null");
+            _exit(126);
+        }
+        dup2(in, STDIN_FILENO);
+        dup2(pfd[1], STDOUT_FILENO);
+        execvp(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+    close(pfd[1]);
+    drain(pfd[0]);
+    close(pfd[0]);
+    if (wait4(pid, &status, 0, &ru) < 0) {
+        perror("wait4");
+        return -1;
+    }
+    s->real = now_sec() - start;
+    s->user = tv_sec(ru.ru_utime);
+    s->sys = tv_sec(ru.ru_stime);
+    s->maxrss = ru.ru_maxrss;
+    s->status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    return 0;
+}
+
+static int cmp_real(const void *a, const void *b) {
+    double x = ((const struct sample *)a)->real, y = ((const struct sample *)b)->real;
+    return (x > y) - (x < y);
+}
+
+/* JSON 문자열 출력 (따옴표, 역슬래시, 제어 문자 이스케이프) */
+static void json_str(const char *s) {
+    putchar('"');
+    for (; *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') printf("\\%c", c);
+        else if (c < 0x20) printf("\\u%04x", c);
+        else putchar(c);
+    }
+    putchar('"');
+}
+
+int main(int argc, char *argv[]) {
+    const char *prep = NULL, *input = NULL, *name = NULL, *impl = NULL;
+    int runs = 5, warmup = 1, opt;
+    long ops = 0;
+    struct sample *samples;
+
+    while ((opt = getopt(argc, argv, "+n:w:p:i:k:t:m:")) != -1) {
+        switch (opt) {
+            case 'n': runs = atoi(optarg); break;
+            case 'w': warmup = atoi(optarg); break;
+            case 'p': prep = optarg; break;
+            case 'i': input = optarg; break;
+            case 'k': ops = atol(optarg); break;
+            case 't': name = optarg; break;
+            case 'm': impl = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-n runs] [-w warmup] [-p prep] [-i input] [-k ops] "
+                                "[-t name] [-m impl] -- cmd [args...]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc || runs < 1) {
+        fprintf(stderr, "%s: missing command\n", argv[0]);
+        return 1;
+    }
+    argv += optind;
+
+    samples = calloc(runs, sizeof(*samples));
+    if (samples == NULL) {
+        perror("calloc");
+        return 1;
+    }
+
+    // 예열 (페이지 캐시, 동적 링커 캐시)
+    for (int k = 0; k < warmup; k++) {
+        struct sample s;
+        if (prep != NULL && run_prep(prep) < 0) break;
+        run_once(argv, input, &s);
+    }
+
+    for (int k = 0; k < runs; k++) {
+        if (prep != NULL && run_prep(prep) < 0) {
+            fprintf(stderr, "%s: prepare command failed: %s\n", argv[0], prep);
+            return 1;
+        }
+        if (run_once(argv, input, &samples[k]) < 0) return 1;
+    }
+
+    // 사용자/시스템 시간과 RSS는 평균, 벽시계 시간은 최소/중앙값/평균
+    double mean = 0, user = 0, sys = 0;
+    long maxrss = 0;
+    for (int k = 0; k < runs; k++) {
+        mean += samples[k].real / runs;
+        user += samples[k].user / runs;
+        sys += samples[k].sys / runs;
+        if (samples[k].maxrss > maxrss) maxrss = samples[k].maxrss;
+    }
+    int status = samples[runs - 1].status;
+    qsort(samples, runs, sizeof(*samples), cmp_real);
+    double median = (runs % 2) ? samples[runs / 2].real
+                               : (samples[runs / 2 - 1].real + samples[runs / 2].real) / 2;
+
+    printf("{\"name\": ");
+    json_str(name != NULL ? name : argv[0]);
+    printf(", \"impl\": ");
+    json_str(impl != NULL ? impl : argv[0]);
+    printf(", \"argv\": [");
+    for (int k = 0; argv[k] != NULL; k++) {
+        if (k > 0) printf(", ");
+        json_str(argv[k]);
+    }
+    printf("], \"runs\": %d, \"min_s\": %.6f, \"median_s\": %.6f, \"mean_s\": %.6f, "
+           "\"user_s\": %.6f, \"sys_s\": %.6f, \"maxrss_kb\": %ld, \"status\": %d",
+           runs, samples[0].real, median, mean, user, sys, maxrss, status);
+    if (ops > 0) printf(", \"ops\": %ld, \"ops_per_s\": %.1f", ops, ops / median);
+    printf("}\n");
+
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * gen_corpus.c
+ * 설명: 벤치마크용 입력을 고정된 시드로 만듭니다. 같은 인자와 시드면 항상 같은
+ *       바이트열/디렉토리가 나오므로 릴리스 사이의 측정값을 그대로 비교할 수 있습니다.
+ *
+ *   log  <파일> <MB>               줄 길이가 다양한 로그 (짧은 줄 위주, 가끔 수 KB ~ 수십 KB 줄,
+ *                                  빈 줄, 제어 문자, 대소문자가 섞인 단어)
+ *   flat <디렉토리> <개수>          한 디렉토리에 빈 파일 N개 (이름 순서와 생성 순서가 다름)
+ *   tree <디렉토리> <깊이> <가지 수> <파일 수>
+ *                                  모든 디렉토리가 가지 수만큼 하위 디렉토리와 파일을 가진 트리
+ *                                  (파일 크기 0 ~ 8KB, 가지 수 1이면 깊은 사슬)
+ *
+ * 빌드: make bench  (또는 gcc -O2 -o gen_corpus gen_corpus.c)
+ * 사용: ./gen_corpus [-s 시드] log|flat|tree ...
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#define OUT_BUF_SIZE  (4 * 1024 * 1024)
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+/* xorshift64* (구현과 플랫폼에 관계없이 같은 수열) */
+static uint64_t rng(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545f4914f6cdd1dULL;
+}
+
+static unsigned rng_below(unsigned n) {
+    return (unsigned)((rng() >> 32) % n);
+}
+
+/* 검색 대상 단어 (벤치마크가 고르는 패턴의 매칭 비율이 다르도록 빈도를 다르게 씀) */
+static const char *common_words[] = {
+    "the", "request", "response", "connection", "thread", "buffer", "cache", "memory",
+    "process", "handler", "socket", "client", "server", "queue", "worker", "session",
+    "Request", "Thread", "BUFFER", "Cache", "user", "file", "read", "write", "open",
+    "close", "retry", "status", "value", "index", "node", "path",
+};
+static const char *rare_words[] = { "timeout", "Timeout", "TIMEOUT", "segfault", "deadlock", "panic" };
+static const char *levels[] = { "INFO", "DEBUG", "WARN", "ERROR", "TRACE" };
+
+#define NWORDS(a) (sizeof(a) / sizeof(a[0]))
+
+/* 줄 길이 분포: 60% 20~80, 30% 80~300, 9% 300~2000, 1% 2000~20000 바이트 */
+static size_t line_target(void) {
+    unsigned r = rng_below(100);
+
+    if (r < 60) return 20 + rng_below(60);
+    if (r < 90) return 80 + rng_below(220);
+    if (r < 99) return 300 + rng_below(1700);
+    return 2000 + rng_below(18000);
+}
+
+static int gen_log(const char *path, long mb) {
+    FILE *out = fopen(path, "we");
+    char *buf = malloc(OUT_BUF_SIZE);
+    unsigned long long total = (unsigned long long)mb << 20;
+    unsigned long long written = 0, lineno = 0;
+
+    if (out == NULL || buf == NULL) {
+        perror(path);
+        return 1;
+    }
+    setvbuf(out, buf, _IOFBF, OUT_BUF_SIZE);
+
+    while (written < total) {
+        char line[20100];
+        size_t len, target;
+        unsigned r = rng_below(1000);
+
+        lineno++;
+        if (r < 30) {               // 3%: 빈 줄
+            fputc('\n', out);
+            written++;
+            continue;
+        }
+
+        target = line_target();
+        len = sprintf(line, "2026-01-%02u %02u:%02u:%02u.%03u [%s] ",
+                      1 + (unsigned)(lineno / 86400000) % 28, (unsigned)(lineno / 3600000) % 24,
+                      (unsigned)(lineno / 60000) % 60, (unsigned)(lineno / 1000) % 60,
+                      (unsigned)(lineno % 1000), levels[rng_below(NWORDS(levels))]);
+        while (len < target) {
+            const char *w = rng_below(200) == 0 ? rare_words[rng_below(NWORDS(rare_words))]
+                                                : common_words[rng_below(NWORDS(common_words))];
+            len += sprintf(line + len, "%s%s", w, rng_below(8) == 0 ? "=" : " ");
+            if (rng_below(16) == 0) len += sprintf(line + len, "%u ", (unsigned)rng_below(100000));
+        }
+        if (r < 35) line[len++] = (char)(1 + rng_below(31));   // 0.5%: 제어 문자 (cat -v)
+        line[len++] = '\n';
+        fwrite(line, 1, len, out);
+        written += len;
+    }
+
+    if (fclose(out) != 0) {
+        perror(path);
+        free(buf);
+        return 1;
+    }
+    free(buf);
+    return 0;
+}
+
+static int gen_flat(const char *dir, long count) {
+    int dfd;
+
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+        perror(dir);
+        return 1;
+    }
+    dfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0) {
+        perror(dir);
+        return 1;
+    }
+    for (long k = 0; k < count; k++) {
+        char name[64];
+        int fd;
+
+        // 앞부분을 난수로 두어 생성 순서(디렉토리 순서)와 이름 순서가 다르게 함
+        snprintf(name, sizeof(name), "%08x_%ld.dat", (unsigned)(rng() >> 32), k);
+        fd = openat(dfd, name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            perror(name);
+            close(dfd);
+            return 1;
+        }
+        close(fd);
+    }
+    close(dfd);
+    return 0;
+}
+
+static char fill[8192];
+
+static int gen_tree_at(int pfd, const char *name, int depth, int fanout, int files) {
+    int dfd, status = 0;
+
+    if (mkdirat(pfd, name, 0755) < 0 && errno != EEXIST) {
+        perror(name);
+        return 1;
+    }
+    dfd = openat(pfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0) {
+        perror(name);
+        return 1;
+    }
+
+    for (int k = 0; k < files; k++) {
+        char fname[32];
+        size_t size = rng_below(sizeof(fill));
+        int fd;
+
+        snprintf(fname, sizeof(fname), "file%d.txt", k);
+        fd = openat(dfd, fname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0 || write(fd, fill + rng_below(64), size > 64 ? size - 64 : size) < 0) {
+            perror(fname);
+            status = 1;
+        }
+        if (fd >= 0) close(fd);
+    }
+    for (int k = 0; depth > 0 && k < fanout && status == 0; k++) {
+        char dname[32];
+
+        snprintf(dname, sizeof(dname), "dir%d", k);
+        status = gen_tree_at(dfd, dname, depth - 1, fanout, files);
+    }
+    close(dfd);
+    return status;
+}
+
+static int gen_tree(const char *dir, int depth, int fanout, int files) {
+    // 파일 내용: 로그처럼 보이는 텍스트 (grep -r 등에도 쓸 수 있게)
+    for (size_t k = 0; k < sizeof(fill); k++)
+        fill[k] = (k % 64 == 63) ? '\n' : "abcdefghijklmnopqrstuvwxyz timeout "[rng_below(35)];
+    return gen_tree_at(AT_FDCWD, dir, depth, fanout, files);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-s seed] log <file> <MB>\n"
+                    "       %s [-s seed] flat <dir> <count>\n"
+                    "       %s [-s seed] tree <dir> <depth> <fanout> <files>\n", prog, prog, prog);
+}
+
+int main(int argc, char *argv[]) {
+    int opt;
+
+    while ((opt = getopt(argc, argv, "+s:")) != -1) {
+        switch (opt) {
+            case 's': rng_state ^= strtoull(optarg, NULL, 0) * 0x9e3779b97f4a7c15ULL + 1; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    argv += optind;
+    argc -= optind;
+
+    if (argc == 3 && strcmp(argv[0], "log") == 0) return gen_log(argv[1], atol(argv[2]));
+    if (argc == 3 && strcmp(argv[0], "flat") == 0) return gen_flat(argv[1], atol(argv[2]));
+    if (argc == 5 && strcmp(argv[0], "tree") == 0)
+        return gen_tree(argv[1], atoi(argv[2]), atoi(argv[3]), atoi(argv[4]));
+    usage(argv[0]);
+    return 1;
+}
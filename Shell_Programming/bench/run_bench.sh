@@ -0,0 +1,209 @@
+#!/bin/sh
+# run_bench.sh
+# 설명: 벤치마크 모음. gen_corpus로 고정 시드 입력(큰 로그, 항목이 많은 디렉토리,
+#       넓은 트리, 깊은 트리)을 만들고, 각 도구와 같은 일을 하는 coreutils 명령어를
+#       bench_time으로 번갈아 재어 결과를 JSON 하나로 출력합니다.
+#       진행 상황과 (my / coreutils) 비율 요약은 stderr로 출력합니다.
+#
+# 사용: ./bench/run_bench.sh <빌드 디렉토리> [결과 JSON 파일]   (make benchmark)
+#   BENCH_SCALE  full(기본: 2GB 로그, 100만 항목) 또는 small(64MB, 2만 항목)
+#   BENCH_RUNS   측정 횟수 (기본 3, 중앙값 사용)
+#   BENCH_DATA   입력을 만들 디렉토리 (기본 build/bench-data, 한 번 만들면 재사용)
+#   BENCH_LOG_MB, BENCH_FLAT, BENCH_TREE("깊이 가지 파일"), BENCH_DEEP, BENCH_SHELL_N: 크기 개별 지정
+set -e
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 <build dir> [result.json]" >&2
+    exit 1
+fi
+
+BIN=$(cd "$1" && pwd)
+OUT=${2:-}
+HERE=$(cd "$(dirname "$0")" && pwd)
+SCALE=${BENCH_SCALE:-full}
+RUNS=${BENCH_RUNS:-3}
+DATA=${BENCH_DATA:-$HERE/../build/bench-data}
+export LC_ALL=C
+
+case "$SCALE" in
+    small) LOG_MB=64;   FLAT=20000;   TREE="4 4 10"; DEEP="64 1 2";  SHELL_N=500 ;;
+    full)  LOG_MB=2048; FLAT=1000000; TREE="6 4 20"; DEEP="256 1 4"; SHELL_N=2000 ;;
+    *) echo "$0: unknown BENCH_SCALE '$SCALE' (small, full)" >&2; exit 1 ;;
+esac
+LOG_MB=${BENCH_LOG_MB:-$LOG_MB}
+FLAT=${BENCH_FLAT:-$FLAT}
+TREE=${BENCH_TREE:-$TREE}
+DEEP=${BENCH_DEEP:-$DEEP}
+SHELL_N=${BENCH_SHELL_N:-$SHELL_N}
+
+for prog in bench_time gen_corpus my_grep my_cat my_cp my_ls my_rm my_shell; do
+    if [ ! -x "$BIN/$prog" ]; then
+        echo "$0: $BIN/$prog not found (run 'make release bench' first)" >&2
+        exit 1
+    fi
+done
+
+# --- 입력 만들기 (크기가 같으면 다시 만들지 않음) ---
+CORPUS="$DATA/$SCALE-$LOG_MB-$FLAT-$(echo "$TREE-$DEEP" | tr ' ' '_')"
+LOG="$CORPUS/log.txt"
+mkdir -p "$CORPUS"
+if [ ! -f "$CORPUS/.done" ]; then
+    echo "generating corpus in $CORPUS ..." >&2
+    rm -rf "$CORPUS"/*
+    "$BIN/gen_corpus" log "$LOG" "$LOG_MB"
+    "$BIN/gen_corpus" flat "$CORPUS/flat" "$FLAT"
+    "$BIN/gen_corpus" tree "$CORPUS/tree" $TREE
+    "$BIN/gen_corpus" tree "$CORPUS/deep" $DEEP
+    : > "$CORPUS/.done"
+fi
+
+WORK="$CORPUS/work"
+RESULTS=$(mktemp "${TMPDIR:-/tmp}/bench.XXXXXX")
+trap 'rm -f "$RESULTS"; rm -rf "$WORK"' EXIT
+mkdir -p "$WORK"
+
+# bt 이름 구현 [bench_time 옵션...] -- 명령어 [인자...]
+bt() {
+    name=$1
+    impl=$2
+    shift 2
+    if line=$("$BIN/bench_time" -n "$RUNS" -t "$name" -m "$impl" "$@"); then
+        printf '%s\n' "$line" >> "$RESULTS"
+        printf '  %-24s %-10s %s s\n' "$name" "$impl" \
+            "$(printf '%s' "$line" | sed 's/.*"median_s": \([0-9.]*\).*/\1/')" >&2
+    else
+        echo "  $name ($impl): failed" >&2
+    fi
+}
+
+# --- grep: -i -n -v -c -l 의 모든 조합 (coreutils는 고정 문자열 검색 grep -F) ---
+echo "grep" >&2
+mask=0
+while [ $mask -lt 32 ]; do
+    opts=""
+    [ $((mask & 1)) -ne 0 ] && opts="${opts}i"
+    [ $((mask & 2)) -ne 0 ] && opts="${opts}n"
+    [ $((mask & 4)) -ne 0 ] && opts="${opts}v"
+    [ $((mask & 8)) -ne 0 ] && opts="${opts}c"
+    [ $((mask & 16)) -ne 0 ] && opts="${opts}l"
+    flag=${opts:+-$opts}
+    bt "grep${flag:+ $flag}" my -- "$BIN/my_grep" $flag timeout "$LOG"
+    bt "grep${flag:+ $flag}" coreutils -- grep -F $flag timeout "$LOG"
+    mask=$((mask + 1))
+done
+bt "grep -j1" my -- "$BIN/my_grep" -j1 timeout "$LOG"
+bt "grep -c (rare)" my -- "$BIN/my_grep" -c deadlock "$LOG"
+bt "grep -c (rare)" coreutils -- grep -F -c deadlock "$LOG"
+bt "grep -c (stdin)" my -i "$LOG" -- "$BIN/my_grep" -c timeout
+bt "grep -c (stdin)" coreutils -i "$LOG" -- grep -F -c timeout
+
+# --- grep -E: 필수 리터럴이 있는 패턴, 선택(리터럴 없음), 클래스와 반복, 앵커 ---
+for re in 'ERROR.*timeout' 'timeout|deadlock' 'thread [0-9]+' '[0-9]{5} ' '^2026-01-0[1-3] ' '(panic|segfault)$'; do
+    bt "grep -E $re" my -- "$BIN/my_grep" -E -c "$re" "$LOG"
+    bt "grep -E $re" coreutils -- grep -E -c "$re" "$LOG"
+done
+
+# --- grep -e/-f: 작은 패턴 집합과 큰 집합 (대부분 매칭 없는 낱말 + 로그에 있는 낱말 몇 개) ---
+PATS="$WORK/patterns.txt"
+awk 'BEGIN { for (k = 0; k < 1000; k++) printf "w%05dq\n", k * 7919 % 100000;
+             print "timeout"; print "deadlock"; print "segfault" }' > "$PATS"
+bt "grep -e x3" my -- "$BIN/my_grep" -c -e timeout -e deadlock -e segfault "$LOG"
+bt "grep -e x3" coreutils -- grep -F -c -e timeout -e deadlock -e segfault "$LOG"
+bt "grep -f (1003)" my -- "$BIN/my_grep" -c -f "$PATS" "$LOG"
+bt "grep -f (1003)" coreutils -- grep -F -c -f "$PATS" "$LOG"
+
+# --- grep -r: 넓은 트리 재귀 검색 (매칭 없음, 이름 거르기) ---
+bt "grep -r -l (rare)" my -- "$BIN/my_grep" -r -l deadlock "$CORPUS/tree"
+bt "grep -r -l (rare)" coreutils -- grep -r -F -l deadlock "$CORPUS/tree"
+bt "grep -r -c --include" my -- "$BIN/my_grep" -r -c --include='file1*' abc "$CORPUS/tree"
+bt "grep -r -c --include" coreutils -- grep -r -F -c --include='file1*' abc "$CORPUS/tree"
+
+# --- grep --index: 넓은 트리의 트라이그램 색인 만들기 (처음, 바뀐 것 없음)와 색인 검색 ---
+# (색인 파일은 트리 안에 생기므로 cp -r/ls 측정 전에 지움)
+IDX="$CORPUS/tree/.my_grep.idx"
+bt "grep --build-index" my -p "rm -f '$IDX'" -- "$BIN/my_grep" --build-index "$CORPUS/tree"
+bt "grep --build-index (no-op)" my -- "$BIN/my_grep" --build-index "$CORPUS/tree"
+bt "grep --index -l (rare)" my -- "$BIN/my_grep" --index -l deadlock "$CORPUS/tree"
+bt "grep --index -l (rare)" coreutils -- grep -r -F -l deadlock "$CORPUS/tree"
+rm -f "$IDX"
+
+# --- cat: 변환 없음과 각 플래그 ---
+echo "cat" >&2
+for flag in "" -n -b -v -E -vE -nvE; do
+    bt "cat${flag:+ $flag}" my -- "$BIN/my_cat" $flag "$LOG"
+    bt "cat${flag:+ $flag}" coreutils -- cat $flag "$LOG"
+done
+bt "cat (stdin)" my -i "$LOG" -- "$BIN/my_cat"
+bt "cat (stdin)" coreutils -i "$LOG" -- cat
+
+# --- cp: 큰 파일 하나, 넓은 트리 ---
+echo "cp" >&2
+bt "cp file" my -p "rm -f '$WORK/copy'" -- "$BIN/my_cp" "$LOG" "$WORK/copy"
+bt "cp file" coreutils -p "rm -f '$WORK/copy'" -- cp "$LOG" "$WORK/copy"
+bt "cp -r tree" my -p "rm -rf '$WORK/tree'" -- "$BIN/my_cp" -r "$CORPUS/tree" "$WORK/tree"
+bt "cp -r tree" coreutils -p "rm -rf '$WORK/tree'" -- cp -r "$CORPUS/tree" "$WORK/tree"
+rm -rf "$WORK/copy" "$WORK/tree"
+
+# --- ls: 항목이 많은 디렉토리, 트리 전체 ---
+echo "ls" >&2
+bt "ls flat" my -- "$BIN/my_ls" "$CORPUS/flat"
+bt "ls flat" coreutils -- ls "$CORPUS/flat"
+bt "ls -l flat" my -- "$BIN/my_ls" -l "$CORPUS/flat"
+bt "ls -l flat" coreutils -- ls -l "$CORPUS/flat"
+bt "ls -laR tree" my -- "$BIN/my_ls" -laR "$CORPUS/tree"
+bt "ls -laR tree" coreutils -- ls -laR "$CORPUS/tree"
+bt "ls -R deep" my -- "$BIN/my_ls" -R "$CORPUS/deep"
+bt "ls -R deep" coreutils -- ls -R "$CORPUS/deep"
+
+# --- rm -r: 매번 coreutils cp로 다시 만든 복사본을 삭제 (복사는 시간에 넣지 않음) ---
+echo "rm" >&2
+for d in tree deep flat; do
+    bt "rm -r $d" my -p "rm -rf '$WORK/$d' && cp -r '$CORPUS/$d' '$WORK/$d'" -- "$BIN/my_rm" -r "$WORK/$d"
+    bt "rm -r $d" coreutils -p "rm -rf '$WORK/$d' && cp -r '$CORPUS/$d' '$WORK/$d'" -- rm -r "$WORK/$d"
+done
+
+# --- 쉘: 명령어/파이프라인 실행 속도 (스크립트 한 줄 = 작업 하나) ---
+echo "shell" >&2
+n=0
+: > "$WORK/ext.sh"; : > "$WORK/pipe.sh"; : > "$WORK/builtin.sh"
+while [ $n -lt "$SHELL_N" ]; do
+    echo "/bin/true" >> "$WORK/ext.sh"
+    echo "/bin/true | /bin/true | /bin/true" >> "$WORK/pipe.sh"
+    echo "cd ." >> "$WORK/builtin.sh"
+    n=$((n + 1))
+done
+for s in ext pipe builtin; do
+    bt "shell $s" my -k "$SHELL_N" -- "$BIN/my_shell" "$WORK/$s.sh"
+    bt "shell $s" my-fork -k "$SHELL_N" -- env MYSHELL_LAUNCHER=fork "$BIN/my_shell" "$WORK/$s.sh"
+    bt "shell $s" dash -k "$SHELL_N" -- dash "$WORK/$s.sh"
+    bt "shell $s" bash -k "$SHELL_N" -- bash "$WORK/$s.sh"
+done
+
+# --- JSON 문서로 묶기 ---
+{
+    printf '{\n  "suite": "Shell_Programming",\n'
+    printf '  "commit": "%s",\n' "$(git -C "$HERE" rev-parse --short HEAD 2>/dev/null || echo unknown)"
+    printf '  "date": "%s",\n' "$(date -u +%Y-%m-%dT%H:%M:%SZ)"
+    printf '  "host": {"kernel": "%s", "nproc": %s, "cc": "%s"},\n' \
+        "$(uname -r)" "$(nproc)" "$(${CC:-gcc} --version 2>/dev/null | head -n 1 | tr -d '"')"
+    printf '  "scale": "%s", "runs": %s,\n' "$SCALE" "$RUNS"
+    printf '  "corpus": {"log_mb": %s, "flat_entries": %s, "tree": "%s", "deep": "%s", "shell_lines": %s},\n' \
+        "$LOG_MB" "$FLAT" "$TREE" "$DEEP" "$SHELL_N"
+    printf '  "results": [\n'
+    sed 's/^/    /; $!s/$/,/' "$RESULTS"
+    printf '  ]\n}\n'
+} > "${OUT:-/dev/stdout}"
+
+# my / coreutils 중앙값 비율 요약 (1보다 작으면 my_*가 빠름)
+echo "summary (median my / coreutils):" >&2
+awk '{
+    name = $0; sub(/^\{"name": "/, "", name); sub(/".*/, "", name);
+    impl = $0; sub(/.*"impl": "/, "", impl); sub(/".*/, "", impl);
+    t = $0; sub(/.*"median_s": /, "", t); sub(/,.*/, "", t);
+    if (impl == "my") my[name] = t; else if (impl == "coreutils") core[name] = t;
+    if (!(name in seen)) { seen[name] = 1; order[n++] = name }
+} END {
+    for (k = 0; k < n; k++)
+        if ((order[k] in my) && (order[k] in core) && core[order[k]] > 0)
+            printf "  %-24s %6.2fx\n", order[k], my[order[k]] / core[order[k]];
+}' "$RESULTS" >&2
@@ -0,0 +1,265 @@
+/* cat_core.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "cat_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define CAT_IN_SIZE    (128 * 1024)   // 입력 블록 크기
+#define CAT_OUT_SIZE   (256 * 1024)   // 출력 버퍼 크기 (가득 차면 한 번에 write)
+#define CAT_KERNEL_MAX (1 << 30)      // splice/sendfile 한 번에 요청할 크기
+
+/* 출력 버퍼 */
+struct cat_out {
+    int fd;
+    size_t len;
+    char buf[CAT_OUT_SIZE + 64];  // 줄 번호/^X 출력을 위한 여유 공간
+};
+
+int cat_has_transform(const struct cat_opts *opts) {
+    return opts->show_line_numbers || opts->number_nonblank ||
+           opts->show_nonprintable || opts->show_ends;
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int out_flush(struct cat_out *out) {
+    int ret = write_all(out->fd, out->buf, out->len);
+    out->len = 0;
+    return ret;
+}
+
+/* 바이트열 추가 (버퍼보다 크면 바로 write) */
+static int out_put(struct cat_out *out, const char *s, size_t len) {
+    if (out->len + len > CAT_OUT_SIZE) {
+        if (out_flush(out) < 0) return -1;
+        if (len > CAT_OUT_SIZE) return write_all(out->fd, s, len);
+    }
+    memcpy(out->buf + out->len, s, len);
+    out->len += len;
+    return 0;
+}
+
+/* "%6ld  " 형식의 줄 번호 추가 (printf 호출 없이 직접 변환) */
+static int out_number(struct cat_out *out, long n) {
+    char tmp[24];
+    int k = sizeof(tmp);
+
+    tmp[--k] = ' ';
+    tmp[--k] = ' ';
+    do {
+        tmp[--k] = '0' + (n % 10);
+        n /= 10;
+    } while (n > 0);
+    while (sizeof(tmp) - k < 8) tmp[--k] = ' ';
+    return out_put(out, tmp + k, sizeof(tmp) - k);
+}
+
+/*
+ * 다음 특수 바이트 찾기
+ * 설명: 개행은 항상, -v 이면 탭을 제외한 제어 문자(0~31)도 특수 바이트입니다.
+ *       SIMD로 16바이트씩 비교합니다.
+ */
+static const char *find_special(const char *p, const char *end, int ctrl) {
+    if (!ctrl) {
+        const char *nl = memchr(p, '\n', end - p);
+        return nl != NULL ? nl : end;
+    }
+
+#if defined(__SSE2__)
+    const __m128i limit = _mm_set1_epi8(31);
+    const __m128i tab = _mm_set1_epi8('\t');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        // v <= 31 (부호 없는 비교) 이면서 탭이 아닌 바이트
+        __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, limit), v);
+        __m128i hit = _mm_andnot_si128(_mm_cmpeq_epi8(v, tab), low);
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+        if (mask != 0) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    for (; p < end; p++) {
+        unsigned char c = *p;
+        if (c < 32 && c != '\t') return p;
+    }
+    return end;
+}
+
+/*
+ * 변환 출력 함수 (-n -b -v -E)
+ * 설명: 큰 블록 단위로 읽고, 특수 바이트 사이의 일반 구간은 통째로 복사합니다.
+ *       줄 번호와 줄 시작 여부는 블록 경계를 넘어 유지됩니다.
+ * 반환값: 0(성공), -1(읽기/쓰기 오류, errno 설정)
+ */
+int cat_transform(int in_fd, int out_fd, const struct cat_opts *opts) {
+    struct cat_out *out = malloc(sizeof(*out));
+    char *in = malloc(CAT_IN_SIZE);
+    long line = 1;
+    int at_line_start = 1;
+    int ret = 0;
+
+    if (out == NULL || in == NULL) {
+        free(out);
+        free(in);
+        errno = ENOMEM;
+        return -1;
+    }
+    out->fd = out_fd;
+    out->len = 0;
+
+    for (;;) {
+        ssize_t n = read(in_fd, in, CAT_IN_SIZE);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ret = -1;
+            break;
+        }
+        if (n == 0) break;
+
+        const char *p = in, *end = in + n;
+        while (p < end) {
+            if (at_line_start) {
+                at_line_start = 0;
+                if (opts->number_nonblank) {
+                    if (*p != '\n' && out_number(out, line++) < 0) { ret = -1; goto done; }
+                } else if (opts->show_line_numbers) {
+                    if (out_number(out, line++) < 0) { ret = -1; goto done; }
+                }
+            }
+
+            const char *s = find_special(p, end, opts->show_nonprintable);
+            if (s > p && out_put(out, p, s - p) < 0) { ret = -1; goto done; }
+            if (s == end) break;
+
+            char esc[3];
+            size_t elen = 0;
+            if (*s == '\n') {
+                if (opts->show_ends) esc[elen++] = '$';
+                esc[elen++] = '\n';
+                at_line_start = 1;
+            } else {
+                esc[elen++] = '^';
+                esc[elen++] = *s + 64;
+            }
+            if (out_put(out, esc, elen) < 0) { ret = -1; goto done; }
+            p = s + 1;
+        }
+    }
+
+done:
+    if (out_flush(out) < 0) ret = -1;
+    free(out);
+    free(in);
+    return ret;
+}
+
+/*
+ * 단순 출력 함수 (옵션 없음)
+ * 설명: 입력이나 출력이 파이프면 splice, 입력이 일반 파일이고 출력이 파일/파이프면
+ *       sendfile로 커널 안에서 바로 전달하고, 그 외에는 큰 버퍼로 read/write 합니다.
+ * 반환값: 0(성공), -1(실패, errno 설정)
+ */
+int cat_plain(int in_fd, int out_fd) {
+    struct stat in_st, out_st;
+    int kernel_ok = fstat(in_fd, &in_st) == 0 && fstat(out_fd, &out_st) == 0;
+    int out_direct = kernel_ok && (S_ISREG(out_st.st_mode) || S_ISFIFO(out_st.st_mode) ||
+                                   S_ISSOCK(out_st.st_mode));
+
+    // 1. splice: 입력 또는 출력이 파이프일 때
+    if (out_direct && (S_ISFIFO(in_st.st_mode) || S_ISFIFO(out_st.st_mode))) {
+        int first = 1;
+        for (;;) {
+            ssize_t n = splice(in_fd, NULL, out_fd, NULL, CAT_KERNEL_MAX, SPLICE_F_MORE);
+            if (n < 0 && errno == EINTR) continue;
+            if (n == 0) return 0;
+            if (n < 0) {
+                if (first && (errno == EINVAL || errno == ENOSYS)) break;
+                return -1;
+            }
+            first = 0;
+        }
+    }
+
+    // 2. sendfile: 입력이 일반 파일일 때
+    if (out_direct && S_ISREG(in_st.st_mode)) {
+        int first = 1;
+        for (;;) {
+            ssize_t n = sendfile(out_fd, in_fd, NULL, CAT_KERNEL_MAX);
+            if (n < 0 && errno == EINTR) continue;
+            if (n == 0) return 0;
+            if (n < 0) {
+                if (first && (errno == EINVAL || errno == ENOSYS)) break;
+                return -1;
+            }
+            first = 0;
+        }
+    }
+
+    // 3. 큰 버퍼 read/write (터미널 등)
+    char *buf = malloc(CAT_IN_SIZE);
+    if (buf == NULL) return -1;
+    for (;;) {
+        ssize_t n = read(in_fd, buf, CAT_IN_SIZE);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            free(buf);
+            return -1;
+        }
+        if (n == 0) break;
+        if (write_all(out_fd, buf, n) < 0) {
+            free(buf);
+            return -1;
+        }
+    }
+    free(buf);
+    return 0;
+}
+
+/* 옵션에 따라 단순 출력 또는 변환 출력 선택 */
+int cat_fd(int in_fd, int out_fd, const struct cat_opts *opts) {
+    if (cat_has_transform(opts)) return cat_transform(in_fd, out_fd, opts);
+    return cat_plain(in_fd, out_fd);
+}
+
+/*
+ * 경로 하나를 출력하는 함수 (줄 번호는 파일마다 1부터 시작)
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int cat_path(const char *path, int out_fd, const struct cat_opts *opts) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "%scat: %s: %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    int ret = cat_fd(fd, out_fd, opts);
+    if (ret < 0)
+        fprintf(stderr, "%scat: %s: %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+    close(fd);
+    return ret;
+}
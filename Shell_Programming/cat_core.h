@@ -0,0 +1,21 @@
+/* cat_core.h */
+#ifndef CAT_CORE_H
+#define CAT_CORE_H
+
+/*
+ * cat 옵션 (-n -b -v -E)
+ */
+struct cat_opts {
+    int show_line_numbers;  // -n: 모든 줄에 번호
+    int number_nonblank;    // -b: 빈 줄이 아닌 줄에만 번호 (-n보다 우선)
+    int show_nonprintable;  // -v: 제어 문자를 ^X 형태로 출력
+    int show_ends;          // -E: 줄 끝에 '$' 출력
+};
+
+int cat_has_transform(const struct cat_opts *opts);
+int cat_plain(int in_fd, int out_fd);
+int cat_transform(int in_fd, int out_fd, const struct cat_opts *opts);
+int cat_fd(int in_fd, int out_fd, const struct cat_opts *opts);
+int cat_path(const char *path, int out_fd, const struct cat_opts *opts);
+
+#endif
@@ -0,0 +1,175 @@
+/* copy_core.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+
+#include "copy_core.h"
+
+#define COPY_BUF_SIZE  (1 << 20)   // read/write 경로의 버퍼 크기 (1MB)
+#define COPY_STEP      (1 << 30)   // 커널 복사 호출 한 번에 요청할 최대 크기
+
+const char *copy_method_name(int method) {
+    switch (method) {
+        case COPY_REFLINK:    return "reflink";
+        case COPY_FILE_RANGE: return "copy_file_range";
+        case COPY_SENDFILE:   return "sendfile";
+        case COPY_READ_WRITE: return "read/write";
+        default:              return "none";
+    }
+}
+
+/* 해당 오류가 "이 방법을 지원하지 않음"을 뜻하는지 확인 */
+static int unsupported(int err) {
+    return err == ENOSYS || err == EXDEV || err == EINVAL ||
+           err == EOPNOTSUPP || err == ENOTSUP || err == EBADF;
+}
+
+/* 큰 버퍼로 [off, off+len) 구간 복사 (len < 0 이면 EOF까지, 파일 위치 사용) */
+static int copy_read_write(int src_fd, int dst_fd, off_t off, off_t len) {
+    char *buf = malloc(COPY_BUF_SIZE);
+    if (buf == NULL) return -1;
+
+    while (len != 0) {
+        size_t want = COPY_BUF_SIZE;
+        if (len > 0 && (off_t)want > len) want = (size_t)len;
+
+        ssize_t n = (len < 0) ? read(src_fd, buf, want) : pread(src_fd, buf, want, off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            free(buf);
+            return -1;
+        }
+        if (n == 0) break;
+
+        for (ssize_t done = 0; done < n; ) {
+            ssize_t w = (len < 0) ? write(dst_fd, buf + done, n - done)
+                                  : pwrite(dst_fd, buf + done, n - done, off + done);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                free(buf);
+                return -1;
+            }
+            done += w;
+        }
+        off += n;
+        if (len > 0) len -= n;
+    }
+    free(buf);
+    return 0;
+}
+
+/*
+ * 데이터 구간 [off, off+len) 복사
+ * 설명: copy_file_range -> sendfile -> read/write 순서로 시도하며,
+ *       한 번 실패한 방법은 *method를 낮춰 다음 구간부터 건너뜁니다.
+ */
+static int copy_segment(int src_fd, int dst_fd, off_t off, off_t len, int *method) {
+    if (*method <= COPY_FILE_RANGE) {
+        loff_t in = off, out = off;
+        off_t left = len;
+
+        errno = 0;
+        while (left > 0) {
+            size_t step = left > COPY_STEP ? COPY_STEP : (size_t)left;
+            ssize_t n = copy_file_range(src_fd, &in, dst_fd, &out, step, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            left -= n;
+        }
+        if (left == 0) {
+            *method = COPY_FILE_RANGE;
+            return 0;
+        }
+        if (!unsupported(errno) && errno != 0) return -1;
+        // 지원하지 않음: 남은 부분은 다음 방법으로
+        off = in;
+        len = left;
+        *method = COPY_SENDFILE;
+    }
+
+    if (*method <= COPY_SENDFILE) {
+        off_t in = off;
+        off_t left = len;
+
+        errno = 0;
+        if (lseek(dst_fd, off, SEEK_SET) == (off_t)-1) return -1;
+        while (left > 0) {
+            size_t step = left > COPY_STEP ? COPY_STEP : (size_t)left;
+            ssize_t n = sendfile(dst_fd, src_fd, &in, step);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            left -= n;
+        }
+        if (left == 0) {
+            *method = COPY_SENDFILE;
+            return 0;
+        }
+        if (!unsupported(errno) && errno != 0) return -1;
+        off = in;
+        len = left;
+        *method = COPY_READ_WRITE;
+    }
+
+    return copy_read_write(src_fd, dst_fd, off, len);
+}
+
+/*
+ * 파일 복사 엔진
+ * 설명: FICLONE(reflink) -> copy_file_range -> sendfile -> read/write 순서로 시도합니다.
+ *       일반 파일은 SEEK_DATA/SEEK_HOLE로 데이터 구간만 복사하여 hole을 보존하고,
+ *       마지막에 ftruncate로 크기를 맞춥니다. dst_fd는 비어 있어야 합니다.
+ *       *method에는 실제로 사용된 가장 느린 방법이 저장됩니다.
+ * 반환값: 0(성공), -1(실패, errno 설정)
+ */
+int copy_fd(int src_fd, int dst_fd, const struct stat *src_st, int *method) {
+    off_t size = src_st->st_size;
+    off_t pos = 0;
+
+    *method = COPY_NONE;
+
+    // 파이프, 장치 등: 크기를 알 수 없으므로 EOF까지 스트림 복사
+    if (!S_ISREG(src_st->st_mode)) {
+        *method = COPY_READ_WRITE;
+        return copy_read_write(src_fd, dst_fd, 0, -1);
+    }
+
+    if (size == 0) return 0;
+
+    // 1. reflink: 같은 파일 시스템(btrfs, xfs 등)이면 데이터 블록을 공유
+    if (ioctl(dst_fd, FICLONE, src_fd) == 0) {
+        *method = COPY_REFLINK;
+        return 0;
+    }
+
+    // 2. 데이터 구간만 순회하며 복사 (hole은 건너뜀)
+    int step_method = COPY_FILE_RANGE;
+    while (pos < size) {
+        off_t data = lseek(src_fd, pos, SEEK_DATA);
+        off_t hole;
+
+        if (data == (off_t)-1) {
+            if (errno == ENXIO) break;         // 나머지는 모두 hole
+            data = pos;                        // SEEK_DATA 미지원: 전체를 데이터로 취급
+            hole = size;
+        } else {
+            hole = lseek(src_fd, data, SEEK_HOLE);
+            if (hole == (off_t)-1 || hole > size) hole = size;
+        }
+        if (data >= size) break;
+
+        if (copy_segment(src_fd, dst_fd, data, hole - data, &step_method) < 0) return -1;
+        if (step_method > *method) *method = step_method;
+        pos = hole;
+    }
+
+    // 끝부분의 hole까지 포함하여 원본 크기로 맞춤
+    if (ftruncate(dst_fd, size) < 0) return -1;
+    return 0;
+}
@@ -0,0 +1,31 @@
+/* copy_core.h */
+#ifndef COPY_CORE_H
+#define COPY_CORE_H
+
+#include <sys/stat.h>
+
+/*
+ * 복사에 사용된 방법 (빠른 순서)
+ */
+enum copy_method {
+    COPY_NONE = 0,       // 복사할 데이터 없음 (빈 파일, 전부 hole)
+    COPY_REFLINK,        // ioctl(FICLONE): 데이터 블록 공유
+    COPY_FILE_RANGE,     // copy_file_range: 커널 내부 복사
+    COPY_SENDFILE,       // sendfile: 커널 내부 복사
+    COPY_READ_WRITE      // 큰 버퍼 read/write
+};
+
+const char *copy_method_name(int method);
+int copy_fd(int src_fd, int dst_fd, const struct stat *src_st, int *method);
+
+/*
+ * copy_tree.c: 디렉토리 트리 병렬 복사 (cp -r)
+ */
+struct copy_tree_opts {
+    int jobs;      // 파일 복사 스레드 수
+    int verbose;   // 복사한 파일과 방법 출력
+};
+
+int copy_tree(const char *src, const char *dst, const struct copy_tree_opts *opts);
+
+#endif
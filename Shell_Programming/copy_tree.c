@@ -0,0 +1,458 @@
+/* copy_tree.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#include "copy_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define FILE_QUEUE_SIZE  1024   // 파일 복사 큐의 최대 길이 (가득 차면 탐색 스레드가 대기)
+#define LINK_TABLE_SIZE  4096   // 하드 링크 표의 초기 크기 (2의 거듭제곱)
+
+/* 복사할 파일 하나 */
+struct file_task {
+    char *src;
+    char *dst;
+    struct stat st;
+};
+
+/* 탐색할 디렉토리 하나 */
+struct dir_task {
+    char *src;
+    char *dst;
+    struct dir_task *next;
+};
+
+/* 모든 복사가 끝난 뒤 처리할 항목 (디렉토리 속성, 하드 링크) */
+struct deferred {
+    char *path;            // 디렉토리: 대상 경로 / 하드 링크: 새로 만들 경로
+    char *target;          // 하드 링크: 먼저 복사된 파일 경로 (디렉토리는 NULL)
+    struct stat st;
+};
+
+/* 하드 링크 표 항목: (st_dev, st_ino) -> 처음 복사된 대상 경로 */
+struct link_entry {
+    dev_t dev;
+    ino_t ino;
+    char *dst;
+};
+
+struct copy_tree_ctx {
+    const struct copy_tree_opts *opts;
+    pthread_mutex_t lock;
+    pthread_cond_t dir_cv;        // 탐색 스레드: 새 디렉토리 / 종료
+    pthread_cond_t not_empty;     // 복사 스레드: 새 파일
+    pthread_cond_t not_full;      // 탐색 스레드: 큐에 자리 남
+    struct dir_task *dirs;        // 탐색 대기 중인 디렉토리 (스택)
+    int dirs_pending;             // 대기 + 탐색 중인 디렉토리 수
+    struct file_task queue[FILE_QUEUE_SIZE];
+    int qhead, qlen;
+    int walk_done;                // 탐색이 모두 끝남
+    int inline_copy;              // 복사 스레드 없이 탐색 스레드가 직접 복사
+    struct deferred *late;        // 디렉토리 속성, 하드 링크 목록
+    size_t nlate, late_cap;
+    struct link_entry *links;
+    size_t nlinks, links_cap;
+    int errors;
+};
+
+static char *join_path(const char *dir, const char *name) {
+    size_t a = strlen(dir), b = strlen(name);
+    char *p = malloc(a + b + 2);
+
+    if (p == NULL) return NULL;
+    memcpy(p, dir, a);
+    p[a] = '/';
+    memcpy(p + a + 1, name, b + 1);
+    return p;
+}
+
+/* 오류 출력 및 개수 증가 */
+static void report(struct copy_tree_ctx *ctx, const char *what, const char *path) {
+    fprintf(stderr, "%scp: %s '%s': %s%s\n", COLOR_RED, what, path, strerror(errno), COLOR_RESET);
+    pthread_mutex_lock(&ctx->lock);
+    ctx->errors++;
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+/* 모든 복사 후 처리할 항목 추가 (lock을 잡은 상태에서 호출) */
+static int add_deferred(struct copy_tree_ctx *ctx, char *path, char *target, const struct stat *st) {
+    if (ctx->nlate == ctx->late_cap) {
+        size_t cap = ctx->late_cap ? ctx->late_cap * 2 : 256;
+        struct deferred *d = realloc(ctx->late, cap * sizeof(*d));
+        if (d == NULL) return -1;
+        ctx->late = d;
+        ctx->late_cap = cap;
+    }
+    ctx->late[ctx->nlate].path = path;
+    ctx->late[ctx->nlate].target = target;
+    ctx->late[ctx->nlate].st = *st;
+    ctx->nlate++;
+    return 0;
+}
+
+/*
+ * 하드 링크 표 조회/등록 (lock을 잡은 상태에서 호출)
+ * 반환값: 이미 복사된 같은 inode의 대상 경로, 처음 보는 inode면 NULL (등록됨)
+ */
+static const char *link_lookup(struct copy_tree_ctx *ctx, const struct stat *st, const char *dst) {
+    if (ctx->nlinks * 2 >= ctx->links_cap) {
+        size_t cap = ctx->links_cap ? ctx->links_cap * 2 : LINK_TABLE_SIZE;
+        struct link_entry *t = calloc(cap, sizeof(*t));
+        if (t == NULL) return NULL;
+        for (size_t k = 0; k < ctx->links_cap; k++) {
+            if (ctx->links[k].dst == NULL) continue;
+            size_t h = (ctx->links[k].ino * 0x9E3779B97F4A7C15ULL ^ ctx->links[k].dev) & (cap - 1);
+            while (t[h].dst != NULL) h = (h + 1) & (cap - 1);
+            t[h] = ctx->links[k];
+        }
+        free(ctx->links);
+        ctx->links = t;
+        ctx->links_cap = cap;
+    }
+
+    size_t h = (st->st_ino * 0x9E3779B97F4A7C15ULL ^ st->st_dev) & (ctx->links_cap - 1);
+    while (ctx->links[h].dst != NULL) {
+        if (ctx->links[h].dev == st->st_dev && ctx->links[h].ino == st->st_ino)
+            return ctx->links[h].dst;
+        h = (h + 1) & (ctx->links_cap - 1);
+    }
+    ctx->links[h].dev = st->st_dev;
+    ctx->links[h].ino = st->st_ino;
+    ctx->links[h].dst = strdup(dst);
+    ctx->nlinks++;
+    return NULL;
+}
+
+/* 파일 하나 복사 후 권한과 시간 복원 */
+static void copy_one(struct copy_tree_ctx *ctx, struct file_task *t) {
+    int method;
+    int src_fd = open(t->src, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (src_fd < 0) {
+        report(ctx, "cannot open", t->src);
+        return;
+    }
+
+    int dst_fd = open(t->dst, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (dst_fd < 0) {
+        report(ctx, "cannot create", t->dst);
+        close(src_fd);
+        return;
+    }
+
+    if (copy_fd(src_fd, dst_fd, &t->st, &method) < 0) {
+        report(ctx, "error copying", t->src);
+    } else {
+        struct timespec times[2] = { t->st.st_atim, t->st.st_mtim };
+
+        if (fchmod(dst_fd, t->st.st_mode & 07777) < 0) report(ctx, "cannot set mode of", t->dst);
+        if (futimens(dst_fd, times) < 0) report(ctx, "cannot set times of", t->dst);
+        if (ctx->opts->verbose)
+            printf("'%s' -> '%s' (%s)\n", t->src, t->dst, copy_method_name(method));
+    }
+
+    close(src_fd);
+    if (close(dst_fd) < 0) report(ctx, "error closing", t->dst);
+}
+
+/* 복사 스레드: 큐가 닫힐 때까지 파일을 꺼내 복사 */
+static void *copy_worker(void *arg) {
+    struct copy_tree_ctx *ctx = arg;
+
+    for (;;) {
+        struct file_task t;
+
+        pthread_mutex_lock(&ctx->lock);
+        while (ctx->qlen == 0 && !ctx->walk_done)
+            pthread_cond_wait(&ctx->not_empty, &ctx->lock);
+        if (ctx->qlen == 0) {
+            pthread_mutex_unlock(&ctx->lock);
+            return NULL;
+        }
+        t = ctx->queue[ctx->qhead];
+        ctx->qhead = (ctx->qhead + 1) % FILE_QUEUE_SIZE;
+        ctx->qlen--;
+        pthread_cond_signal(&ctx->not_full);
+        pthread_mutex_unlock(&ctx->lock);
+
+        copy_one(ctx, &t);
+        free(t.src);
+        free(t.dst);
+    }
+}
+
+/* 디렉토리 탐색 큐에 추가 (lock을 잡은 상태에서 호출) */
+static void push_dir(struct copy_tree_ctx *ctx, char *src, char *dst) {
+    struct dir_task *d = malloc(sizeof(*d));
+
+    if (d == NULL) {
+        free(src);
+        free(dst);
+        ctx->errors++;
+        return;
+    }
+    d->src = src;
+    d->dst = dst;
+    d->next = ctx->dirs;
+    ctx->dirs = d;
+    ctx->dirs_pending++;
+    pthread_cond_signal(&ctx->dir_cv);
+}
+
+/* 디렉토리 항목 하나 처리 */
+static void walk_entry(struct copy_tree_ctx *ctx, int dfd, const char *name,
+                       const char *src_dir, const char *dst_dir) {
+    struct stat st;
+    char *src = join_path(src_dir, name);
+    char *dst = join_path(dst_dir, name);
+
+    if (src == NULL || dst == NULL) goto out;
+
+    if (fstatat(dfd, name, &st, AT_SYMLINK_NOFOLLOW) < 0) {
+        report(ctx, "cannot stat", src);
+        goto out;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        // 내용을 쓸 수 있도록 일단 0700으로 만들고, 원래 권한은 마지막에 복원
+        if (mkdir(dst, 0700) < 0 && errno != EEXIST) {
+            report(ctx, "cannot create directory", dst);
+            goto out;
+        }
+        pthread_mutex_lock(&ctx->lock);
+        if (add_deferred(ctx, strdup(dst), NULL, &st) < 0) ctx->errors++;
+        push_dir(ctx, src, dst);
+        pthread_mutex_unlock(&ctx->lock);
+        return;
+    }
+
+    if (S_ISLNK(st.st_mode)) {
+        char target[4096];
+        ssize_t n = readlinkat(dfd, name, target, sizeof(target) - 1);
+        if (n < 0) {
+            report(ctx, "cannot read link", src);
+            goto out;
+        }
+        target[n] = '\0';
+        if (symlink(target, dst) < 0) {
+            report(ctx, "cannot create symlink", dst);
+            goto out;
+        }
+        struct timespec times[2] = { st.st_atim, st.st_mtim };
+        utimensat(AT_FDCWD, dst, times, AT_SYMLINK_NOFOLLOW);
+        goto out;
+    }
+
+    if (S_ISFIFO(st.st_mode)) {
+        if (mkfifo(dst, st.st_mode & 07777) < 0) report(ctx, "cannot create fifo", dst);
+        goto out;
+    }
+
+    if (!S_ISREG(st.st_mode)) {
+        fprintf(stderr, "%scp: skipping special file '%s'%s\n", COLOR_RED, src, COLOR_RESET);
+        goto out;
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    // 하드 링크: 같은 inode가 이미 복사되었으면 모든 복사 후 링크로 생성
+    if (st.st_nlink > 1) {
+        const char *first = link_lookup(ctx, &st, dst);
+        if (first != NULL) {
+            if (add_deferred(ctx, dst, strdup(first), &st) < 0) {
+                ctx->errors++;
+                free(dst);
+            }
+            pthread_mutex_unlock(&ctx->lock);
+            free(src);
+            return;
+        }
+    }
+
+    if (ctx->inline_copy) {
+        struct file_task t = { src, dst, st };
+        pthread_mutex_unlock(&ctx->lock);
+        copy_one(ctx, &t);
+        goto out;
+    }
+
+    // 큐가 가득 차면 대기 (열린 fd 수와 메모리 사용량 제한)
+    while (ctx->qlen == FILE_QUEUE_SIZE)
+        pthread_cond_wait(&ctx->not_full, &ctx->lock);
+    int tail = (ctx->qhead + ctx->qlen) % FILE_QUEUE_SIZE;
+    ctx->queue[tail].src = src;
+    ctx->queue[tail].dst = dst;
+    ctx->queue[tail].st = st;
+    ctx->qlen++;
+    pthread_cond_signal(&ctx->not_empty);
+    pthread_mutex_unlock(&ctx->lock);
+    return;
+
+out:
+    free(src);
+    free(dst);
+}
+
+/* 탐색 스레드: 디렉토리를 꺼내 항목들을 파일 큐/디렉토리 큐로 분배 */
+static void *walk_worker(void *arg) {
+    struct copy_tree_ctx *ctx = arg;
+
+    for (;;) {
+        struct dir_task *d;
+
+        pthread_mutex_lock(&ctx->lock);
+        while (ctx->dirs == NULL && ctx->dirs_pending > 0)
+            pthread_cond_wait(&ctx->dir_cv, &ctx->lock);
+        if (ctx->dirs == NULL) {
+            pthread_mutex_unlock(&ctx->lock);
+            return NULL;
+        }
+        d = ctx->dirs;
+        ctx->dirs = d->next;
+        pthread_mutex_unlock(&ctx->lock);
+
+        DIR *dir = opendir(d->src);
+        if (dir == NULL) {
+            report(ctx, "cannot open directory", d->src);
+        } else {
+            struct dirent *ent;
+            while ((ent = readdir(dir)) != NULL) {
+                if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+                walk_entry(ctx, dirfd(dir), ent->d_name, d->src, d->dst);
+            }
+            closedir(dir);
+        }
+
+        pthread_mutex_lock(&ctx->lock);
+        ctx->dirs_pending--;
+        if (ctx->dirs_pending == 0) {
+            // 모든 탐색 완료: 다른 탐색 스레드와 복사 스레드에 알림
+            ctx->walk_done = 1;
+            pthread_cond_broadcast(&ctx->dir_cv);
+            pthread_cond_broadcast(&ctx->not_empty);
+        }
+        pthread_mutex_unlock(&ctx->lock);
+
+        free(d->src);
+        free(d->dst);
+        free(d);
+    }
+}
+
+/*
+ * 디렉토리 트리 복사 함수 (cp -r)
+ * 설명: 탐색 스레드들이 디렉토리를 읽어 파일을 크기가 제한된 큐에 넣고,
+ *       복사 스레드 jobs개가 큐에서 꺼내 copy_fd로 복사합니다.
+ *       권한과 시간은 보존되며, 심볼릭 링크는 다시 만들고 하드 링크는 유지합니다.
+ *       디렉토리의 권한/시간과 하드 링크는 모든 파일 복사가 끝난 뒤 처리합니다.
+ *       동시에 열리는 fd는 복사 스레드당 2개, 탐색 스레드당 1개로 제한됩니다.
+ * 반환값: 발생한 오류 수 (0이면 성공)
+ */
+int copy_tree(const char *src, const char *dst, const struct copy_tree_opts *opts) {
+    struct copy_tree_ctx ctx;
+    struct stat st;
+    struct rlimit rl;
+    int jobs = opts->jobs > 0 ? opts->jobs : 1;
+    int walkers = jobs / 4 + 1;
+
+    // fd 한도를 넘지 않도록 스레드 수 제한
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY) {
+        long max_jobs = ((long)rl.rlim_cur - 16 - walkers) / 2;
+        if (max_jobs < 1) max_jobs = 1;
+        if (jobs > max_jobs) jobs = (int)max_jobs;
+    }
+
+    if (stat(src, &st) < 0) {
+        fprintf(stderr, "%scp: cannot stat '%s': %s%s\n", COLOR_RED, src, strerror(errno), COLOR_RESET);
+        return 1;
+    }
+    if (mkdir(dst, 0700) < 0 && errno != EEXIST) {
+        fprintf(stderr, "%scp: cannot create directory '%s': %s%s\n", COLOR_RED, dst, strerror(errno), COLOR_RESET);
+        return 1;
+    }
+
+    // 자기 자신의 하위 디렉토리로 복사하면 끝없이 반복되므로 거부
+    char *real_src = realpath(src, NULL);
+    char *real_dst = realpath(dst, NULL);
+    if (real_src != NULL && real_dst != NULL) {
+        size_t n = strlen(real_src);
+        if (strncmp(real_src, real_dst, n) == 0 && (real_dst[n] == '/' || real_dst[n] == '\0')) {
+            fprintf(stderr, "%scp: cannot copy a directory, '%s', into itself, '%s'%s\n",
+                    COLOR_RED, src, dst, COLOR_RESET);
+            rmdir(dst);
+            free(real_src);
+            free(real_dst);
+            return 1;
+        }
+    }
+    free(real_src);
+    free(real_dst);
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.opts = opts;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.dir_cv, NULL);
+    pthread_cond_init(&ctx.not_empty, NULL);
+    pthread_cond_init(&ctx.not_full, NULL);
+
+    add_deferred(&ctx, strdup(dst), NULL, &st);
+    push_dir(&ctx, strdup(src), strdup(dst));
+
+    pthread_t *threads = calloc(jobs + walkers, sizeof(pthread_t));
+    int started = 0;
+    if (threads == NULL) {
+        ctx.inline_copy = 1;
+    } else {
+        for (int k = 0; k < jobs; k++)
+            if (pthread_create(&threads[started], NULL, copy_worker, &ctx) == 0) started++;
+        // 복사 스레드를 만들 수 없으면 탐색 스레드가 직접 복사
+        if (started == 0) ctx.inline_copy = 1;
+        int ncopy = started;
+        for (int k = 0; k < walkers; k++)
+            if (pthread_create(&threads[started], NULL, walk_worker, &ctx) == 0) started++;
+        if (started == ncopy) walk_worker(&ctx);
+    }
+    if (threads == NULL) walk_worker(&ctx);
+    for (int k = 0; k < started; k++) pthread_join(threads[k], NULL);
+    free(threads);
+
+    // 하드 링크 생성 후, 디렉토리 권한/시간을 자식부터 부모 순서로 복원
+    for (size_t k = 0; k < ctx.nlate; k++) {
+        struct deferred *d = &ctx.late[k];
+        if (d->target != NULL && link(d->target, d->path) < 0) {
+            fprintf(stderr, "%scp: cannot create hard link '%s': %s%s\n", COLOR_RED, d->path, strerror(errno), COLOR_RESET);
+            ctx.errors++;
+        }
+    }
+    for (size_t k = ctx.nlate; k-- > 0; ) {
+        struct deferred *d = &ctx.late[k];
+        if (d->target == NULL) {
+            struct timespec times[2] = { d->st.st_atim, d->st.st_mtim };
+            if (chmod(d->path, d->st.st_mode & 07777) < 0 ||
+                utimensat(AT_FDCWD, d->path, times, 0) < 0) {
+                fprintf(stderr, "%scp: cannot set attributes of '%s': %s%s\n", COLOR_RED, d->path, strerror(errno), COLOR_RESET);
+                ctx.errors++;
+            }
+        }
+        free(d->path);
+        free(d->target);
+    }
+
+    for (size_t k = 0; k < ctx.links_cap; k++) free(ctx.links[k].dst);
+    free(ctx.links);
+    free(ctx.late);
+    pthread_mutex_destroy(&ctx.lock);
+    pthread_cond_destroy(&ctx.dir_cv);
+    pthread_cond_destroy(&ctx.not_empty);
+    pthread_cond_destroy(&ctx.not_full);
+    return ctx.errors;
+}
@@ -0,0 +1,469 @@
+/* grep_core.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "grep_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define GREP_READ_CHUNK  (1 << 20)   // 파이프 입력 시 한 번에 읽을 크기 (1MB)
+
+/* 대소문자 무시 비교용 변환 표 (ASCII 대문자 -> 소문자) */
+static unsigned char fold_table[256];
+
+static void init_fold_table(void) {
+    for (int c = 0; c < 256; c++)
+        fold_table[c] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static unsigned char to_upper(unsigned char c) {
+    return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+/*
+ * 패턴 컴파일 함수
+ * 설명: -i 옵션이면 패턴을 미리 소문자로 변환해 두어,
+ *       줄마다 패턴이나 줄을 복사/변환하지 않도록 합니다.
+ *       -G/-E 이면 정규식으로 컴파일하되, 패턴 전체가 리터럴이면 고정 문자열로 바꿉니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int grep_compile(struct grep_pattern *pat, const char *pattern, int ignore_case, int syntax) {
+    char *const list[] = { (char *)pattern };
+    return grep_compile_list(pat, list, 1, ignore_case, syntax);
+}
+
+/*
+ * 여러 패턴 컴파일 함수 (-e 여러 번, -f 패턴 파일)
+ * 설명: 어느 패턴이든 매칭되는 줄을 찾습니다. 고정 문자열이 여러 개면 grep_multi.c의
+ *       검색기로, 정규식은 선택(|)으로 묶어 하나의 오토마톤으로 컴파일합니다.
+ *       빈 패턴이 있으면 모든 줄이 매칭되고, 패턴이 없으면 (빈 -f 파일) 아무 줄도 매칭되지 않습니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int grep_compile_list(struct grep_pattern *pat, char *const patterns[], int n, int ignore_case, int syntax) {
+    size_t len;
+
+    init_fold_table();
+    pat->text = NULL;
+    pat->len = 0;
+    pat->ignore_case = ignore_case;
+    pat->multi = NULL;
+    pat->rx = NULL;
+
+    if (syntax != GREP_FIXED && n > 0) {
+        struct grep_regex *rx = grep_regex_compile(patterns, n, ignore_case, syntax == GREP_EXTENDED);
+        char *const *exact;
+        int nexact;
+
+        if (rx == NULL) return -1;
+        exact = grep_regex_exact(rx, &nexact);
+        if (exact == NULL) {
+            pat->rx = rx;
+            return 0;
+        }
+        int r = grep_compile_list(pat, exact, nexact, ignore_case, GREP_FIXED);
+        grep_regex_free(rx);
+        return r;
+    }
+
+    for (int k = 0; k < n; k++) {
+        if (patterns[k][0] == '\0') {
+            // 빈 패턴: 모든 줄이 매칭되므로 나머지는 볼 필요 없음
+            patterns = &patterns[k];
+            n = 1;
+            break;
+        }
+    }
+    if (n != 1) {
+        pat->multi = grep_multi_compile(patterns, n, ignore_case);
+        if (pat->multi == NULL) {
+            fprintf(stderr, "%sgrep: %s%s\n", COLOR_RED, strerror(ENOMEM), COLOR_RESET);
+            return -1;
+        }
+        return 0;
+    }
+
+    const char *pattern = patterns[0];
+    len = strlen(pattern);
+    pat->text = malloc(len + 1);
+    if (pat->text == NULL) {
+        fprintf(stderr, "%sgrep: %s%s\n", COLOR_RED, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+
+    for (size_t k = 0; k < len; k++) {
+        unsigned char c = pattern[k];
+        pat->text[k] = ignore_case ? fold_table[c] : c;
+    }
+    pat->text[len] = '\0';
+    pat->len = len;
+    pat->ignore_case = ignore_case;
+    return 0;
+}
+
+void grep_free(struct grep_pattern *pat) {
+    free(pat->text);
+    pat->text = NULL;
+    grep_multi_free(pat->multi);
+    pat->multi = NULL;
+    grep_regex_free(pat->rx);
+    pat->rx = NULL;
+}
+
+void grep_state_init(struct grep_state *st) {
+    st->lineno = 1;
+    st->count = 0;
+    st->done = 0;
+}
+
+/* 후보 위치에서 패턴 전체 비교 (-i 이면 변환 표로 비교, 복사 없음) */
+static int match_at(const struct grep_pattern *pat, const unsigned char *s) {
+    if (!pat->ignore_case)
+        return memcmp(s, pat->text, pat->len) == 0;
+
+    for (size_t k = 0; k < pat->len; k++) {
+        if (fold_table[s[k]] != pat->text[k]) return 0;
+    }
+    return 1;
+}
+
+/*
+ * 패턴 검색 함수
+ * 설명: 패턴의 첫 바이트와 마지막 바이트를 동시에 벡터 비교하여
+ *       두 위치가 모두 일치하는 후보만 전체 비교합니다.
+ *       (-i 이면 대문자/소문자 두 값과 각각 비교)
+ *       패턴이 여러 개면 grep_multi_find로 찾습니다.
+ * 반환값: 처음 일치한 위치 (여러 패턴이면 일치한 문자열 안의 한 위치), 없으면 NULL
+ */
+const char *grep_find(const struct grep_pattern *pat, const char *buf, size_t len) {
+    const unsigned char *s = (const unsigned char *)buf;
+    size_t k = pat->len;
+    size_t i = 0;
+
+    if (pat->multi != NULL) return grep_multi_find(pat->multi, buf, len);
+
+    if (k == 0) return buf;
+    if (len < k) return NULL;
+    if (k == 1 && !pat->ignore_case) return memchr(buf, pat->text[0], len);
+
+    size_t last = len - k; // 마지막으로 가능한 시작 위치
+    unsigned char f = pat->text[0], l = pat->text[k - 1];
+    unsigned char fu = pat->ignore_case ? to_upper(f) : f;
+    unsigned char lu = pat->ignore_case ? to_upper(l) : l;
+
+#if defined(__AVX2__)
+    {
+        __m256i vf = _mm256_set1_epi8((char)f), vfu = _mm256_set1_epi8((char)fu);
+        __m256i vl = _mm256_set1_epi8((char)l), vlu = _mm256_set1_epi8((char)lu);
+
+        for (; i + 32 <= last + 1; i += 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(s + i));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(s + i + k - 1));
+            __m256i eq = _mm256_and_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(a, vf), _mm256_cmpeq_epi8(a, vfu)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(b, vl), _mm256_cmpeq_epi8(b, vlu)));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(eq);
+
+            while (mask != 0) {
+                unsigned bit = __builtin_ctz(mask);
+                if (match_at(pat, s + i + bit)) return (const char *)(s + i + bit);
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    {
+        __m128i vf = _mm_set1_epi8((char)f), vfu = _mm_set1_epi8((char)fu);
+        __m128i vl = _mm_set1_epi8((char)l), vlu = _mm_set1_epi8((char)lu);
+
+        for (; i + 16 <= last + 1; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(s + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(s + i + k - 1));
+            __m128i eq = _mm_and_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(a, vf), _mm_cmpeq_epi8(a, vfu)),
+                _mm_or_si128(_mm_cmpeq_epi8(b, vl), _mm_cmpeq_epi8(b, vlu)));
+            unsigned mask = (unsigned)_mm_movemask_epi8(eq);
+
+            while (mask != 0) {
+                unsigned bit = __builtin_ctz(mask);
+                if (match_at(pat, s + i + bit)) return (const char *)(s + i + bit);
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+    // 남은 구간 (또는 SIMD 미지원 환경)
+    for (; i <= last; i++) {
+        if ((s[i] == f || s[i] == fu) && match_at(pat, s + i))
+            return (const char *)(s + i);
+    }
+    return NULL;
+}
+
+/*
+ * 필수 문자열 목록 함수 (트라이그램 색인 등 파일 단위 전처리용)
+ * 설명: 매칭되는 줄은 fn으로 전달한 문자열 중 적어도 하나를 포함합니다 (-i 이면 대소문자 무시).
+ *       정규식은 구문 트리에서 뽑은 선택지별 필수 리터럴을 전달합니다.
+ *       하나도 전달하지 않고 0을 반환하면 어떤 줄도 매칭되지 않는다는 뜻입니다.
+ * 반환값: 0(목록이 완전함), -1(그런 문자열이 없음: 모든 줄이 후보)
+ */
+int grep_literals(const struct grep_pattern *pat, grep_literal_fn fn, void *ctx) {
+    if (pat->rx != NULL) {
+        const struct grep_pattern *lit = grep_regex_prefilter(pat->rx);
+        return lit != NULL ? grep_literals(lit, fn, ctx) : -1;
+    }
+    if (pat->multi != NULL) return grep_multi_literals(pat->multi, fn, ctx);
+    if (pat->len == 0) return -1;
+    fn(ctx, pat->text, pat->len);
+    return 0;
+}
+
+/*
+ * 바이너리 파일 판별 함수 (-r)
+ * 설명: 첫 GREP_BINARY_SNIFF 바이트에 NUL이 있으면 바이너리로 봅니다 (GNU grep, ripgrep과 같은 기준).
+ */
+int grep_is_binary(const char *buf, size_t len) {
+    return memchr(buf, '\0', len < GREP_BINARY_SNIFF ? len : GREP_BINARY_SNIFF) != NULL;
+}
+
+/*
+ * 개행 문자 개수 세기 (-n 옵션의 줄 번호 계산용)
+ */
+size_t grep_count_lines(const char *buf, size_t len) {
+    const unsigned char *s = (const unsigned char *)buf;
+    size_t n = 0, i = 0;
+
+#if defined(__SSE2__)
+    __m128i nl = _mm_set1_epi8('\n');
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        n += __builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+    }
+#endif
+    for (; i < len; i++) n += (s[i] == '\n');
+    return n;
+}
+
+/*
+ * 다음 매칭 줄 찾기 함수
+ * 설명: 고정 문자열은 버퍼 전체에서 패턴을 찾은 뒤, memrchr/memchr로 그 위치가 속한
+ *       줄의 경계를 복원합니다. 정규식은 grep_regex.c에서 같은 방식으로 찾습니다.
+ *       p는 줄의 시작이어야 합니다.
+ * 반환값: 1(매칭된 줄 [ls, le)를 찾음), 0(없음)
+ */
+static int find_line(const struct grep_pattern *pat, const char *p, const char *end,
+                     const char **ls, const char **le) {
+    const char *m;
+
+    if (pat->rx != NULL) return grep_regex_find_line(pat->rx, p, end, ls, le);
+
+    m = grep_find(pat, p, end - p);
+    if (m == NULL) return 0;
+    *ls = memrchr(p, '\n', m - p);
+    *ls = (*ls != NULL) ? *ls + 1 : p;
+    *le = memchr(m, '\n', end - m);
+    *le = (*le != NULL) ? *le + 1 : end;
+    return 1;
+}
+
+/*
+ * 버퍼 스캔 함수
+ * 설명: 다음 매칭 줄을 버퍼 전체에서 바로 찾으므로 (find_line)
+ *       매칭이 없는 구간은 줄 단위로 나누지 않습니다.
+ *       buf는 완전한 줄들로 이루어져 있어야 합니다 (마지막 줄은 개행 없이 끝날 수 있음).
+ */
+void grep_scan(const struct grep_pattern *pat, const struct grep_opts *opts,
+               const char *buf, size_t len, struct grep_state *st,
+               grep_line_fn fn, void *ctx) {
+    const char *p = buf;
+    const char *end = buf + len;
+    const char *counted = buf; // 줄 번호를 이 위치까지 계산함
+    int print_lines = !opts->count_only && !opts->list_files;
+    int stop_early = opts->list_files && !opts->count_only;
+    int track = print_lines && opts->show_line_numbers;
+
+    while (p < end && !st->done) {
+        const char *ls = end, *le = end; // 매칭된 줄의 시작과 끝
+        int found = find_line(pat, p, end, &ls, &le);
+
+        if (opts->invert_match) {
+            // [p, ls) 구간의 줄들은 모두 매칭되지 않은 줄
+            while (p < ls) {
+                const char *nl = memchr(p, '\n', ls - p);
+                const char *next = (nl != NULL) ? nl + 1 : ls;
+
+                st->count++;
+                if (print_lines) {
+                    if (track) {
+                        st->lineno += grep_count_lines(counted, p - counted);
+                        counted = p;
+                    }
+                    if (fn != NULL && fn(ctx, p, next - p, st->lineno)) st->done = 1;
+                }
+                if (stop_early) st->done = 1;
+                if (st->done) break;
+                p = next;
+            }
+            if (!found || st->done) break;
+            p = le; // 매칭된 줄은 건너뜀
+            continue;
+        }
+
+        if (!found) break;
+
+        st->count++;
+        if (print_lines) {
+            if (track) {
+                st->lineno += grep_count_lines(counted, ls - counted);
+                counted = ls;
+            }
+            if (fn != NULL && fn(ctx, ls, le - ls, st->lineno)) st->done = 1;
+        }
+        if (stop_early) st->done = 1;
+        p = le;
+    }
+
+    // 다음 버퍼를 위해 나머지 줄 수 반영
+    if (track) st->lineno += grep_count_lines(counted, end - counted);
+}
+
+/*
+ * 파일 디스크립터 스캔 함수
+ * 설명: 일반 파일은 mmap하여 한 번에 스캔하고 (GREP_MMAP_MIN보다 작으면 read 한 번),
+ *       파이프 등은 큰 블록으로 읽어
+ *       완전한 줄까지만 스캔한 뒤 나머지를 다음 블록과 합칩니다.
+ *       (줄 길이에는 제한이 없음)
+ * 반환값: 0(성공), -1(읽기 오류, errno 설정)
+ */
+int grep_fd(const struct grep_pattern *pat, const struct grep_opts *opts,
+            int fd, struct grep_state *st, grep_line_fn fn, void *ctx) {
+    struct stat sb;
+    size_t cap = GREP_READ_CHUNK, used = 0;
+    int first = 1;
+    int is_file = fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0;
+
+    if (is_file && sb.st_size < GREP_MMAP_MIN) {
+        cap = GREP_MMAP_MIN;   // 작은 파일은 작은 버퍼로 한 번에 읽음
+    } else if (is_file) {
+        size_t size = (size_t)sb.st_size;
+        void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED) {
+            madvise(map, size, MADV_SEQUENTIAL);
+            if (opts->skip_binary && grep_is_binary(map, size)) {
+                st->done = 1;
+                munmap(map, size);
+                return 0;
+            }
+            grep_scan(pat, opts, map, size, st, fn, ctx);
+            munmap(map, size);
+            return 0;
+        }
+    }
+
+    char *buf = malloc(cap);
+    if (buf == NULL) return -1;
+
+    while (!st->done) {
+        // 한 줄이 버퍼보다 길면 버퍼를 늘림
+        if (cap - used < cap / 2) {
+            char *bigger = realloc(buf, cap * 2);
+            if (bigger == NULL) { free(buf); errno = ENOMEM; return -1; }
+            buf = bigger;
+            cap *= 2;
+        }
+
+        ssize_t n = read(fd, buf + used, cap - used);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int saved = errno;
+            free(buf);
+            errno = saved;
+            return -1;
+        }
+        if (n == 0) break;
+        used += n;
+
+        // 첫 블록으로 바이너리 판별 (블록이 작아도 처음 읽은 만큼으로 판단)
+        if (opts->skip_binary && first && grep_is_binary(buf, used)) {
+            st->done = 1;
+            break;
+        }
+        first = 0;
+
+        // 새로 읽은 부분에서 마지막 개행을 찾아 그 앞까지만 스캔
+        char *nl = memrchr(buf + used - n, '\n', n);
+        if (nl != NULL) {
+            size_t take = nl + 1 - buf;
+            grep_scan(pat, opts, buf, take, st, fn, ctx);
+            memmove(buf, buf + take, used - take);
+            used -= take;
+        }
+    }
+
+    // 개행 없이 끝나는 마지막 줄
+    if (used > 0 && !st->done) grep_scan(pat, opts, buf, used, st, fn, ctx);
+
+    free(buf);
+    return 0;
+}
+
+/*
+ * 기본 출력 콜백: 줄 번호(-n)와 함께 줄을 그대로 출력합니다.
+ */
+int grep_print_line(void *ctx, const char *line, size_t len, long lineno) {
+    struct grep_printer *pr = ctx;
+
+    if (pr->name != NULL) fprintf(pr->out, "%s:", pr->name);
+    if (pr->show_line_numbers) fprintf(pr->out, "%6ld: ", lineno);
+    fwrite(line, 1, len, pr->out);
+    return 0;
+}
+
+/*
+ * 파일별 요약 출력 (-c, -l)
+ * 설명: name이 NULL이면 (stdin) -l 출력은 생략합니다. -r 이면 -c 결과 앞에 이름을 붙입니다.
+ */
+void grep_report(const struct grep_opts *opts, const char *name, long count, FILE *out) {
+    if (opts->count_only && opts->with_filename && name != NULL) fprintf(out, "%s:", name);
+    if (opts->count_only) fprintf(out, "%ld\n", count);
+    if (opts->list_files && count > 0 && name != NULL) fprintf(out, "%s\n", name);
+}
+
+/*
+ * 경로 하나를 검색하고 결과를 출력하는 함수
+ * 반환값: 매칭된 줄 수, 파일을 열 수 없으면 -1
+ */
+long grep_path(const struct grep_pattern *pat, const struct grep_opts *opts,
+               const char *path, FILE *out) {
+    struct grep_printer pr = { out, opts->show_line_numbers, opts->with_filename ? path : NULL };
+    struct grep_state st;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+
+    grep_state_init(&st);
+    if (grep_fd(pat, opts, fd, &st, grep_print_line, &pr) < 0) {
+        // 읽기 오류 (디렉토리 등): 지금까지의 결과로 요약 출력
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+    }
+    close(fd);
+
+    grep_report(opts, path, st.count, out);
+    return st.count;
+}
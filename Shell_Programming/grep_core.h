@@ -0,0 +1,136 @@
+/* grep_core.h */
+#ifndef GREP_CORE_H
+#define GREP_CORE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* 패턴 문법: -F 고정 문자열(기본), -G 기본 정규식(BRE), -E 확장 정규식(ERE) */
+enum grep_syntax { GREP_FIXED, GREP_BASIC, GREP_EXTENDED };
+
+/* 이보다 작은 파일은 mmap 대신 read (매핑/해제와 페이지 폴트 비용이 검색보다 큼, -r의 작은 파일들) */
+#define GREP_MMAP_MIN  (64 << 10)
+
+/* 이 크기의 첫 블록에 NUL 바이트가 있으면 바이너리 파일로 봄 (-r) */
+#define GREP_BINARY_SNIFF  (32 << 10)
+
+/*
+ * grep 옵션 (-i -n -v -c -l -F -G -E -r)
+ */
+struct grep_opts {
+    int syntax;
+    int ignore_case;
+    int show_line_numbers;
+    int invert_match;
+    int count_only;
+    int list_files;
+    int with_filename;   // 줄과 -c 결과 앞에 "파일 이름:" 출력 (-r)
+    int skip_binary;     // 바이너리 파일은 매칭이 없는 것으로 처리 (-r, GNU grep -I)
+};
+
+struct grep_regex;
+struct grep_multi;
+
+/*
+ * 컴파일된 검색 패턴
+ * 설명: -i 옵션일 때 패턴은 한 번만 소문자로 변환해 둡니다.
+ *       정규식이 리터럴(들)과 같으면 (예: -E 'timeout|deadlock') 고정 문자열로 컴파일됩니다.
+ */
+struct grep_pattern {
+    unsigned char *text;   // 검색할 바이트열 (-i 이면 소문자로 변환됨)
+    size_t len;
+    int ignore_case;
+    struct grep_multi *multi; // 고정 문자열이 여러 개 (-e, -f)
+    struct grep_regex *rx; // -G/-E 정규식 (둘 다 NULL이면 text로 고정 문자열 검색)
+};
+
+/*
+ * 스캔 진행 상태 (버퍼를 여러 번 나누어 스캔할 때 유지됨)
+ */
+struct grep_state {
+    long lineno;   // 다음에 스캔할 줄의 번호 (1부터 시작)
+    long count;    // 지금까지 매칭된 줄 수
+    int done;      // 더 이상 스캔할 필요가 없음 (-l 조기 종료, 바이너리 파일)
+};
+
+/*
+ * 출력할 줄을 전달받는 콜백
+ * 설명: line은 개행 문자를 포함할 수 있으며, 0이 아닌 값을 반환하면 스캔을 중단합니다.
+ */
+typedef int (*grep_line_fn)(void *ctx, const char *line, size_t len, long lineno);
+
+/*
+ * 패턴의 필수 문자열을 전달받는 콜백 (grep_literals)
+ * 설명: s는 -i 이면 소문자로 변환된 상태이며 NUL로 끝나지 않을 수 있습니다.
+ */
+typedef void (*grep_literal_fn)(void *ctx, const unsigned char *s, size_t len);
+
+/* 표준 출력 콜백용 컨텍스트 */
+struct grep_printer {
+    FILE *out;
+    int show_line_numbers;
+    const char *name;      // NULL이 아니면 줄 앞에 "name:" 출력 (-r)
+};
+
+int grep_compile(struct grep_pattern *pat, const char *pattern, int ignore_case, int syntax);
+int grep_compile_list(struct grep_pattern *pat, char *const patterns[], int n, int ignore_case, int syntax);
+void grep_free(struct grep_pattern *pat);
+void grep_state_init(struct grep_state *st);
+
+const char *grep_find(const struct grep_pattern *pat, const char *buf, size_t len);
+int grep_literals(const struct grep_pattern *pat, grep_literal_fn fn, void *ctx);
+size_t grep_count_lines(const char *buf, size_t len);
+int grep_is_binary(const char *buf, size_t len);
+
+void grep_scan(const struct grep_pattern *pat, const struct grep_opts *opts,
+               const char *buf, size_t len, struct grep_state *st,
+               grep_line_fn fn, void *ctx);
+int grep_fd(const struct grep_pattern *pat, const struct grep_opts *opts,
+            int fd, struct grep_state *st, grep_line_fn fn, void *ctx);
+
+int grep_print_line(void *ctx, const char *line, size_t len, long lineno);
+void grep_report(const struct grep_opts *opts, const char *name, long count, FILE *out);
+long grep_path(const struct grep_pattern *pat, const struct grep_opts *opts,
+               const char *path, FILE *out);
+
+/* grep_multi.c: 여러 고정 문자열 (아호-코라식 DFA + 작은 집합은 SIMD 후보 검사) */
+struct grep_multi *grep_multi_compile(char *const patterns[], int n, int ignore_case);
+const char *grep_multi_find(const struct grep_multi *m, const char *buf, size_t len);
+int grep_multi_literals(const struct grep_multi *m, grep_literal_fn fn, void *ctx);
+void grep_multi_free(struct grep_multi *m);
+
+/* grep_regex.c: 정규식 (lazy DFA + 필수 리터럴 전처리), 패턴 여러 개는 선택(|)으로 묶음 */
+struct grep_regex *grep_regex_compile(char *const patterns[], int n, int ignore_case, int extended);
+char *const *grep_regex_exact(const struct grep_regex *rx, int *n);
+const struct grep_pattern *grep_regex_prefilter(const struct grep_regex *rx);
+int grep_regex_find_line(const struct grep_regex *rx, const char *p, const char *end,
+                         const char **ls, const char **le);
+void grep_regex_free(struct grep_regex *rx);
+
+/* grep_index.c: 디렉토리 트라이그램 색인 (--build-index DIR, --index) */
+int grep_index_build(const char *dir);
+int grep_index_search(const struct grep_pattern *pat, const struct grep_opts *opts,
+                      const char *dir, int jobs, FILE *out);
+
+/*
+ * -r 디렉토리 순회의 이름 거르기 (GNU grep의 --include, --exclude, --exclude-dir)
+ * 설명: glob은 fnmatch로 경로가 아닌 이름(basename)에 맞춥니다.
+ */
+struct grep_walk_filter {
+    char **include;        // 하나라도 맞는 파일만 검색 (없으면 모든 파일)
+    int ninclude;
+    char **exclude;        // 맞는 파일은 건너뜀
+    int nexclude;
+    char **exclude_dir;    // 맞는 하위 디렉토리는 들어가지 않음
+    int nexclude_dir;
+};
+
+/* grep_walk.c: -r 디렉토리 순회 (작업 훔치기로 하위 디렉토리를 여러 스레드가 나눠 읽음) */
+int grep_walk(const char *root, const struct grep_walk_filter *flt, int jobs,
+              char ***paths, size_t *npaths);
+
+/* grep_parallel.c: 여러 파일을 작업자 스레드로 동시에 검색 (출력은 인자 순서) */
+int grep_parallel(const struct grep_pattern *pat, const struct grep_opts *opts,
+                  char *const paths[], int npaths, int jobs, FILE *out);
+
+#endif
@@ -0,0 +1,797 @@
+/*
+ * grep_index.c
+ * 설명: 디렉토리 트라이그램 색인 (my_grep --build-index DIR, my_grep --index PATTERN DIR)
+ *
+ *   - DIR 아래 모든 일반 파일에서 (ASCII 소문자로 바꾼) 3바이트 조각마다 그 조각이 나오는
+ *     파일 번호 목록(포스팅 목록)을 만들어 DIR/.my_grep.idx 한 파일에 저장합니다.
+ *     헤더, 파일 표, 경로 문자열, 트라이그램 표, 포스팅 순서로 놓인 형식이라 mmap으로 바로
+ *     읽으며, 포스팅은 파일 번호의 차이를 가변 길이 정수로 적습니다.
+ *   - 검색할 때는 패턴의 필수 문자열(grep_literals)을 트라이그램으로 나눠 목록을 교집합하고,
+ *     후보 파일만 보통 검색기로 확인합니다. 트라이그램이 모두 있다고 매칭되는 것은 아니지만
+ *     매칭되는 파일이 후보에서 빠지는 일은 없습니다.
+ *   - 파일마다 상대 경로, 수정 시각, 크기를 적어 두어, 검색할 때 바뀌었거나 새로 생긴 파일은
+ *     색인과 관계없이 검색하고, 색인을 다시 만들 때는 바뀐 파일만 다시 읽습니다.
+ *     그래서 결과는 항상 `find DIR -type f | sort` 순서로 모든 파일을 검색한 것과 같습니다.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "grep_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define INDEX_NAME   ".my_grep.idx"   // DIR 바로 아래의 색인 파일 (.tmp는 만드는 중인 파일)
+#define INDEX_MAGIC  "MYGRIDX1"
+
+#define IDX_INDEXED  1                // 내용을 읽어 트라이그램을 뽑은 파일 (읽기 실패면 0)
+
+struct idx_header {
+    char magic[8];
+    uint32_t nfiles;
+    uint32_t ntrigrams;
+    uint64_t files_off;    // struct idx_file[nfiles] (경로 순으로 정렬)
+    uint64_t names_off;    // NUL로 끝나는 상대 경로들
+    uint64_t tri_off;      // struct idx_trigram[ntrigrams] (트라이그램 순으로 정렬)
+    uint64_t post_off;     // 포스팅 목록
+    uint64_t size;         // 색인 파일 전체 크기 (잘린 파일 검사)
+};
+
+struct idx_file {
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t size;
+    uint32_t name_off;     // names_off 기준
+    uint32_t name_len;
+    uint32_t flags;
+    uint32_t pad;
+};
+
+struct idx_trigram {
+    uint32_t trigram;
+    uint32_t nfiles;
+    uint64_t off;          // post_off 기준
+};
+
+/* mmap한 색인 */
+struct grep_index {
+    void *map;
+    size_t size;
+    const struct idx_header *h;
+    const struct idx_file *files;
+    const char *names;
+    const struct idx_trigram *tris;
+    const unsigned char *post, *post_end;
+};
+
+/* 디렉토리를 돌며 찾은 일반 파일 */
+struct walk_file {
+    char *path;            // DIR 기준 상대 경로
+    int64_t mtime_sec, mtime_nsec;
+    uint64_t size;
+    uint32_t flags;
+};
+
+struct walk_list {
+    struct walk_file *v;
+    size_t n, cap;
+};
+
+static unsigned char fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+/* 경로 잇기 (prefix가 비어 있으면 name만) */
+static char *join_path(const char *prefix, const char *name) {
+    size_t a = strlen(prefix), b = strlen(name);
+    int slash = (a > 0 && prefix[a - 1] != '/');
+    char *s = malloc(a + slash + b + 1);
+
+    if (s == NULL) return NULL;
+    memcpy(s, prefix, a);
+    if (slash) s[a] = '/';
+    memcpy(s + a + slash, name, b + 1);
+    return s;
+}
+
+static void walk_free(struct walk_list *wl) {
+    for (size_t k = 0; k < wl->n; k++) free(wl->v[k].path);
+    free(wl->v);
+}
+
+static int walk_add(struct walk_list *wl, char *path, const struct stat *sb) {
+    if (wl->n == wl->cap) {
+        size_t cap = wl->cap ? wl->cap * 2 : 256;
+        struct walk_file *bigger = realloc(wl->v, cap * sizeof(*bigger));
+        if (bigger == NULL) return -1;
+        wl->v = bigger;
+        wl->cap = cap;
+    }
+    wl->v[wl->n].path = path;
+    wl->v[wl->n].mtime_sec = sb->st_mtim.tv_sec;
+    wl->v[wl->n].mtime_nsec = sb->st_mtim.tv_nsec;
+    wl->v[wl->n].size = (uint64_t)sb->st_size;
+    wl->v[wl->n].flags = 0;
+    wl->n++;
+    return 0;
+}
+
+/*
+ * 디렉토리 순회 함수
+ * 설명: dfd가 가리키는 디렉토리(경로 root/prefix) 아래의 일반 파일을 모읍니다.
+ *       심볼릭 링크는 따라가지 않으며 (find -type f와 같음), DIR 바로 아래의 색인 파일은 뺍니다.
+ *       열 수 없는 하위 디렉토리는 오류를 출력하고 건너뜁니다.
+ * 반환값: 0(성공), -1(메모리 부족)
+ */
+static int walk_dir(const char *root, int dfd, const char *prefix, struct walk_list *wl) {
+    DIR *d = fdopendir(dfd);
+    struct dirent *de;
+    int status = 0;
+
+    if (d == NULL) {
+        close(dfd);
+        return 0;
+    }
+    while (status == 0 && (de = readdir(d)) != NULL) {
+        const char *name = de->d_name;
+        struct stat sb;
+        char *child;
+
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+        if (prefix[0] == '\0' && strncmp(name, INDEX_NAME, sizeof(INDEX_NAME) - 1) == 0) continue;
+        if (de->d_type != DT_UNKNOWN && de->d_type != DT_REG && de->d_type != DT_DIR) continue;
+
+        // 일반 파일은 수정 시각과 크기가 필요하므로 항상 stat (d_type이 없는 파일 시스템도 여기서 구분)
+        if (de->d_type != DT_DIR && fstatat(dirfd(d), name, &sb, AT_SYMLINK_NOFOLLOW) < 0) continue;
+        if (de->d_type == DT_DIR) sb.st_mode = S_IFDIR;
+
+        child = join_path(prefix, name);
+        if (child == NULL) {
+            status = -1;
+            break;
+        }
+        if (S_ISDIR(sb.st_mode)) {
+            int fd = openat(dirfd(d), name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (fd < 0) {
+                fprintf(stderr, "%sgrep: %s/%s: %s%s\n", COLOR_RED, root, child, strerror(errno), COLOR_RESET);
+            } else {
+                status = walk_dir(root, fd, child, wl);
+            }
+            free(child);
+        } else if (S_ISREG(sb.st_mode)) {
+            if (walk_add(wl, child, &sb) < 0) {
+                free(child);
+                status = -1;
+            }
+        } else {
+            free(child);
+        }
+    }
+    closedir(d);
+    return status;
+}
+
+static int cmp_walk(const void *a, const void *b) {
+    return strcmp(((const struct walk_file *)a)->path, ((const struct walk_file *)b)->path);
+}
+
+/*
+ * 파일 목록 함수
+ * 설명: dir 아래의 일반 파일을 경로 순으로 정렬해 모읍니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+static int walk_tree(const char *dir, struct walk_list *wl) {
+    int fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    memset(wl, 0, sizeof(*wl));
+    if (fd < 0) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, dir, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+    if (walk_dir(dir, fd, "", wl) < 0) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, dir, strerror(ENOMEM), COLOR_RESET);
+        walk_free(wl);
+        return -1;
+    }
+    qsort(wl->v, wl->n, sizeof(*wl->v), cmp_walk);
+    return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 색인 읽기                                                                */
+/* ---------------------------------------------------------------------- */
+
+static void index_close(struct grep_index *ix) {
+    if (ix->map != NULL) munmap(ix->map, ix->size);
+    ix->map = NULL;
+}
+
+/*
+ * 색인 열기 함수
+ * 설명: 색인 파일을 mmap하고 모든 구역과 경로가 파일 안에 있는지 확인합니다.
+ * 반환값: 0(성공), -1(없음 또는 형식 오류, errno 설정)
+ */
+static int index_open(const char *dir, struct grep_index *ix) {
+    char *path = join_path(dir, INDEX_NAME);
+    struct stat sb;
+    int fd;
+
+    memset(ix, 0, sizeof(*ix));
+    if (path == NULL) return -1;
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    free(path);
+    if (fd < 0) return -1;
+    if (fstat(fd, &sb) < 0 || (size_t)sb.st_size < sizeof(struct idx_header)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    ix->size = (size_t)sb.st_size;
+    ix->map = mmap(NULL, ix->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ix->map == MAP_FAILED) {
+        ix->map = NULL;
+        return -1;
+    }
+
+    const struct idx_header *h = ix->h = ix->map;
+    const char *base = ix->map;
+    if (memcmp(h->magic, INDEX_MAGIC, 8) != 0 || h->size != ix->size ||
+        h->files_off < sizeof(*h) || h->files_off % 8 != 0 || h->tri_off > ix->size || h->tri_off % 8 != 0 ||
+        h->files_off + (uint64_t)h->nfiles * sizeof(struct idx_file) > h->names_off ||
+        h->names_off > h->tri_off ||
+        h->tri_off + (uint64_t)h->ntrigrams * sizeof(struct idx_trigram) > h->post_off ||
+        h->post_off > ix->size) {
+        index_close(ix);
+        errno = EINVAL;
+        return -1;
+    }
+    ix->files = (const struct idx_file *)(base + h->files_off);
+    ix->names = base + h->names_off;
+    ix->tris = (const struct idx_trigram *)(base + h->tri_off);
+    ix->post = (const unsigned char *)base + h->post_off;
+    ix->post_end = (const unsigned char *)base + ix->size;
+
+    uint64_t names_size = h->tri_off - h->names_off;
+    for (uint32_t k = 0; k < h->nfiles; k++) {
+        const struct idx_file *f = &ix->files[k];
+        if ((uint64_t)f->name_off + f->name_len >= names_size || ix->names[f->name_off + f->name_len] != '\0') {
+            index_close(ix);
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static const char *index_name(const struct grep_index *ix, uint32_t id) {
+    return ix->names + ix->files[id].name_off;
+}
+
+/* 트라이그램 표에서 이진 검색 (없으면 NULL) */
+static const struct idx_trigram *index_lookup(const struct grep_index *ix, uint32_t t) {
+    size_t lo = 0, hi = ix->h->ntrigrams;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ix->tris[mid].trigram < t) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < ix->h->ntrigrams && ix->tris[lo].trigram == t) ? &ix->tris[lo] : NULL;
+}
+
+/*
+ * 포스팅 목록 풀기 함수
+ * 설명: 차이로 적힌 파일 번호를 out[]에 풉니다 (out은 tri->nfiles개 이상).
+ * 반환값: 0(성공), -1(색인이 손상됨)
+ */
+static int index_postings(const struct grep_index *ix, const struct idx_trigram *tri, uint32_t *out) {
+    const unsigned char *p = ix->post + tri->off, *end = ix->post_end;
+    uint32_t id = 0;
+
+    if (tri->off > (uint64_t)(end - ix->post)) return -1;
+    for (uint32_t k = 0; k < tri->nfiles; k++) {
+        uint32_t delta = 0;
+        int shift = 0;
+        for (;;) {
+            if (p >= end || shift > 28) return -1;
+            delta |= (uint32_t)(*p & 0x7f) << shift;
+            shift += 7;
+            if ((*p++ & 0x80) == 0) break;
+        }
+        id += delta;
+        if (id >= ix->h->nfiles) return -1;
+        out[k] = id;
+    }
+    return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 색인 만들기                                                              */
+/* ---------------------------------------------------------------------- */
+
+/* (트라이그램 << 32 | 파일 번호) 쌍 목록 */
+struct pair_list {
+    uint64_t *v;
+    size_t n, cap;
+};
+
+static int pair_add(struct pair_list *pl, uint64_t x) {
+    if (pl->n == pl->cap) {
+        size_t cap = pl->cap ? pl->cap * 2 : 1 << 16;
+        uint64_t *bigger = realloc(pl->v, cap * sizeof(*bigger));
+        if (bigger == NULL) return -1;
+        pl->v = bigger;
+        pl->cap = cap;
+    }
+    pl->v[pl->n++] = x;
+    return 0;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * 트라이그램 추출 함수
+ * 설명: 파일 내용에서 개행을 걸치지 않는 트라이그램을 한 번씩만 pl에 추가합니다
+ *       (패턴은 개행을 포함하지 않으므로 개행을 걸치는 조각은 필요 없음).
+ *       seen은 2^24비트 표이며 끝나면 다시 0으로 돌려 둡니다.
+ *       수정 시각과 크기는 연 파일 기준으로 갱신하므로, 읽는 도중 바뀐 파일은 다음 검색에서
+ *       바뀐 파일로 처리됩니다.
+ * 반환값: 0(성공), -1(읽기 실패 또는 메모리 부족, errno 설정)
+ */
+static int extract_trigrams(int dfd, struct walk_file *f, uint32_t id, struct pair_list *pl, uint64_t *seen) {
+    size_t start = pl->n;
+    struct stat sb;
+    int status = 0;
+    int fd = openat(dfd, f->path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+
+    if (fd < 0) return -1;
+    if (fstat(fd, &sb) < 0) {
+        close(fd);
+        return -1;
+    }
+    f->mtime_sec = sb.st_mtim.tv_sec;
+    f->mtime_nsec = sb.st_mtim.tv_nsec;
+    f->size = (uint64_t)sb.st_size;
+    if (sb.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (map == MAP_FAILED) {
+        errno = saved;
+        return -1;
+    }
+    madvise(map, (size_t)sb.st_size, MADV_SEQUENTIAL);
+
+    const unsigned char *s = map;
+    uint32_t t = 0;
+    int run = 0;
+    for (size_t i = 0; i < (size_t)sb.st_size; i++) {
+        if (s[i] == '\n') {
+            run = 0;
+            continue;
+        }
+        t = ((t << 8) | fold(s[i])) & 0xffffff;
+        if (++run < 3 || (seen[t >> 6] >> (t & 63)) & 1) continue;
+        seen[t >> 6] |= (uint64_t)1 << (t & 63);
+        if (pair_add(pl, (uint64_t)t << 32 | id) < 0) {
+            status = -1;
+            break;
+        }
+    }
+    munmap(map, (size_t)sb.st_size);
+
+    for (size_t k = start; k < pl->n; k++) {
+        uint32_t x = (uint32_t)(pl->v[k] >> 32);
+        seen[x >> 6] = 0;
+    }
+    if (status < 0) errno = ENOMEM;
+    return status;
+}
+
+/* 가변 길이 정수 쓰기 (7비트씩, 최상위 비트는 계속 표시) */
+static size_t put_varint(unsigned char *p, uint32_t x) {
+    size_t n = 0;
+    while (x >= 0x80) {
+        p[n++] = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    p[n++] = (unsigned char)x;
+    return n;
+}
+
+/*
+ * 색인 파일 쓰기 함수
+ * 설명: 정렬된 쌍 목록으로 트라이그램 표와 포스팅을 만들어 .tmp에 쓴 뒤 rename으로 바꿉니다
+ *       (쓰는 도중에 검색해도 이전 색인이나 새 색인 중 하나만 보임).
+ * 반환값: 0(성공), -1(실패, errno 설정)
+ */
+static int write_index(const char *dir, const struct walk_list *wl, const struct pair_list *pl) {
+    struct idx_header h = { 0 };
+    struct idx_file *files = NULL;
+    struct idx_trigram *tris = NULL;
+    unsigned char *post = NULL;
+    char *path = join_path(dir, INDEX_NAME), *tmp = join_path(dir, INDEX_NAME ".tmp");
+    size_t ntris = 0, names_size = 0, post_size = 0;
+    FILE *fp = NULL;
+    int status = -1, saved;
+
+    if (path == NULL || tmp == NULL) goto out;
+
+    for (size_t k = 0; k < pl->n; k++)
+        if (k == 0 || (pl->v[k] >> 32) != (pl->v[k - 1] >> 32)) ntris++;
+    files = calloc(wl->n ? wl->n : 1, sizeof(*files));
+    tris = calloc(ntris ? ntris : 1, sizeof(*tris));
+    post = malloc(pl->n * 5 + 1);  // 번호 차이 하나는 가변 길이 정수로 최대 5바이트
+    if (files == NULL || tris == NULL || post == NULL) {
+        errno = ENOMEM;
+        goto out;
+    }
+
+    for (size_t k = 0; k < wl->n; k++) {
+        files[k].mtime_sec = wl->v[k].mtime_sec;
+        files[k].mtime_nsec = wl->v[k].mtime_nsec;
+        files[k].size = wl->v[k].size;
+        files[k].name_off = (uint32_t)names_size;
+        files[k].name_len = (uint32_t)strlen(wl->v[k].path);
+        files[k].flags = wl->v[k].flags;
+        names_size += files[k].name_len + 1;
+    }
+    if (names_size > UINT32_MAX) {
+        errno = EOVERFLOW;
+        goto out;
+    }
+
+    size_t t = 0;
+    uint32_t prev = 0;
+    for (size_t k = 0; k < pl->n; k++) {
+        uint32_t tri = (uint32_t)(pl->v[k] >> 32), id = (uint32_t)pl->v[k];
+        if (k == 0 || tri != tris[t - 1].trigram) {
+            tris[t].trigram = tri;
+            tris[t].off = post_size;
+            t++;
+            prev = 0;
+        }
+        tris[t - 1].nfiles++;
+        post_size += put_varint(post + post_size, id - prev);
+        prev = id;
+    }
+
+    h.nfiles = (uint32_t)wl->n;
+    h.ntrigrams = (uint32_t)ntris;
+    memcpy(h.magic, INDEX_MAGIC, 8);
+    h.files_off = sizeof(h);
+    h.names_off = h.files_off + wl->n * sizeof(*files);
+    h.tri_off = (h.names_off + names_size + 7) & ~(uint64_t)7;
+    h.post_off = h.tri_off + ntris * sizeof(*tris);
+    h.size = h.post_off + post_size;
+
+    fp = fopen(tmp, "we");
+    if (fp == NULL) goto out;
+    fwrite(&h, sizeof(h), 1, fp);
+    fwrite(files, sizeof(*files), wl->n, fp);
+    for (size_t k = 0; k < wl->n; k++) fwrite(wl->v[k].path, 1, files[k].name_len + 1, fp);
+    for (uint64_t pad = h.names_off + names_size; pad < h.tri_off; pad++) fputc(0, fp);
+    fwrite(tris, sizeof(*tris), ntris, fp);
+    fwrite(post, 1, post_size, fp);
+    if (fclose(fp) != 0) {
+        fp = NULL;
+        goto out;
+    }
+    fp = NULL;
+    if (rename(tmp, path) < 0) goto out;
+    status = 0;
+
+out:
+    saved = errno;
+    if (fp != NULL) fclose(fp);
+    if (status < 0 && tmp != NULL) unlink(tmp);
+    free(path);
+    free(tmp);
+    free(files);
+    free(tris);
+    free(post);
+    errno = saved;
+    return status;
+}
+
+/*
+ * 색인 만들기 함수 (--build-index DIR)
+ * 설명: 이전 색인이 있으면 경로, 수정 시각, 크기가 같은 파일의 트라이그램은 이전 포스팅에서
+ *       옮겨 오고, 바뀌었거나 새로 생긴 파일만 읽습니다. 지워진 파일은 빠집니다.
+ *       읽을 수 없는 파일은 오류를 출력하고 색인 없이 목록에만 넣어, 검색할 때 항상 확인합니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int grep_index_build(const char *dir) {
+    struct walk_list wl;
+    struct grep_index old;
+    struct pair_list pl = { 0 };
+    uint64_t *seen = NULL;
+    int32_t *remap = NULL;
+    uint32_t *ids = NULL;
+    int have_old, dfd = -1, status = -1;
+
+    if (walk_tree(dir, &wl) < 0) return -1;
+    if (wl.n > UINT32_MAX) {
+        errno = EOVERFLOW;
+        goto fail;
+    }
+    have_old = (index_open(dir, &old) == 0);
+
+    // 바뀌지 않은 파일: 이전 번호 -> 새 번호 (두 목록 모두 경로 순이므로 한 번 훑기로 맞춤)
+    if (have_old) {
+        remap = malloc((old.h->nfiles ? old.h->nfiles : 1) * sizeof(*remap));
+        if (remap == NULL) goto nomem;
+        size_t j = 0;
+        for (uint32_t k = 0; k < old.h->nfiles; k++) {
+            const struct idx_file *f = &old.files[k];
+            int c = 1;
+
+            remap[k] = -1;
+            while (j < wl.n && (c = strcmp(wl.v[j].path, index_name(&old, k))) < 0) j++;
+            if (j < wl.n && c == 0 && (f->flags & IDX_INDEXED) && f->size == wl.v[j].size &&
+                f->mtime_sec == wl.v[j].mtime_sec && f->mtime_nsec == wl.v[j].mtime_nsec) {
+                remap[k] = (int32_t)j;
+                wl.v[j].flags = IDX_INDEXED;
+            }
+        }
+
+        uint32_t maxn = 0;
+        for (uint32_t t = 0; t < old.h->ntrigrams; t++)
+            if (old.tris[t].nfiles > maxn) maxn = old.tris[t].nfiles;
+        ids = malloc((maxn ? maxn : 1) * sizeof(*ids));
+        if (ids == NULL) goto nomem;
+        for (uint32_t t = 0; t < old.h->ntrigrams; t++) {
+            if (index_postings(&old, &old.tris[t], ids) < 0) {
+                // 손상된 색인: 옮겨 온 것을 버리고 처음부터 만듦
+                for (size_t k = 0; k < wl.n; k++) wl.v[k].flags = 0;
+                pl.n = 0;
+                break;
+            }
+            for (uint32_t k = 0; k < old.tris[t].nfiles; k++) {
+                if (remap[ids[k]] >= 0 && pair_add(&pl, (uint64_t)old.tris[t].trigram << 32 | (uint32_t)remap[ids[k]]) < 0)
+                    goto nomem;
+            }
+        }
+        index_close(&old);
+        have_old = 0;
+    }
+
+    seen = calloc((size_t)1 << 18, sizeof(*seen));
+    dfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (seen == NULL) goto nomem;
+    if (dfd < 0) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, dir, strerror(errno), COLOR_RESET);
+        goto fail;
+    }
+    for (size_t k = 0; k < wl.n; k++) {
+        if (wl.v[k].flags & IDX_INDEXED) continue;
+        if (extract_trigrams(dfd, &wl.v[k], (uint32_t)k, &pl, seen) < 0) {
+            if (errno == ENOMEM) goto nomem;
+            fprintf(stderr, "%sgrep: %s/%s: %s%s\n", COLOR_RED, dir, wl.v[k].path, strerror(errno), COLOR_RESET);
+            continue;
+        }
+        wl.v[k].flags = IDX_INDEXED;
+    }
+
+    qsort(pl.v, pl.n, sizeof(*pl.v), cmp_u64);
+    if (write_index(dir, &wl, &pl) < 0) {
+        fprintf(stderr, "%sgrep: %s/%s: %s%s\n", COLOR_RED, dir, INDEX_NAME, strerror(errno), COLOR_RESET);
+        goto fail;
+    }
+    status = 0;
+    goto fail;
+
+nomem:
+    fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, dir, strerror(ENOMEM), COLOR_RESET);
+fail:
+    if (have_old) index_close(&old);
+    if (dfd >= 0) close(dfd);
+    free(seen);
+    free(remap);
+    free(ids);
+    free(pl.v);
+    walk_free(&wl);
+    return status;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 색인으로 검색                                                            */
+/* ---------------------------------------------------------------------- */
+
+struct index_query {
+    const struct grep_index *ix;
+    unsigned char *cand;   // 색인 파일 번호별 후보 여부
+    uint32_t *ids, *tmp;   // 교집합 작업 공간 (가장 긴 포스팅 목록 크기)
+    int all;               // 모든 파일이 후보 (짧은 문자열, 손상된 색인)
+};
+
+static int cmp_tri_count(const void *a, const void *b) {
+    uint32_t x = (*(const struct idx_trigram *const *)a)->nfiles;
+    uint32_t y = (*(const struct idx_trigram *const *)b)->nfiles;
+    return (x > y) - (x < y);
+}
+
+/*
+ * 필수 문자열 하나의 후보 계산 (grep_literals 콜백)
+ * 설명: 문자열의 트라이그램이 모두 나오는 파일을 짧은 목록부터 교집합해 후보로 표시합니다.
+ *       3바이트보다 짧으면 트라이그램으로 거를 수 없으므로 모든 파일이 후보입니다.
+ */
+static void query_literal(void *ctx, const unsigned char *s, size_t len) {
+    struct index_query *q = ctx;
+    const struct idx_trigram **tris;
+    size_t ntris = 0;
+    uint32_t n;
+
+    if (q->all) return;
+    if (len < 3) {
+        q->all = 1;
+        return;
+    }
+    tris = malloc((len - 2) * sizeof(*tris));
+    if (tris == NULL) {
+        q->all = 1;
+        return;
+    }
+    for (size_t i = 0; i + 2 < len; i++) {
+        uint32_t t = (uint32_t)fold(s[i]) << 16 | (uint32_t)fold(s[i + 1]) << 8 | fold(s[i + 2]);
+        const struct idx_trigram *tri = index_lookup(q->ix, t);
+        if (tri == NULL) {
+            // 어느 파일에도 없는 조각: 이 문자열은 후보를 더하지 않음
+            free(tris);
+            return;
+        }
+        tris[ntris++] = tri;
+    }
+    qsort(tris, ntris, sizeof(*tris), cmp_tri_count);
+
+    n = tris[0]->nfiles;
+    if (index_postings(q->ix, tris[0], q->ids) < 0) goto corrupt;
+    for (size_t k = 1; k < ntris && n > 0; k++) {
+        uint32_t m = tris[k]->nfiles, a = 0, b = 0, out = 0;
+        if (tris[k] == tris[k - 1]) continue;
+        if (index_postings(q->ix, tris[k], q->tmp) < 0) goto corrupt;
+        while (a < n && b < m) {
+            if (q->ids[a] < q->tmp[b]) a++;
+            else if (q->ids[a] > q->tmp[b]) b++;
+            else {
+                q->ids[out++] = q->ids[a++];
+                b++;
+            }
+        }
+        n = out;
+    }
+    for (uint32_t k = 0; k < n; k++) q->cand[q->ids[k]] = 1;
+    free(tris);
+    return;
+
+corrupt:
+    q->all = 1;
+    free(tris);
+}
+
+/* 파일 목록 검색 (작업자 풀, 실패하거나 -j 1 이면 차례로) */
+static void search_paths(const struct grep_pattern *pat, const struct grep_opts *opts,
+                         char *const paths[], int n, int jobs, FILE *out) {
+    if (n == 0) return;
+    if (jobs > 1 && grep_parallel(pat, opts, paths, n, jobs, out) == 0) return;
+    for (int k = 0; k < n; k++) grep_path(pat, opts, paths[k], out);
+}
+
+/*
+ * 색인 검색 함수 (--index)
+ * 설명: dir 아래의 모든 일반 파일을 경로 순으로 검색한 것과 같은 결과를 출력하되,
+ *       색인에서 후보가 아닌 파일은 읽지 않습니다. 색인 이후 바뀌었거나 새로 생긴 파일,
+ *       -v (매칭되지 않는 줄은 어느 파일에나 있을 수 있음)는 항상 검색합니다.
+ *       -c 는 후보가 아닌 파일의 0도 제자리에 출력합니다.
+ *       색인이 없거나 손상되었으면 경고를 출력하고 모든 파일을 검색합니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int grep_index_search(const struct grep_pattern *pat, const struct grep_opts *opts,
+                      const char *dir, int jobs, FILE *out) {
+    struct walk_list wl;
+    struct grep_index ix;
+    struct index_query q = { 0 };
+    char **paths = NULL;
+    unsigned char *search = NULL;
+    int have_index, status = -1;
+
+    if (walk_tree(dir, &wl) < 0) return -1;
+
+    have_index = (index_open(dir, &ix) == 0);
+    if (!have_index) {
+        fprintf(stderr, "%sgrep: %s: no usable index (%s), searching all files; run --build-index%s\n",
+                COLOR_RED, dir, errno == ENOENT ? "not built" : strerror(errno), COLOR_RESET);
+    }
+
+    q.ix = &ix;
+    q.all = !have_index || opts->invert_match;
+    if (!q.all) {
+        uint32_t maxn = 0;
+        for (uint32_t t = 0; t < ix.h->ntrigrams; t++)
+            if (ix.tris[t].nfiles > maxn) maxn = ix.tris[t].nfiles;
+        q.cand = calloc(ix.h->nfiles ? ix.h->nfiles : 1, 1);
+        q.ids = malloc((maxn ? maxn : 1) * sizeof(uint32_t));
+        q.tmp = malloc((maxn ? maxn : 1) * sizeof(uint32_t));
+        if (q.cand == NULL || q.ids == NULL || q.tmp == NULL) q.all = 1;
+        else if (grep_literals(pat, query_literal, &q) < 0) q.all = 1;
+    }
+
+    // 파일마다 검색 여부: 색인에 없거나 바뀌었으면 항상, 아니면 후보일 때만
+    paths = calloc(wl.n ? wl.n : 1, sizeof(*paths));
+    search = calloc(wl.n ? wl.n : 1, 1);
+    if (paths == NULL || search == NULL) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, dir, strerror(ENOMEM), COLOR_RESET);
+        goto out;
+    }
+    uint32_t j = 0;
+    for (size_t k = 0; k < wl.n; k++) {
+        const struct walk_file *f = &wl.v[k];
+        int c = 1;
+
+        paths[k] = join_path(dir, f->path);
+        if (paths[k] == NULL) {
+            fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, dir, strerror(ENOMEM), COLOR_RESET);
+            goto out;
+        }
+        search[k] = 1;
+        if (q.all) continue;
+        while (j < ix.h->nfiles && (c = strcmp(index_name(&ix, j), f->path)) < 0) j++;
+        if (j < ix.h->nfiles && c == 0) {
+            const struct idx_file *e = &ix.files[j];
+            if ((e->flags & IDX_INDEXED) && e->size == f->size &&
+                e->mtime_sec == f->mtime_sec && e->mtime_nsec == f->mtime_nsec)
+                search[k] = q.cand[j];
+        }
+    }
+
+    if (!opts->count_only) {
+        // 검색하지 않는 파일은 아무것도 출력하지 않으므로 후보만 모아 한 번에 검색
+        size_t n = 0;
+        for (size_t k = 0; k < wl.n; k++) {
+            char *p = paths[k];
+            paths[k] = NULL;
+            if (search[k]) paths[n++] = p;
+            else free(p);
+        }
+        search_paths(pat, opts, paths, (int)n, jobs, out);
+    } else {
+        // -c: 후보 구간마다 검색하고 그 사이 파일은 0을 출력
+        size_t k = 0;
+        while (k < wl.n) {
+            size_t start = k;
+            while (k < wl.n && search[k]) k++;
+            search_paths(pat, opts, &paths[start], (int)(k - start), jobs, out);
+            for (; k < wl.n && !search[k]; k++) grep_report(opts, paths[k], 0, out);
+        }
+    }
+    status = 0;
+
+out:
+    if (paths != NULL)
+        for (size_t k = 0; k < wl.n; k++) free(paths[k]);
+    free(paths);
+    free(search);
+    free(q.cand);
+    free(q.ids);
+    free(q.tmp);
+    if (have_index) index_close(&ix);
+    walk_free(&wl);
+    return status;
+}
@@ -0,0 +1,298 @@
+/*
+ * grep_multi.c
+ * 설명: 여러 고정 문자열을 입력 한 번 읽기로 찾는 검색기
+ *       (-e를 여러 번, -f 패턴 파일, 정규식의 선택지별 필수 리터럴 전처리).
+ *
+ *   - 아호-코라식 오토마톤의 실패 링크를 미리 풀어, 패턴에 나오는 바이트의 클래스 위에서
+ *     완전한 DFA 표로 만듭니다. 입력 한 바이트당 표 조회 한 번이므로 바이트당 비용이
+ *     패턴 수와 관계없습니다. 매칭 상태는 번호를 가장 뒤로 모아 비교 한 번으로 확인합니다.
+ *   - 패턴이 GREP_MULTI_SMALL개 이하이면 (Teddy처럼) 각 패턴의 첫 두 바이트를 SIMD로
+ *     16/32바이트씩 비교해, 두 바이트가 모두 맞는 후보 위치만 전체 비교합니다.
+ *
+ * 컴파일 뒤에는 읽기만 하므로 여러 스레드가 같이 써도 됩니다.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "grep_core.h"
+
+#define GREP_MULTI_SMALL  8   // SIMD 후보 검사를 쓰는 최대 패턴 수
+
+struct grep_multi {
+    int npat;
+    unsigned char **pats;        // 패턴 (-i 이면 소문자)
+    size_t *lens;
+    int ignore_case;
+    int match_all;               // 빈 패턴이 있음: 모든 위치가 매칭
+    unsigned char classmap[256]; // 바이트 -> 클래스 (패턴에 없는 바이트는 0)
+    int nclasses;
+    int *trans;                  // 상태 행 위치(id * nclasses) 표
+    int match_row;               // 이 값 이상인 행은 매칭 상태 (어떤 패턴이 여기서 끝남)
+};
+
+static unsigned char fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static unsigned char unfold(unsigned char c) {
+    return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+void grep_multi_free(struct grep_multi *m) {
+    if (m == NULL) return;
+    for (int k = 0; k < m->npat; k++) free(m->pats[k]);
+    free(m->pats);
+    free(m->lens);
+    free(m->trans);
+    free(m);
+}
+
+/*
+ * 아호-코라식 DFA 구성 함수
+ * 설명: 트라이를 만든 뒤 BFS 순서로 실패 링크를 계산하면서 없는 전이를 실패 상태의
+ *       전이로 채웁니다. 마지막에 매칭 상태가 뒤에 오도록 번호를 다시 매깁니다.
+ * 반환값: 0(성공), -1(메모리 부족)
+ */
+static int build_automaton(struct grep_multi *m) {
+    int cls[256];
+    size_t total = 1;
+    int nc = 1, n = 1, status = -1;
+    int *tr = NULL, *fail = NULL, *queue = NULL, *newid = NULL;
+    unsigned char *term = NULL;
+
+    for (int c = 0; c < 256; c++) cls[c] = -1;
+    for (int k = 0; k < m->npat; k++) {
+        total += m->lens[k];
+        for (size_t j = 0; j < m->lens[k]; j++) {
+            unsigned char c = m->pats[k][j];
+            if (cls[c] >= 0) continue;
+            cls[c] = nc;
+            if (m->ignore_case) cls[unfold(c)] = nc;
+            nc++;
+        }
+    }
+    for (int c = 0; c < 256; c++) m->classmap[c] = (unsigned char)(cls[c] < 0 ? 0 : cls[c]);
+    m->nclasses = nc;
+
+    tr = malloc(total * nc * sizeof(int));
+    fail = calloc(total, sizeof(int));
+    queue = malloc(total * sizeof(int));
+    newid = malloc(total * sizeof(int));
+    term = calloc(total, 1);
+    if (tr == NULL || fail == NULL || queue == NULL || newid == NULL || term == NULL) goto out;
+    for (size_t k = 0; k < total * nc; k++) tr[k] = -1;
+
+    // 트라이
+    for (int k = 0; k < m->npat; k++) {
+        int s = 0;
+        for (size_t j = 0; j < m->lens[k]; j++) {
+            int c = m->classmap[m->pats[k][j]];
+            if (tr[s * nc + c] < 0) tr[s * nc + c] = n++;
+            s = tr[s * nc + c];
+        }
+        term[s] = 1;
+    }
+
+    // 실패 링크 (BFS), 없는 전이는 실패 상태의 전이로
+    int head = 0, tail = 0;
+    for (int c = 0; c < nc; c++) {
+        int u = tr[c];
+        if (u < 0) {
+            tr[c] = 0;
+        } else {
+            fail[u] = 0;
+            queue[tail++] = u;
+        }
+    }
+    while (head < tail) {
+        int s = queue[head++];
+        term[s] |= term[fail[s]];
+        for (int c = 0; c < nc; c++) {
+            int u = tr[s * nc + c];
+            if (u < 0) {
+                tr[s * nc + c] = tr[fail[s] * nc + c];
+            } else {
+                fail[u] = tr[fail[s] * nc + c];
+                queue[tail++] = u;
+            }
+        }
+    }
+
+    // 번호 다시 매기기: 매칭하지 않는 상태(루트 포함) 먼저, 매칭 상태는 뒤로
+    int id = 0;
+    for (int s = 0; s < n; s++) if (!term[s]) newid[s] = id++;
+    m->match_row = id * nc;
+    for (int s = 0; s < n; s++) if (term[s]) newid[s] = id++;
+
+    m->trans = malloc((size_t)n * nc * sizeof(int));
+    if (m->trans == NULL) goto out;
+    for (int s = 0; s < n; s++) {
+        for (int c = 0; c < nc; c++)
+            m->trans[newid[s] * nc + c] = newid[tr[s * nc + c]] * nc;
+    }
+    status = 0;
+
+out:
+    free(tr);
+    free(fail);
+    free(queue);
+    free(newid);
+    free(term);
+    return status;
+}
+
+/*
+ * 여러 패턴 컴파일 함수
+ * 설명: -i 이면 패턴을 소문자로 바꿔 두고, 클래스 표에서 대문자를 같은 클래스로 묶습니다.
+ * 반환값: 검색기, 메모리가 부족하면 NULL
+ */
+struct grep_multi *grep_multi_compile(char *const patterns[], int n, int ignore_case) {
+    struct grep_multi *m = calloc(1, sizeof(*m));
+
+    if (m == NULL) return NULL;
+    m->ignore_case = ignore_case;
+    m->pats = calloc(n > 0 ? n : 1, sizeof(*m->pats));
+    m->lens = calloc(n > 0 ? n : 1, sizeof(*m->lens));
+    if (m->pats == NULL || m->lens == NULL) {
+        grep_multi_free(m);
+        return NULL;
+    }
+
+    for (int k = 0; k < n; k++) {
+        size_t len = strlen(patterns[k]);
+        m->pats[k] = malloc(len + 1);
+        if (m->pats[k] == NULL) {
+            grep_multi_free(m);
+            return NULL;
+        }
+        m->npat = k + 1;
+        for (size_t j = 0; j <= len; j++)
+            m->pats[k][j] = ignore_case ? fold(patterns[k][j]) : (unsigned char)patterns[k][j];
+        m->lens[k] = len;
+        if (len == 0) m->match_all = 1;
+    }
+
+    if (build_automaton(m) < 0) {
+        grep_multi_free(m);
+        return NULL;
+    }
+    return m;
+}
+
+/* 아호-코라식 DFA로 [i, len) 스캔. 반환값: 처음 끝나는 매칭의 마지막 바이트, 없으면 NULL */
+static const char *ac_scan(const struct grep_multi *m, const unsigned char *s, size_t i, size_t len) {
+    const int *trans = m->trans;
+    const unsigned char *map = m->classmap;
+    int row = 0, thr = m->match_row;
+
+    for (; i < len; i++) {
+        row = trans[row + map[s[i]]];
+        if (row >= thr) return (const char *)(s + i);
+    }
+    return NULL;
+}
+
+/* 후보 위치 i에서 시작하는 패턴이 있는지 (작은 집합 경로의 확인 단계) */
+static int match_any_at(const struct grep_multi *m, const unsigned char *s, size_t i, size_t len) {
+    for (int k = 0; k < m->npat; k++) {
+        size_t plen = m->lens[k];
+        size_t j = 0;
+
+        if (plen > len - i) continue;
+        if (!m->ignore_case) {
+            if (memcmp(s + i, m->pats[k], plen) == 0) return 1;
+            continue;
+        }
+        while (j < plen && fold(s[i + j]) == m->pats[k][j]) j++;
+        if (j == plen) return 1;
+    }
+    return 0;
+}
+
+/*
+ * 여러 패턴 검색 함수
+ * 설명: 패턴이 적으면 SIMD로 첫 두 바이트가 맞는 위치를 모아 확인하고,
+ *       남은 구간(또는 패턴이 많을 때 전체)은 아호-코라식 DFA로 스캔합니다.
+ * 반환값: 처음 매칭된 문자열 안의 한 위치 (줄 경계 복원용), 없으면 NULL
+ */
+const char *grep_multi_find(const struct grep_multi *m, const char *buf, size_t len) {
+    const unsigned char *s = (const unsigned char *)buf;
+    size_t i = 0;
+
+    if (m->match_all) return buf;
+    if (m->npat == 0) return NULL;
+
+#if defined(__SSE2__)
+    if (m->npat <= GREP_MULTI_SMALL) {
+        unsigned char f[GREP_MULTI_SMALL], fu[GREP_MULTI_SMALL], sc[GREP_MULTI_SMALL], su[GREP_MULTI_SMALL];
+        int any2[GREP_MULTI_SMALL];
+
+        for (int k = 0; k < m->npat; k++) {
+            f[k] = m->pats[k][0];
+            fu[k] = m->ignore_case ? unfold(f[k]) : f[k];
+            any2[k] = m->lens[k] < 2;   // 한 바이트 패턴은 두 번째 바이트를 보지 않음
+            sc[k] = any2[k] ? 0 : m->pats[k][1];
+            su[k] = m->ignore_case ? unfold(sc[k]) : sc[k];
+        }
+#if defined(__AVX2__)
+        for (; i + 33 <= len; i += 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(s + i));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(s + i + 1));
+            __m256i hit = _mm256_setzero_si256();
+
+            for (int k = 0; k < m->npat; k++) {
+                __m256i x = _mm256_or_si256(_mm256_cmpeq_epi8(a, _mm256_set1_epi8((char)f[k])),
+                                            _mm256_cmpeq_epi8(a, _mm256_set1_epi8((char)fu[k])));
+                __m256i y = any2[k] ? _mm256_set1_epi8(-1)
+                                    : _mm256_or_si256(_mm256_cmpeq_epi8(b, _mm256_set1_epi8((char)sc[k])),
+                                                      _mm256_cmpeq_epi8(b, _mm256_set1_epi8((char)su[k])));
+                hit = _mm256_or_si256(hit, _mm256_and_si256(x, y));
+            }
+            unsigned mask = (unsigned)_mm256_movemask_epi8(hit);
+            while (mask != 0) {
+                unsigned bit = __builtin_ctz(mask);
+                if (match_any_at(m, s, i + bit, len)) return (const char *)(s + i + bit);
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i + 17 <= len; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(s + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(s + i + 1));
+            __m128i hit = _mm_setzero_si128();
+
+            for (int k = 0; k < m->npat; k++) {
+                __m128i x = _mm_or_si128(_mm_cmpeq_epi8(a, _mm_set1_epi8((char)f[k])),
+                                         _mm_cmpeq_epi8(a, _mm_set1_epi8((char)fu[k])));
+                __m128i y = any2[k] ? _mm_set1_epi8(-1)
+                                    : _mm_or_si128(_mm_cmpeq_epi8(b, _mm_set1_epi8((char)sc[k])),
+                                                   _mm_cmpeq_epi8(b, _mm_set1_epi8((char)su[k])));
+                hit = _mm_or_si128(hit, _mm_and_si128(x, y));
+            }
+            unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+            while (mask != 0) {
+                unsigned bit = __builtin_ctz(mask);
+                if (match_any_at(m, s, i + bit, len)) return (const char *)(s + i + bit);
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+    // 남은 구간 (또는 패턴이 많을 때): i 이전에 시작하는 매칭은 위에서 모두 확인함
+    return ac_scan(m, s, i, len);
+}
+
+/*
+ * 패턴 목록 전달 함수 (grep_literals)
+ * 반환값: 0(모든 매칭이 전달한 패턴 중 하나를 포함), -1(빈 패턴이 있어 모든 위치가 매칭)
+ */
+int grep_multi_literals(const struct grep_multi *m, grep_literal_fn fn, void *ctx) {
+    if (m->match_all) return -1;
+    for (int k = 0; k < m->npat; k++) fn(ctx, m->pats[k], m->lens[k]);
+    return 0;
+}
@@ -0,0 +1,379 @@
+/* grep_parallel.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "grep_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define SPLIT_THRESHOLD  (16 << 20)  // 이보다 큰 파일은 여러 구간으로 나누어 검색
+#define CHUNK_SIZE       (8 << 20)   // 구간 크기 (줄 경계에 맞춰 조정됨)
+#define MAX_AHEAD        256         // 출력보다 앞서 처리할 수 있는 최대 파일 수
+
+/* 매칭된 줄 (mmap 영역을 가리키므로 복사 없음) */
+struct grep_hit {
+    const char *line;
+    size_t len;
+    long lineno;   // 구간 내부에서의 줄 번호
+};
+
+/* 파일의 한 구간 (작업 단위) */
+struct grep_chunk {
+    const char *buf;
+    size_t len;
+    struct grep_hit *hits;
+    size_t nhits, cap;
+    long count;    // 매칭된 줄 수
+    long lines;    // 구간 안의 줄 수 (-n 일 때만 계산)
+    int done;
+};
+
+/* 입력 파일 하나의 처리 상태 */
+struct grep_file_job {
+    const char *path;
+    int err;            // 열기/읽기 오류 (errno)
+    int planned;        // 구간 분할 또는 스트림 처리가 끝났는지
+    void *map;
+    size_t size;
+    int nchunks;
+    struct grep_chunk *chunks;
+    int is_stream;      // 파이프 등 mmap 할 수 없는 입력
+    char *text;         // 스트림 입력의 출력 결과
+    size_t text_len;
+    long count;
+    int binary;         // 바이너리 파일이라 검색하지 않음 (skip_binary, 매칭 0으로 출력)
+};
+
+struct grep_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;   // 작업자: 새 작업 / 종료 확인
+    pthread_cond_t done_cv;   // 출력 스레드: 결과 완료 확인
+    const struct grep_pattern *pat;
+    const struct grep_opts *opts;
+    struct grep_file_job *files;
+    int nfiles;
+    int next_file;            // 다음에 가져갈 파일
+    int printed;              // 출력이 끝난 파일 수
+    int busy;                 // 파일 작업(구간 분할 가능) 중인 작업자 수
+    int nworkers;
+    struct { int file, chunk; } *queue;  // 구간 작업 큐
+    size_t qhead, qtail, qcap;
+};
+
+/* 매칭된 줄을 구간 결과에 기록하는 콜백 */
+static int collect_hit(void *ctx, const char *line, size_t len, long lineno) {
+    struct grep_chunk *c = ctx;
+
+    if (c->nhits == c->cap) {
+        size_t cap = c->cap ? c->cap * 2 : 64;
+        struct grep_hit *h = realloc(c->hits, cap * sizeof(*h));
+        if (h == NULL) return 1;
+        c->hits = h;
+        c->cap = cap;
+    }
+    c->hits[c->nhits].line = line;
+    c->hits[c->nhits].len = len;
+    c->hits[c->nhits].lineno = lineno;
+    c->nhits++;
+    return 0;
+}
+
+static void run_chunk(struct grep_pool *pool, struct grep_chunk *c) {
+    struct grep_state st;
+
+    grep_state_init(&st);
+    grep_scan(pool->pat, pool->opts, c->buf, c->len, &st, collect_hit, c);
+    c->count = st.count;
+    c->lines = st.lineno - 1;
+}
+
+/*
+ * 파일 작업: 열고 mmap 한 뒤, 큰 파일이면 줄 경계에 맞춘 구간으로 나누어
+ * 나머지 구간은 다른 작업자에게 넘기고 첫 구간은 직접 처리합니다.
+ */
+static void run_file(struct grep_pool *pool, struct grep_file_job *f) {
+    struct stat sb;
+    int fd = open(f->path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        f->err = errno;
+        goto planned;
+    }
+
+    if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size >= GREP_MMAP_MIN) {
+        f->size = (size_t)sb.st_size;
+        f->map = mmap(NULL, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (f->map == MAP_FAILED) f->map = NULL;
+    }
+
+    if (f->map == NULL) {
+        // mmap 할 수 없는 입력 (또는 작은 파일): 스트림으로 읽고 출력은 메모리에 모음
+        struct grep_state st;
+        struct grep_printer pr;
+        FILE *mem = open_memstream(&f->text, &f->text_len);
+
+        f->is_stream = 1;
+        if (mem == NULL) {
+            f->err = errno;
+            close(fd);
+            goto planned;
+        }
+        pr.out = mem;
+        pr.show_line_numbers = pool->opts->show_line_numbers;
+        pr.name = pool->opts->with_filename ? f->path : NULL;
+        grep_state_init(&st);
+        if (grep_fd(pool->pat, pool->opts, fd, &st, grep_print_line, &pr) < 0)
+            f->err = errno;
+        fclose(mem);
+        f->count = st.count;
+        close(fd);
+        goto planned;
+    }
+    close(fd); // 매핑은 fd를 닫아도 유지됨
+
+    madvise(f->map, f->size, MADV_SEQUENTIAL);
+    if (pool->opts->skip_binary && grep_is_binary(f->map, f->size)) {
+        munmap(f->map, f->size);
+        f->map = NULL;
+        f->binary = 1;
+        goto planned;
+    }
+
+    // 구간 경계 계산 (각 경계는 개행 바로 다음)
+    int n = 1;
+    if (f->size > SPLIT_THRESHOLD && pool->nworkers > 1)
+        n = (int)((f->size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    f->chunks = calloc(n, sizeof(struct grep_chunk));
+    if (f->chunks == NULL) {
+        f->err = ENOMEM;
+        munmap(f->map, f->size);
+        f->map = NULL;
+        goto planned;
+    }
+
+    const char *base = f->map;
+    size_t pos = 0;
+    int used = 0;
+    while (pos < f->size && used < n) {
+        size_t end = pos + CHUNK_SIZE;
+        if (used == n - 1 || end >= f->size) {
+            end = f->size;
+        } else {
+            const char *nl = memchr(base + end, '\n', f->size - end);
+            end = (nl != NULL) ? (size_t)(nl + 1 - base) : f->size;
+        }
+        f->chunks[used].buf = base + pos;
+        f->chunks[used].len = end - pos;
+        used++;
+        pos = end;
+    }
+    f->nchunks = used;
+
+    // 첫 구간을 제외한 구간들을 큐에 추가
+    pthread_mutex_lock(&pool->lock);
+    int idx = (int)(f - pool->files);
+    int queued = 1;
+    if (pool->qtail + used > pool->qcap) {
+        size_t cap = pool->qtail + used + 64;
+        void *q = realloc(pool->queue, cap * sizeof(*pool->queue));
+        if (q != NULL) {
+            pool->queue = q;
+            pool->qcap = cap;
+        } else {
+            queued = 0; // 큐를 늘릴 수 없으면 모든 구간을 직접 처리
+        }
+    }
+    for (int k = 1; queued && k < used; k++) {
+        pool->queue[pool->qtail].file = idx;
+        pool->queue[pool->qtail].chunk = k;
+        pool->qtail++;
+    }
+    f->planned = 1;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_cond_broadcast(&pool->done_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int k = 0; k < (queued ? 1 : used); k++) {
+        run_chunk(pool, &f->chunks[k]);
+
+        pthread_mutex_lock(&pool->lock);
+        f->chunks[k].done = 1;
+        pthread_cond_broadcast(&pool->done_cv);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return;
+
+planned:
+    pthread_mutex_lock(&pool->lock);
+    f->planned = 1;
+    pthread_cond_broadcast(&pool->done_cv);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void *worker_main(void *arg) {
+    struct grep_pool *pool = arg;
+
+    for (;;) {
+        int file = -1, chunk = -1;
+
+        pthread_mutex_lock(&pool->lock);
+        for (;;) {
+            if (pool->qhead < pool->qtail) {
+                file = pool->queue[pool->qhead].file;
+                chunk = pool->queue[pool->qhead].chunk;
+                pool->qhead++;
+                if (pool->qhead == pool->qtail) pool->qhead = pool->qtail = 0;
+                break;
+            }
+            if (pool->next_file < pool->nfiles &&
+                pool->next_file - pool->printed < MAX_AHEAD) {
+                file = pool->next_file++;
+                pool->busy++;
+                break;
+            }
+            // 남은 파일도, 분할 중인 파일도 없으면 종료
+            if (pool->next_file >= pool->nfiles && pool->busy == 0) {
+                pthread_mutex_unlock(&pool->lock);
+                return NULL;
+            }
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        if (chunk >= 0) {
+            struct grep_chunk *c = &pool->files[file].chunks[chunk];
+            run_chunk(pool, c);
+            pthread_mutex_lock(&pool->lock);
+            c->done = 1;
+            pthread_cond_broadcast(&pool->done_cv);
+            pthread_mutex_unlock(&pool->lock);
+        } else {
+            run_file(pool, &pool->files[file]);
+            pthread_mutex_lock(&pool->lock);
+            pool->busy--;
+            pthread_cond_broadcast(&pool->work_cv);
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+}
+
+/* 파일 하나의 결과를 인자 순서대로 출력 (구간이 끝나는 대로 출력) */
+static void print_file(struct grep_pool *pool, struct grep_file_job *f, FILE *out) {
+    const struct grep_opts *opts = pool->opts;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!f->planned) pthread_cond_wait(&pool->done_cv, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (f->is_stream) {
+        if (f->text_len > 0) fwrite(f->text, 1, f->text_len, out);
+        free(f->text);
+        if (f->err)
+            fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, f->path, strerror(f->err), COLOR_RESET);
+        grep_report(opts, f->path, f->count, out);
+        return;
+    }
+    if (f->binary) {
+        grep_report(opts, f->path, 0, out);
+        return;
+    }
+    if (f->map == NULL) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, f->path, strerror(f->err), COLOR_RESET);
+        return;
+    }
+
+    long base = 1;
+    long count = 0;
+    for (int k = 0; k < f->nchunks; k++) {
+        struct grep_chunk *c = &f->chunks[k];
+
+        pthread_mutex_lock(&pool->lock);
+        while (!c->done) pthread_cond_wait(&pool->done_cv, &pool->lock);
+        pthread_mutex_unlock(&pool->lock);
+
+        for (size_t h = 0; h < c->nhits; h++) {
+            if (opts->with_filename) fprintf(out, "%s:", f->path);
+            if (opts->show_line_numbers)
+                fprintf(out, "%6ld: ", base + c->hits[h].lineno - 1);
+            fwrite(c->hits[h].line, 1, c->hits[h].len, out);
+        }
+        base += c->lines;
+        count += c->count;
+        free(c->hits);
+    }
+    grep_report(opts, f->path, count, out);
+
+    free(f->chunks);
+    munmap(f->map, f->size);
+}
+
+/*
+ * 병렬 검색 함수
+ * 설명: 작업자 jobs개가 파일(또는 큰 파일의 구간)을 동시에 검색하고,
+ *       호출한 스레드는 결과를 인자 순서대로 출력합니다.
+ *       출력 결과는 직렬 실행(grep_path 반복)과 같습니다.
+ * 반환값: 0(성공), -1(스레드 생성 실패)
+ */
+int grep_parallel(const struct grep_pattern *pat, const struct grep_opts *opts,
+                  char *const paths[], int npaths, int jobs, FILE *out) {
+    struct grep_pool pool;
+    pthread_t *threads;
+    int started = 0;
+
+    memset(&pool, 0, sizeof(pool));
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.work_cv, NULL);
+    pthread_cond_init(&pool.done_cv, NULL);
+    pool.pat = pat;
+    pool.opts = opts;
+    pool.nfiles = npaths;
+    pool.nworkers = jobs;
+    pool.files = calloc(npaths, sizeof(struct grep_file_job));
+    threads = calloc(jobs, sizeof(pthread_t));
+    if (pool.files == NULL || threads == NULL) {
+        free(pool.files);
+        free(threads);
+        return -1;
+    }
+    for (int i = 0; i < npaths; i++) pool.files[i].path = paths[i];
+
+    for (int t = 0; t < jobs; t++) {
+        if (pthread_create(&threads[t], NULL, worker_main, &pool) != 0) break;
+        started++;
+    }
+    if (started == 0) {
+        free(pool.files);
+        free(threads);
+        return -1;
+    }
+
+    for (int i = 0; i < npaths; i++) {
+        print_file(&pool, &pool.files[i], out);
+
+        // 출력이 끝났으므로 작업자가 다음 파일을 가져갈 수 있음
+        pthread_mutex_lock(&pool.lock);
+        pool.printed++;
+        pthread_cond_broadcast(&pool.work_cv);
+        pthread_mutex_unlock(&pool.lock);
+    }
+
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+
+    free(pool.queue);
+    free(pool.files);
+    free(threads);
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.work_cv);
+    pthread_cond_destroy(&pool.done_cv);
+    return 0;
+}
@@ -0,0 +1,1603 @@
+/*
+ * grep_regex.c
+ * 설명: my_grep의 정규식 모드 (-G: 기본 정규식 BRE, -E: 확장 정규식 ERE).
+ *
+ *   1) 패턴을 구문 트리로 파싱하고 톰슨 NFA로 컴파일합니다 (역참조는 지원하지 않음).
+ *   2) 매칭은 줄 단위로 NFA 상태 집합을 DFA 상태로 필요할 때만 만들어 캐시하는
+ *      lazy DFA로 합니다. 바이트마다 표 조회 한 번이므로 입력 크기에 선형이고
+ *      백트래킹이 없습니다.
+ *   3) DFA 캐시가 가득 차면 비우고 다시 만들며, 비워도 금방 다시 차면 (상태가 폭발하는
+ *      패턴) 그 스레드는 NFA 집합 시뮬레이션으로 전환합니다 (역시 선형, 상수만 큼).
+ *   4) 모든 매칭에 반드시 들어가는 리터럴 문자열을 구문 트리에서 뽑아 grep_find(SIMD)로
+ *      먼저 찾고, 그 문자열이 있는 줄만 DFA로 확인합니다. 선택(a|b)은 선택지마다 하나씩
+ *      뽑아 여러 문자열 검색기(grep_multi.c)로 찾습니다.
+ *      모든 선택지가 리터럴이면 고정 문자열 검색과 같아집니다 (grep_compile_list에서 처리).
+ *
+ * 컴파일된 정규식은 여러 스레드(grep_parallel)가 같이 읽기만 하고,
+ * DFA 캐시는 스레드마다 따로 둡니다 (pthread 키, 스레드가 끝나면 해제).
+ * 바이트 단위로 매칭합니다 (. 는 한 바이트, 문자 클래스는 C 로캘 기준).
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "grep_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define RX_MAX_REPEAT   1000          // {m,n}의 최대 반복 수
+#define RX_MAX_NFA      (1 << 18)     // NFA 상태 수 한도 (넘으면 "too big")
+#define RX_DFA_STATES   4096          // 스레드별 DFA 캐시의 최대 상태 수
+#define RX_MIN_REUSE    64            // 캐시를 비운 뒤 새 상태 하나당 스캔해야 하는 최소 바이트 수
+
+/* 구문 트리 노드 종류 */
+enum { AST_SET, AST_CAT, AST_ALT, AST_REPEAT, AST_BOL, AST_EOL, AST_EMPTY };
+
+struct rx_node {
+    int type;
+    int left, right;   // CAT/ALT: 두 자식, REPEAT: left만
+    int set;           // SET: 바이트 집합 번호
+    int lit;           // SET: 한 글자(-i 이면 소문자)와 같은 집합이면 그 글자, 아니면 -1
+    int min, max;      // REPEAT: 반복 범위 (max가 -1이면 무한)
+};
+
+/* 256비트 바이트 집합 */
+struct rx_set {
+    uint64_t bits[4];
+};
+
+/* NFA 상태 종류 */
+enum { NFA_SET, NFA_SPLIT, NFA_EPS, NFA_BOL, NFA_EOL, NFA_MATCH };
+
+struct rx_state {
+    int type;
+    int set;           // NFA_SET: 바이트 집합 번호
+    int out, out1;     // 다음 상태 (SPLIT만 out1 사용)
+};
+
+struct grep_regex {
+    unsigned long gen;           // 스레드별 DFA 캐시가 이 정규식의 것인지 확인하는 번호
+    struct rx_state *st;
+    int nstates, start;
+    struct rx_set *sets;
+    int nsets;
+    unsigned char classmap[256]; // 바이트 -> 바이트 클래스 (같은 집합들에 속하는 바이트끼리 묶음)
+    unsigned char class_rep[256];// 클래스 -> 대표 바이트
+    int nclasses;
+    char **exact;                // 모든 선택지가 리터럴이면 그 문자열들 (아니면 NULL)
+    int nexact;
+    struct grep_pattern lit;     // 필수 리터럴 (하나 또는 선택지별 여러 개, 전처리용)
+    int has_lit;
+};
+
+/* ---------------------------------------------------------------------- */
+/* 파서                                                                    */
+/* ---------------------------------------------------------------------- */
+
+struct rx_parser {
+    const unsigned char *s;
+    size_t pos, len;
+    int extended, icase;
+    int depth;                   // 열린 괄호 수
+    struct rx_node *nodes;
+    int nnodes, nodecap;
+    struct rx_set *sets;
+    int nsets, setcap;
+    const char *err;
+};
+
+static void set_add(struct rx_set *set, int c) {
+    set->bits[c >> 6] |= 1ULL << (c & 63);
+}
+
+static int set_has(const struct rx_set *set, int c) {
+    return (set->bits[c >> 6] >> (c & 63)) & 1;
+}
+
+static int new_node(struct rx_parser *p, int type, int left, int right) {
+    if (p->nnodes == p->nodecap) {
+        int cap = p->nodecap ? p->nodecap * 2 : 64;
+        struct rx_node *bigger = realloc(p->nodes, cap * sizeof(*bigger));
+        if (bigger == NULL) {
+            p->err = "memory exhausted";
+            return -1;
+        }
+        p->nodes = bigger;
+        p->nodecap = cap;
+    }
+    struct rx_node *n = &p->nodes[p->nnodes];
+    n->type = type;
+    n->left = left;
+    n->right = right;
+    n->set = -1;
+    n->lit = -1;
+    n->min = n->max = 0;
+    return p->nnodes++;
+}
+
+static int new_set(struct rx_parser *p) {
+    if (p->nsets == p->setcap) {
+        int cap = p->setcap ? p->setcap * 2 : 32;
+        struct rx_set *bigger = realloc(p->sets, cap * sizeof(*bigger));
+        if (bigger == NULL) {
+            p->err = "memory exhausted";
+            return -1;
+        }
+        p->sets = bigger;
+        p->setcap = cap;
+    }
+    memset(&p->sets[p->nsets], 0, sizeof(p->sets[0]));
+    return p->nsets++;
+}
+
+/* -i: 집합의 영문자마다 반대쪽 대소문자도 추가 */
+static void fold_set(struct rx_set *set) {
+    for (int c = 'a'; c <= 'z'; c++) {
+        if (set_has(set, c) || set_has(set, c - 'a' + 'A')) {
+            set_add(set, c);
+            set_add(set, c - 'a' + 'A');
+        }
+    }
+}
+
+/* 바이트 집합 노드 (set이 채워진 뒤 -i 적용) */
+static int set_node(struct rx_parser *p, int set) {
+    int n = new_node(p, AST_SET, -1, -1);
+    if (n < 0) return -1;
+    if (p->icase) fold_set(&p->sets[set]);
+    p->nodes[n].set = set;
+    return n;
+}
+
+/* 한 글자 노드 */
+static int literal_node(struct rx_parser *p, int c) {
+    int set = new_set(p);
+    if (set < 0) return -1;
+    set_add(&p->sets[set], c);
+    int n = set_node(p, set);
+    if (n < 0) return -1;
+    p->nodes[n].lit = p->icase ? tolower(c) : c;
+    return n;
+}
+
+/* 문자 클래스 이름 ([:alpha:] 등) */
+static int class_add(struct rx_set *set, const char *name, size_t len) {
+    static const struct { const char *name; int (*fn)(int); } classes[] = {
+        { "alpha", isalpha }, { "digit", isdigit }, { "alnum", isalnum }, { "upper", isupper },
+        { "lower", islower }, { "space", isspace }, { "blank", isblank }, { "punct", ispunct },
+        { "print", isprint }, { "graph", isgraph }, { "cntrl", iscntrl }, { "xdigit", isxdigit },
+    };
+
+    for (size_t k = 0; k < sizeof(classes) / sizeof(classes[0]); k++) {
+        if (strlen(classes[k].name) == len && memcmp(classes[k].name, name, len) == 0) {
+            for (int c = 0; c < 256; c++)
+                if (classes[k].fn(c)) set_add(set, c);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/*
+ * 대괄호 식 파싱 함수 ([abc], [^a-z], [[:digit:]_])
+ * 설명: POSIX처럼 대괄호 안의 역슬래시는 일반 문자이고, 맨 앞의 ]는 집합의 원소입니다.
+ *       부정 집합은 개행을 포함하지 않습니다.
+ */
+static int parse_bracket(struct rx_parser *p) {
+    int set = new_set(p);
+    int neg = 0, first = 1;
+
+    if (set < 0) return -1;
+    p->pos++; // '['
+    if (p->pos < p->len && p->s[p->pos] == '^') {
+        neg = 1;
+        p->pos++;
+    }
+
+    for (;;) {
+        if (p->pos >= p->len) {
+            p->err = "Unmatched [, [^, [:, [., or [=";
+            return -1;
+        }
+        int c = p->s[p->pos];
+        if (c == ']' && !first) {
+            p->pos++;
+            break;
+        }
+        first = 0;
+
+        if (c == '[' && p->pos + 1 < p->len &&
+            (p->s[p->pos + 1] == ':' || p->s[p->pos + 1] == '=' || p->s[p->pos + 1] == '.')) {
+            int kind = p->s[p->pos + 1];
+            size_t start = p->pos + 2, e = start;
+
+            while (e + 1 < p->len && !(p->s[e] == kind && p->s[e + 1] == ']')) e++;
+            if (e + 1 >= p->len) {
+                p->err = "Unmatched [, [^, [:, [., or [=";
+                return -1;
+            }
+            if (kind == ':') {
+                if (class_add(&p->sets[set], (const char *)p->s + start, e - start) < 0) {
+                    p->err = "Invalid character class name";
+                    return -1;
+                }
+                p->pos = e + 2;
+                continue;
+            }
+            // [=a=] [.a.]: 한 글자만 지원 (C 로캘에는 여러 글자 조합이 없음)
+            if (e - start != 1) {
+                p->err = "Invalid collation character";
+                return -1;
+            }
+            c = p->s[start];
+            p->pos = e + 2;
+        } else {
+            p->pos++;
+        }
+
+        // 범위 (a-z). 끝의 '-'는 일반 문자
+        if (p->pos + 1 < p->len && p->s[p->pos] == '-' && p->s[p->pos + 1] != ']') {
+            int hi = p->s[p->pos + 1];
+            p->pos += 2;
+            if (hi < c) {
+                p->err = "Invalid range end";
+                return -1;
+            }
+            for (int k = c; k <= hi; k++) set_add(&p->sets[set], k);
+        } else {
+            set_add(&p->sets[set], c);
+        }
+    }
+
+    if (p->icase) fold_set(&p->sets[set]);
+    if (neg) {
+        for (int k = 0; k < 4; k++) p->sets[set].bits[k] = ~p->sets[set].bits[k];
+    }
+    p->sets[set].bits['\n' >> 6] &= ~(1ULL << ('\n' & 63));
+    return set_node(p, set);
+}
+
+/* 다음이 선택 연산자인지 (ERE: |, BRE: \|) */
+static int at_alt(const struct rx_parser *p) {
+    if (p->extended) return p->pos < p->len && p->s[p->pos] == '|';
+    return p->pos + 1 < p->len && p->s[p->pos] == '\\' && p->s[p->pos + 1] == '|';
+}
+
+/* 다음이 그룹을 닫는 괄호인지 (ERE: ), BRE: \)). 괄호 밖의 ERE ) 는 일반 문자 */
+static int at_close(const struct rx_parser *p) {
+    if (p->depth == 0) return 0;
+    if (p->extended) return p->pos < p->len && p->s[p->pos] == ')';
+    return p->pos + 1 < p->len && p->s[p->pos] == '\\' && p->s[p->pos + 1] == ')';
+}
+
+static int parse_alt(struct rx_parser *p);
+
+/* 그룹 파싱 (여는 괄호는 이미 읽음) */
+static int parse_group(struct rx_parser *p) {
+    int n;
+
+    p->depth++;
+    n = parse_alt(p);
+    if (n < 0) return -1;
+    if (!at_close(p)) {
+        p->err = "Unmatched ( or \\(";
+        return -1;
+    }
+    p->pos += p->extended ? 1 : 2;
+    p->depth--;
+    return n;
+}
+
+/* 역슬래시 다음 글자 처리 (\w \s 등 GNU 확장 포함) */
+static int parse_escape(struct rx_parser *p) {
+    int c, set;
+
+    if (p->pos + 1 >= p->len) {
+        p->err = "Trailing backslash";
+        return -1;
+    }
+    c = p->s[p->pos + 1];
+    p->pos += 2;
+
+    if (!p->extended) {
+        if (c == '(') return parse_group(p);
+        if (c == ')') {
+            p->err = "Unmatched ) or \\)";
+            return -1;
+        }
+        // 앞에 원자가 있는 \{ 는 parse_repeat_op가 먼저 읽으므로, 여기 오는 것은
+        // 연결의 맨 앞(패턴, \(, \|, ^ 바로 뒤)이고 GNU grep처럼 일반 문자 '{'
+        if (c == '{') return literal_node(p, c);
+    }
+    if (c >= '1' && c <= '9') {
+        p->err = "back-references are not supported";
+        return -1;
+    }
+    if (strchr("bB<>`'", c) != NULL) {
+        p->err = "word boundary and buffer anchors are not supported";
+        return -1;
+    }
+    if (c == 'w' || c == 'W' || c == 's' || c == 'S') {
+        set = new_set(p);
+        if (set < 0) return -1;
+        if (c == 'w' || c == 'W') {
+            class_add(&p->sets[set], "alnum", 5);
+            set_add(&p->sets[set], '_');
+        } else {
+            class_add(&p->sets[set], "space", 5);
+        }
+        if (c == 'W' || c == 'S') {
+            for (int k = 0; k < 4; k++) p->sets[set].bits[k] = ~p->sets[set].bits[k];
+        }
+        p->sets[set].bits['\n' >> 6] &= ~(1ULL << ('\n' & 63));
+        return set_node(p, set);
+    }
+    return literal_node(p, c);
+}
+
+/*
+ * 원자 하나 파싱 (글자, ., [...], 그룹, 앵커)
+ * 설명: start는 연결(concatenation)의 첫 원자인지 여부로,
+ *       그 자리의 *, +, ?, { 는 (GNU grep처럼) 일반 문자로 봅니다.
+ */
+static int parse_atom(struct rx_parser *p, int start) {
+    int c = p->s[p->pos];
+
+    if (c == '[') return parse_bracket(p);
+    if (c == '\\') return parse_escape(p);
+    if (c == '.') {
+        int set = new_set(p);
+        if (set < 0) return -1;
+        p->pos++;
+        for (int k = 0; k < 4; k++) p->sets[set].bits[k] = ~0ULL;
+        p->sets[set].bits['\n' >> 6] &= ~(1ULL << ('\n' & 63));
+        return set_node(p, set);
+    }
+    if (c == '^' && (p->extended || start)) {
+        p->pos++;
+        return new_node(p, AST_BOL, -1, -1);
+    }
+    if (c == '$') {
+        // BRE의 $는 패턴/그룹/선택지의 끝에서만 앵커
+        size_t save = p->pos++;
+        if (p->extended || p->pos == p->len || at_alt(p) || at_close(p))
+            return new_node(p, AST_EOL, -1, -1);
+        p->pos = save;
+    }
+    if (p->extended && c == '(') {
+        p->pos++;
+        return parse_group(p);
+    }
+    p->pos++;
+    return literal_node(p, c);
+}
+
+/* 숫자 읽기 ({m,n} 용), 없으면 -1 */
+static int parse_number(struct rx_parser *p) {
+    int n = -1;
+
+    while (p->pos < p->len && isdigit(p->s[p->pos])) {
+        n = (n < 0 ? 0 : n) * 10 + (p->s[p->pos++] - '0');
+        if (n > RX_MAX_REPEAT) n = RX_MAX_REPEAT + 1;
+    }
+    return n;
+}
+
+/*
+ * 반복 연산자 하나 읽기 (*, +, ?, {m,n}; BRE는 *, \+, \?, \{m,n\})
+ * 반환값: 1(읽음), 0(반복 연산자 아님), -1(오류)
+ */
+static int parse_repeat_op(struct rx_parser *p, int *min, int *max) {
+    size_t save = p->pos;
+    int c, brace;
+
+    if (p->pos >= p->len) return 0;
+    c = p->s[p->pos];
+    if (!p->extended && c == '\\' && p->pos + 1 < p->len &&
+        (p->s[p->pos + 1] == '+' || p->s[p->pos + 1] == '?' || p->s[p->pos + 1] == '{')) {
+        c = p->s[++p->pos];
+    } else if (!p->extended && c != '*') {
+        return 0;
+    }
+
+    switch (c) {
+        case '*': p->pos++; *min = 0; *max = -1; return 1;
+        case '+': p->pos++; *min = 1; *max = -1; return 1;
+        case '?': p->pos++; *min = 0; *max = 1; return 1;
+        case '{': break;
+        default: return 0;
+    }
+
+    p->pos++;
+    *min = parse_number(p);
+    *max = *min;
+    if (p->pos < p->len && p->s[p->pos] == ',') {
+        p->pos++;
+        *max = parse_number(p);
+    }
+    brace = p->extended ? (p->pos < p->len && p->s[p->pos] == '}')
+                        : (p->pos + 1 < p->len && p->s[p->pos] == '\\' && p->s[p->pos + 1] == '}');
+    if (!brace || (*min < 0 && *max < 0)) {
+        // ERE에서 올바른 구간이 아닌 { 는 일반 문자 (GNU grep과 같음)
+        if (p->extended) {
+            p->pos = save;
+            return 0;
+        }
+        p->err = "Unmatched \\{";
+        return -1;
+    }
+    p->pos += p->extended ? 1 : 2;
+    if (*min < 0) *min = 0;
+    if (*min > RX_MAX_REPEAT || *max > RX_MAX_REPEAT) {
+        p->err = "Regular expression too big";
+        return -1;
+    }
+    if (*max >= 0 && *max < *min) {
+        p->err = "Invalid content of \\{\\}";
+        return -1;
+    }
+    return 1;
+}
+
+/* 원자와 그 뒤의 반복 연산자들 */
+static int parse_repeat(struct rx_parser *p, int start) {
+    int n = parse_atom(p, start);
+    int min, max, r;
+
+    // BRE: ^ 앵커에는 반복을 붙이지 않음 (뒤의 * 는 parse_cat에서 일반 문자로 읽힘)
+    if (n >= 0 && !p->extended && p->nodes[n].type == AST_BOL) return n;
+    while (n >= 0 && (r = parse_repeat_op(p, &min, &max)) != 0) {
+        if (r < 0) return -1;
+        int rep = new_node(p, AST_REPEAT, n, -1);
+        if (rep < 0) return -1;
+        p->nodes[rep].min = min;
+        p->nodes[rep].max = max;
+        n = rep;
+    }
+    return n;
+}
+
+/* 연결: 선택 연산자나 닫는 괄호, 패턴 끝까지 */
+static int parse_cat(struct rx_parser *p) {
+    int n = new_node(p, AST_EMPTY, -1, -1);
+    int start = 1;
+
+    while (n >= 0 && p->pos < p->len && !at_alt(p) && !at_close(p)) {
+        int item = parse_repeat(p, start);
+        if (item < 0) return -1;
+        n = (p->nodes[n].type == AST_EMPTY) ? item : new_node(p, AST_CAT, n, item);
+        // BRE: ^ 바로 뒤의 * 도 일반 문자
+        start = !p->extended && p->nodes[item].type == AST_BOL;
+    }
+    return n;
+}
+
+static int parse_alt(struct rx_parser *p) {
+    int n = parse_cat(p);
+
+    while (n >= 0 && at_alt(p)) {
+        p->pos += p->extended ? 1 : 2;
+        int right = parse_cat(p);
+        if (right < 0) return -1;
+        n = new_node(p, AST_ALT, n, right);
+    }
+    return n;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 필수 리터럴 추출                                                         */
+/* ---------------------------------------------------------------------- */
+
+/*
+ * 노드가 매칭하는 모든 문자열에 대한 리터럴 정보
+ *   exact : 항상 정확히 이 문자열 (아니면 NULL)
+ *   prefix/suffix : 모든 매칭이 이 문자열로 시작/끝남
+ *   must : 모든 매칭이 이 문자열을 포함함
+ */
+struct rx_info {
+    char *exact, *prefix, *suffix, *must;
+};
+
+static char *str_dup(const char *s, size_t len) {
+    char *r = malloc(len + 1);
+    if (r == NULL) return NULL;
+    memcpy(r, s, len);
+    r[len] = '\0';
+    return r;
+}
+
+static char *str_cat(const char *a, const char *b) {
+    size_t la = strlen(a), lb = strlen(b);
+    char *r = malloc(la + lb + 1);
+    if (r == NULL) return NULL;
+    memcpy(r, a, la);
+    memcpy(r + la, b, lb + 1);
+    return r;
+}
+
+static void info_free(struct rx_info *in) {
+    free(in->exact);
+    free(in->prefix);
+    free(in->suffix);
+    free(in->must);
+}
+
+/* 가장 긴 것을 복사 (NULL은 빈 문자열로 취급) */
+static char *longest(const char *a, const char *b, const char *c) {
+    const char *best = "";
+    if (a != NULL && strlen(a) > strlen(best)) best = a;
+    if (b != NULL && strlen(b) > strlen(best)) best = b;
+    if (c != NULL && strlen(c) > strlen(best)) best = c;
+    return str_dup(best, strlen(best));
+}
+
+static int info_empty(struct rx_info *in, const char *exact) {
+    in->exact = exact != NULL ? str_dup(exact, strlen(exact)) : NULL;
+    in->prefix = str_dup("", 0);
+    in->suffix = str_dup("", 0);
+    in->must = str_dup("", 0);
+    return (in->prefix && in->suffix && in->must && (exact == NULL || in->exact)) ? 0 : -1;
+}
+
+/* 구문 트리에서 리터럴 정보를 아래에서 위로 계산 */
+static int node_info(const struct rx_node *nodes, int n, struct rx_info *in) {
+    const struct rx_node *node = &nodes[n];
+    struct rx_info a, b;
+
+    memset(in, 0, sizeof(*in));
+    switch (node->type) {
+        case AST_SET:
+            if (node->lit < 0) return info_empty(in, NULL);
+            {
+                char c[2] = { (char)node->lit, '\0' };
+                in->exact = str_dup(c, 1);
+                in->prefix = str_dup(c, 1);
+                in->suffix = str_dup(c, 1);
+                in->must = str_dup(c, 1);
+            }
+            break;
+        case AST_EMPTY:
+            return info_empty(in, "");
+        case AST_BOL:
+        case AST_EOL:
+            return info_empty(in, NULL);
+        case AST_CAT:
+            if (node_info(nodes, node->left, &a) < 0) return -1;
+            if (node_info(nodes, node->right, &b) < 0) {
+                info_free(&a);
+                return -1;
+            }
+            {
+                char *join = str_cat(a.suffix, b.prefix);
+                in->exact = (a.exact && b.exact) ? str_cat(a.exact, b.exact) : NULL;
+                in->prefix = a.exact ? str_cat(a.exact, b.prefix) : str_dup(a.prefix, strlen(a.prefix));
+                in->suffix = b.exact ? str_cat(a.suffix, b.exact) : str_dup(b.suffix, strlen(b.suffix));
+                in->must = (join != NULL) ? longest(a.must, b.must, join) : NULL;
+                free(join);
+            }
+            info_free(&a);
+            info_free(&b);
+            break;
+        case AST_ALT:
+            if (node_info(nodes, node->left, &a) < 0) return -1;
+            if (node_info(nodes, node->right, &b) < 0) {
+                info_free(&a);
+                return -1;
+            }
+            {
+                size_t la = strlen(a.prefix), lb = strlen(b.prefix), k = 0;
+                while (k < la && k < lb && a.prefix[k] == b.prefix[k]) k++;
+                in->prefix = str_dup(a.prefix, k);
+
+                la = strlen(a.suffix);
+                lb = strlen(b.suffix);
+                k = 0;
+                while (k < la && k < lb && a.suffix[la - 1 - k] == b.suffix[lb - 1 - k]) k++;
+                in->suffix = str_dup(a.suffix + la - k, k);
+
+                in->exact = (a.exact && b.exact && strcmp(a.exact, b.exact) == 0)
+                          ? str_dup(a.exact, strlen(a.exact)) : NULL;
+                if (strcmp(a.must, b.must) == 0)
+                    in->must = str_dup(a.must, strlen(a.must));
+                else
+                    in->must = longest(in->prefix, in->suffix, NULL);
+            }
+            info_free(&a);
+            info_free(&b);
+            break;
+        case AST_REPEAT:
+            if (node->min == 0) return info_empty(in, node->max == 0 ? "" : NULL);
+            if (node_info(nodes, node->left, &a) < 0) return -1;
+            *in = a;
+            if (!(node->min == 1 && node->max == 1)) {
+                free(in->exact);
+                in->exact = NULL;
+            }
+            break;
+    }
+    return (in->prefix && in->suffix && in->must) ? 0 : (info_free(in), -1);
+}
+
+/* 문자열 목록 (선택지별 필수 리터럴) */
+struct rx_lits {
+    char **v;
+    int n, cap;
+};
+
+static void lits_free(struct rx_lits *l) {
+    for (int k = 0; k < l->n; k++) free(l->v[k]);
+    free(l->v);
+    l->v = NULL;
+    l->n = l->cap = 0;
+}
+
+/* 문자열 추가 (s의 소유권을 가져감) */
+static int lits_add(struct rx_lits *l, char *s) {
+    if (l->n == l->cap) {
+        int cap = l->cap ? l->cap * 2 : 8;
+        char **bigger = realloc(l->v, cap * sizeof(*bigger));
+        if (bigger == NULL) {
+            free(s);
+            return -1;
+        }
+        l->v = bigger;
+        l->cap = cap;
+    }
+    l->v[l->n++] = s;
+    return 0;
+}
+
+/* 가장 짧은 문자열의 길이 (전처리 후보가 얼마나 드문지의 대략적인 기준) */
+static size_t lits_score(const struct rx_lits *l) {
+    size_t best = 0;
+    for (int k = 0; k < l->n; k++) {
+        size_t len = strlen(l->v[k]);
+        if (k == 0 || len < best) best = len;
+    }
+    return best;
+}
+
+/*
+ * 선택지 펼치기 함수 (a|b|c -> a, b, c)
+ * 설명: -f로 패턴이 수천 개여도 재귀하지 않도록 명시적 스택을 씁니다.
+ * 반환값: 선택지 수, 메모리 부족이면 -1 (*out은 호출자가 해제)
+ */
+static int flatten_alt(const struct rx_node *nodes, int root, int **out) {
+    int cap = 16, n = 0, top = 0;
+    int *stack = malloc(cap * sizeof(int));
+    int *list = malloc(cap * sizeof(int));
+
+    *out = list;
+    if (stack == NULL || list == NULL) {
+        free(stack);
+        return -1;
+    }
+    stack[top++] = root;
+    while (top > 0) {
+        int x = stack[--top];
+        if (n + 2 > cap || top + 2 > cap) {
+            cap *= 2;
+            int *s2 = realloc(stack, cap * sizeof(int)), *l2 = realloc(list, cap * sizeof(int));
+            if (s2 != NULL) stack = s2;
+            if (l2 != NULL) list = l2;
+            *out = list;
+            if (s2 == NULL || l2 == NULL) {
+                free(stack);
+                return -1;
+            }
+        }
+        if (nodes[x].type == AST_ALT) {
+            // 왼쪽 선택지가 먼저 나오도록 오른쪽을 먼저 넣음
+            stack[top++] = nodes[x].right;
+            stack[top++] = nodes[x].left;
+        } else {
+            list[n++] = x;
+        }
+    }
+    free(stack);
+    return n;
+}
+
+/*
+ * 리터럴 집합 계산 함수
+ * 설명: 모든 매칭이 집합의 문자열 중 하나는 반드시 포함하도록 고릅니다.
+ *       노드의 필수 리터럴이 있으면 그것 하나, 없으면 선택은 선택지마다의 집합을 합치고
+ *       (하나라도 없으면 집합 없음), 연결은 양쪽 중 가장 짧은 문자열이 더 긴 쪽을 씁니다.
+ *       예: (panic|segfault)$ -> {panic, segfault}
+ * 반환값: 0(l->n이 0이면 집합 없음), -1(메모리 부족)
+ */
+static int node_lits(const struct rx_node *nodes, int n, struct rx_lits *l) {
+    const struct rx_node *node = &nodes[n];
+    struct rx_info in;
+
+    if (node_info(nodes, n, &in) < 0) return -1;
+    if (in.must[0] != '\0') {
+        int r = lits_add(l, in.must);
+        in.must = NULL;
+        info_free(&in);
+        return r;
+    }
+    info_free(&in);
+
+    if (node->type == AST_REPEAT && node->min > 0) return node_lits(nodes, node->left, l);
+    if (node->type == AST_CAT) {
+        struct rx_lits a = { 0 }, b = { 0 };
+        if (node_lits(nodes, node->left, &a) < 0 || node_lits(nodes, node->right, &b) < 0) {
+            lits_free(&a);
+            lits_free(&b);
+            return -1;
+        }
+        // 더 나은 쪽을 l로 옮김 (점수가 같으면 문자열이 적은 쪽)
+        size_t sa = lits_score(&a), sb = lits_score(&b);
+        if (sb > sa || (sb == sa && b.n > 0 && b.n < a.n)) {
+            *l = b;
+            lits_free(&a);
+        } else {
+            *l = a;
+            lits_free(&b);
+        }
+        return 0;
+    }
+    if (node->type == AST_ALT) {
+        int *alts, nalt = flatten_alt(nodes, n, &alts);
+        if (nalt < 0) {
+            free(alts);
+            return -1;
+        }
+        for (int k = 0; k < nalt; k++) {
+            struct rx_lits b = { 0 };
+            if (node_lits(nodes, alts[k], &b) < 0 || b.n == 0) {
+                int failed = b.n == 0 ? 0 : -1;
+                lits_free(&b);
+                lits_free(l);
+                free(alts);
+                return failed;
+            }
+            for (int j = 0; j < b.n; j++) {
+                if (lits_add(l, b.v[j]) < 0) {
+                    b.v[j] = NULL;
+                    lits_free(&b);
+                    free(alts);
+                    return -1;
+                }
+                b.v[j] = NULL;
+            }
+            free(b.v);
+        }
+        free(alts);
+    }
+    return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* NFA 컴파일                                                               */
+/* ---------------------------------------------------------------------- */
+
+struct rx_compiler {
+    const struct rx_node *nodes;
+    struct rx_state *st;
+    int n, cap;
+    const char *err;
+};
+
+/* 아직 연결되지 않은 출구 목록 (상태 번호 * 2 + out/out1, 출구 자리에 다음 항목을 저장) */
+struct rx_frag {
+    int start, out;
+};
+
+static int *slot(struct rx_compiler *c, int id) {
+    return (id & 1) ? &c->st[id >> 1].out1 : &c->st[id >> 1].out;
+}
+
+static void patch(struct rx_compiler *c, int list, int target) {
+    while (list >= 0) {
+        int *sp = slot(c, list);
+        list = *sp;
+        *sp = target;
+    }
+}
+
+static int append(struct rx_compiler *c, int l1, int l2) {
+    int id = l1;
+    if (l1 < 0) return l2;
+    while (*slot(c, id) >= 0) id = *slot(c, id);
+    *slot(c, id) = l2;
+    return l1;
+}
+
+static int new_state(struct rx_compiler *c, int type, int set) {
+    if (c->n == c->cap) {
+        if (c->cap >= RX_MAX_NFA) {
+            c->err = "Regular expression too big";
+            return -1;
+        }
+        int cap = c->cap ? c->cap * 2 : 64;
+        struct rx_state *bigger = realloc(c->st, cap * sizeof(*bigger));
+        if (bigger == NULL) {
+            c->err = "memory exhausted";
+            return -1;
+        }
+        c->st = bigger;
+        c->cap = cap;
+    }
+    c->st[c->n].type = type;
+    c->st[c->n].set = set;
+    c->st[c->n].out = -1;
+    c->st[c->n].out1 = -1;
+    return c->n++;
+}
+
+static int compile_node(struct rx_compiler *c, int n, struct rx_frag *f);
+
+/* x? : SPLIT -> x, 건너뛰기 */
+static int compile_optional(struct rx_compiler *c, int n, struct rx_frag *f) {
+    struct rx_frag x;
+    if (compile_node(c, n, &x) < 0) return -1;
+    int s = new_state(c, NFA_SPLIT, -1);
+    if (s < 0) return -1;
+    c->st[s].out = x.start;
+    f->start = s;
+    f->out = append(c, x.out, s * 2 + 1);
+    return 0;
+}
+
+/* x* : SPLIT -> x -> SPLIT */
+static int compile_star(struct rx_compiler *c, int n, struct rx_frag *f) {
+    struct rx_frag x;
+    if (compile_node(c, n, &x) < 0) return -1;
+    int s = new_state(c, NFA_SPLIT, -1);
+    if (s < 0) return -1;
+    c->st[s].out = x.start;
+    patch(c, x.out, s);
+    f->start = s;
+    f->out = s * 2 + 1;
+    return 0;
+}
+
+/* 두 조각 연결 (첫 조각이 없으면 두 번째 그대로) */
+static void concat(struct rx_compiler *c, struct rx_frag *f, const struct rx_frag *next, int *have) {
+    if (!*have) {
+        *f = *next;
+        *have = 1;
+        return;
+    }
+    patch(c, f->out, next->start);
+    f->out = next->out;
+}
+
+/*
+ * 구문 트리 노드를 NFA 조각으로 컴파일 (톰슨 구성)
+ * 설명: {m,n}은 x를 m번 잇고 x? 를 n-m번 (무한이면 x* 하나) 더 잇습니다.
+ */
+static int compile_node(struct rx_compiler *c, int n, struct rx_frag *f) {
+    const struct rx_node *node = &c->nodes[n];
+    struct rx_frag a, b;
+    int s, have = 0;
+
+    switch (node->type) {
+        case AST_SET:
+        case AST_EMPTY:
+        case AST_BOL:
+        case AST_EOL:
+            s = new_state(c, node->type == AST_SET ? NFA_SET : node->type == AST_BOL ? NFA_BOL :
+                             node->type == AST_EOL ? NFA_EOL : NFA_EPS, node->set);
+            if (s < 0) return -1;
+            f->start = s;
+            f->out = s * 2;
+            return 0;
+        case AST_CAT:
+            if (compile_node(c, node->left, &a) < 0 || compile_node(c, node->right, &b) < 0) return -1;
+            patch(c, a.out, b.start);
+            f->start = a.start;
+            f->out = b.out;
+            return 0;
+        case AST_ALT:
+            if (compile_node(c, node->left, &a) < 0 || compile_node(c, node->right, &b) < 0) return -1;
+            s = new_state(c, NFA_SPLIT, -1);
+            if (s < 0) return -1;
+            c->st[s].out = a.start;
+            c->st[s].out1 = b.start;
+            f->start = s;
+            f->out = append(c, a.out, b.out);
+            return 0;
+        case AST_REPEAT:
+            for (int k = 0; k < node->min; k++) {
+                if (compile_node(c, node->left, &a) < 0) return -1;
+                concat(c, f, &a, &have);
+            }
+            if (node->max < 0) {
+                if (compile_star(c, node->left, &a) < 0) return -1;
+                concat(c, f, &a, &have);
+            }
+            for (int k = node->min; k < node->max; k++) {
+                if (compile_optional(c, node->left, &a) < 0) return -1;
+                concat(c, f, &a, &have);
+            }
+            if (!have) {
+                // {0,0}: 빈 문자열
+                s = new_state(c, NFA_EPS, -1);
+                if (s < 0) return -1;
+                f->start = s;
+                f->out = s * 2;
+            }
+            return 0;
+    }
+    return -1;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 상태 집합                                                                */
+/* ---------------------------------------------------------------------- */
+
+/* 희소 집합 (초기화 없이 비우기, 삽입 순서 유지) */
+struct sparse {
+    int *dense, *sparse;
+    int n;
+};
+
+static int sparse_init(struct sparse *s, int cap) {
+    s->dense = malloc(cap * sizeof(int));
+    s->sparse = malloc(cap * sizeof(int));
+    s->n = 0;
+    return (s->dense != NULL && s->sparse != NULL) ? 0 : -1;
+}
+
+static void sparse_free(struct sparse *s) {
+    free(s->dense);
+    free(s->sparse);
+}
+
+static int sparse_has(const struct sparse *s, int v) {
+    unsigned k = (unsigned)s->sparse[v];
+    return k < (unsigned)s->n && s->dense[k] == v;
+}
+
+static void sparse_add(struct sparse *s, int v) {
+    s->sparse[v] = s->n;
+    s->dense[s->n++] = v;
+}
+
+/*
+ * ε-closure 함수
+ * 설명: s에서 ε 전이(SPLIT, EPS, 줄 시작이면 BOL)를 따라가며 방문한 상태를 set에 넣습니다.
+ *       EOL은 줄 끝에서만 통과하므로 eol이 0이면 그 자리에 멈춥니다.
+ *       패턴이 길어도 스택이 넘치지 않도록 명시적 스택을 씁니다.
+ */
+static void closure(const struct grep_regex *rx, struct sparse *set, int *stack, int s, int bol, int eol) {
+    int top = 0;
+
+    if (sparse_has(set, s)) return;
+    sparse_add(set, s);
+    stack[top++] = s;
+    while (top > 0) {
+        const struct rx_state *st = &rx->st[stack[--top]];
+        int next[2], nn = 0;
+
+        switch (st->type) {
+            case NFA_SPLIT: next[nn++] = st->out1; next[nn++] = st->out; break;
+            case NFA_EPS: next[nn++] = st->out; break;
+            case NFA_BOL: if (bol) next[nn++] = st->out; break;
+            case NFA_EOL: if (eol) next[nn++] = st->out; break;
+            default: break;
+        }
+        for (int k = 0; k < nn; k++) {
+            if (!sparse_has(set, next[k])) {
+                sparse_add(set, next[k]);
+                stack[top++] = next[k];
+            }
+        }
+    }
+}
+
+/* 소비 상태(바이트를 읽거나, 줄 끝을 기다리거나, 매칭)만 남기고 정렬 */
+static int is_kernel(const struct grep_regex *rx, int s) {
+    int t = rx->st[s].type;
+    return t == NFA_SET || t == NFA_EOL || t == NFA_MATCH;
+}
+
+/* 줄 끝에서 매칭되는지 (EOL 상태를 통과시켜 MATCH에 닿는지) */
+static int accepts_at_eol(const struct grep_regex *rx, const int *list, int n,
+                          struct sparse *tmp, int *stack) {
+    tmp->n = 0;
+    for (int k = 0; k < n; k++) {
+        if (rx->st[list[k]].type == NFA_MATCH) return 1;
+        if (rx->st[list[k]].type == NFA_EOL) closure(rx, tmp, stack, rx->st[list[k]].out, 0, 1);
+    }
+    for (int k = 0; k < tmp->n; k++) {
+        if (rx->st[tmp->dense[k]].type == NFA_MATCH) return 1;
+    }
+    return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 컴파일 / 해제                                                            */
+/* ---------------------------------------------------------------------- */
+
+/* 바이트 클래스 계산: 모든 NFA 집합에 대해 같은 소속인 바이트끼리 묶음 (개행은 따로) */
+static void build_classes(struct grep_regex *rx) {
+    unsigned char map[256] = { 0 };
+    int n = 1;
+
+    for (int s = -1; s < rx->nstates; s++) {
+        int tmp[512], next[256], nn = 0;
+
+        if (s >= 0 && rx->st[s].type != NFA_SET) continue;
+        for (int k = 0; k < 512; k++) tmp[k] = -1;
+        for (int c = 0; c < 256; c++) {
+            int in = (s < 0) ? (c == '\n') : set_has(&rx->sets[rx->st[s].set], c);
+            int key = map[c] * 2 + in;
+            if (tmp[key] < 0) tmp[key] = nn++;
+            next[c] = tmp[key];
+        }
+        for (int c = 0; c < 256; c++) map[c] = (unsigned char)next[c];
+        n = nn;
+    }
+    memcpy(rx->classmap, map, sizeof(map));
+    rx->nclasses = n;
+    for (int c = 255; c >= 0; c--) rx->class_rep[map[c]] = (unsigned char)c;
+}
+
+/*
+ * 리터럴 정보 계산 함수
+ * 설명: 모든 선택지가 리터럴이면 rx->exact에 모으고, 아니면 선택지별 필수 리터럴을
+ *       전처리용 검색기(rx->lit)로 컴파일합니다.
+ * 반환값: 0(성공), -1(메모리 부족)
+ */
+static int extract_literals(struct grep_regex *rx, const struct rx_node *nodes, int root, int ignore_case) {
+    struct rx_lits exact = { 0 }, lits = { 0 };
+    int *alts, nalt = flatten_alt(nodes, root, &alts);
+    int all_exact = 1, status = -1;
+
+    if (nalt < 0) goto out;
+    for (int k = 0; k < nalt; k++) {
+        struct rx_info in;
+        struct rx_lits b = { 0 };
+
+        if (node_info(nodes, alts[k], &in) < 0) goto out;
+        if (all_exact && in.exact != NULL) {
+            if (lits_add(&exact, in.exact) < 0) {
+                in.exact = NULL;
+                info_free(&in);
+                goto out;
+            }
+            in.exact = NULL;
+        } else {
+            all_exact = 0;
+        }
+        info_free(&in);
+
+        if (lits.n < 0 || !all_exact) {
+            // 선택지마다 필수 리터럴이 하나 이상 있어야 전처리 가능 (없으면 lits.n = -1로 표시)
+            if (lits.n >= 0 && node_lits(nodes, alts[k], &b) < 0) goto out;
+            if (lits.n >= 0 && b.n == 0) {
+                lits_free(&lits);
+                lits.n = -1;
+            }
+            for (int j = 0; lits.n >= 0 && j < b.n; j++) {
+                if (lits_add(&lits, b.v[j]) < 0) {
+                    b.v[j] = NULL;
+                    lits_free(&b);
+                    goto out;
+                }
+                b.v[j] = NULL;
+            }
+            lits_free(&b);
+        } else if (lits.n >= 0) {
+            // 지금까지는 리터럴 선택지이므로 그 문자열 자체가 필수 리터럴
+            char *dup = str_dup(exact.v[exact.n - 1], strlen(exact.v[exact.n - 1]));
+            if (dup == NULL || lits_add(&lits, dup) < 0) goto out;
+        }
+    }
+
+    if (all_exact) {
+        rx->exact = exact.v;
+        rx->nexact = exact.n;
+        exact.v = NULL;
+        exact.n = 0;
+        status = 0;
+        goto out;
+    }
+
+    // 빈 문자열이나 공백 한 바이트처럼 거의 모든 줄에 있는 리터럴은 후보만 늘리므로 쓰지 않음
+    for (int k = 0; k < lits.n; k++) {
+        if (lits.v[k][0] == '\0' || (lits.v[k][1] == '\0' && isspace((unsigned char)lits.v[k][0]))) {
+            lits_free(&lits);
+            break;
+        }
+    }
+    status = 0;
+    if (lits.n > 0) {
+        status = grep_compile_list(&rx->lit, lits.v, lits.n, ignore_case, GREP_FIXED);
+        rx->has_lit = (status == 0);
+    }
+
+out:
+    free(alts);
+    lits_free(&exact);
+    if (lits.n < 0) lits.n = 0;
+    lits_free(&lits);
+    return status;
+}
+
+/*
+ * 정규식 컴파일 함수
+ * 설명: 패턴이 여러 개면 (-e, -f) 각각 파싱한 뒤 선택(|)으로 묶습니다.
+ *       문법 오류는 GNU grep과 같은 문구로 출력합니다.
+ * 반환값: 컴파일된 정규식, 실패하면 NULL (오류 메시지 출력됨)
+ */
+struct grep_regex *grep_regex_compile(char *const patterns[], int n, int ignore_case, int extended) {
+    static unsigned long next_gen = 0;
+    struct rx_parser p = { 0 };
+    struct rx_compiler c = { 0 };
+    struct grep_regex *rx = NULL;
+    struct rx_frag f;
+    int root = -1, match = -1;
+
+    p.extended = extended;
+    p.icase = ignore_case;
+
+    for (int k = 0; k < n; k++) {
+        int r;
+
+        p.s = (const unsigned char *)patterns[k];
+        p.len = strlen(patterns[k]);
+        p.pos = 0;
+        p.depth = 0;
+        r = parse_alt(&p);
+        if (r < 0) goto fail;
+        root = (k == 0) ? r : new_node(&p, AST_ALT, root, r);
+        if (root < 0) goto fail;
+    }
+
+    c.nodes = p.nodes;
+    if (compile_node(&c, root, &f) < 0 || (match = new_state(&c, NFA_MATCH, -1)) < 0) {
+        p.err = c.err;
+        goto fail;
+    }
+    patch(&c, f.out, match);
+
+    rx = calloc(1, sizeof(*rx));
+    if (rx == NULL) {
+        p.err = "memory exhausted";
+        goto fail;
+    }
+    rx->gen = __atomic_add_fetch(&next_gen, 1, __ATOMIC_RELAXED);
+    rx->st = c.st;
+    rx->nstates = c.n;
+    rx->start = f.start;
+    rx->sets = p.sets;
+    rx->nsets = p.nsets;
+    c.st = NULL;
+    p.sets = NULL;
+    build_classes(rx);
+
+    if (extract_literals(rx, p.nodes, root, ignore_case) < 0) {
+        p.err = "memory exhausted";
+        goto fail;
+    }
+    free(p.nodes);
+    return rx;
+
+fail:
+    fprintf(stderr, "%sgrep: %s%s\n", COLOR_RED, p.err != NULL ? p.err : "memory exhausted", COLOR_RESET);
+    free(p.nodes);
+    free(p.sets);
+    free(c.st);
+    grep_regex_free(rx);
+    errno = EINVAL;
+    return NULL;
+}
+
+/* 모든 선택지가 리터럴이면 그 문자열들 (-i 이면 소문자), 아니면 NULL */
+char *const *grep_regex_exact(const struct grep_regex *rx, int *n) {
+    *n = rx->nexact;
+    return rx->exact;
+}
+
+/* 선택지별 필수 리터럴의 고정 문자열 검색기 (리터럴을 뽑지 못했으면 NULL) */
+const struct grep_pattern *grep_regex_prefilter(const struct grep_regex *rx) {
+    return rx->has_lit ? &rx->lit : NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 스레드별 lazy DFA                                                        */
+/* ---------------------------------------------------------------------- */
+
+#define RX_ACCEPT      1   // MATCH 포함: 줄이 매칭됨
+#define RX_EOL_ACCEPT  2   // 줄이 여기서 끝나면 매칭됨 ($)
+#define RX_DEAD        4   // 빈 집합: 이 줄은 더 볼 필요 없음 (^로 고정된 패턴)
+
+#define RX_UNKNOWN     (-1) // 아직 만들지 않은 전이 (개행 클래스는 항상 이 값)
+
+struct rx_dstate {
+    size_t off;        // pool 안의 NFA 상태 목록 위치
+    int n;
+    unsigned hash;
+    int flags;
+};
+
+struct rx_dfa {
+    unsigned long gen;
+    const struct grep_regex *rx;
+    struct rx_dstate *states;
+    int nstates;
+    int *trans;                  // nstates * nclasses, 다음 상태의 행 위치 (id * nclasses)
+                                 // 음수는 느린 경로: RX_UNKNOWN, -(id+2)는 매칭/빈 상태
+    int *table;                  // 해시 -> 상태 번호 (열린 주소법)
+    int tcap;
+    int *pool;                   // 상태들의 NFA 목록
+    size_t pool_used, pool_cap;
+    struct sparse work, tmp;
+    int *stack, *list;
+    int start;                   // 줄 시작 상태
+    int empty_match;             // 빈 줄이 매칭됨 (^와 $를 같은 위치에서 모두 통과, 예: $^)
+    size_t scanned;              // 마지막으로 캐시를 비운 뒤 스캔한 바이트 수
+    int use_nfa;                 // 상태 폭발: NFA 시뮬레이션으로 전환됨
+};
+
+static void dfa_free(void *arg) {
+    struct rx_dfa *d = arg;
+    if (d == NULL) return;
+    free(d->states);
+    free(d->trans);
+    free(d->table);
+    free(d->pool);
+    sparse_free(&d->work);
+    sparse_free(&d->tmp);
+    free(d->stack);
+    free(d->list);
+    free(d);
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * DFA 상태 찾기/추가 함수
+ * 설명: d->work의 소비 상태들을 정렬한 목록을 키로 캐시에서 찾고, 없으면 추가합니다.
+ * 반환값: 상태 번호, 캐시가 가득 찼으면 -1
+ */
+static int dfa_intern(struct rx_dfa *d) {
+    const struct grep_regex *rx = d->rx;
+    unsigned h = 2166136261u;
+    int n = 0;
+
+    for (int k = 0; k < d->work.n; k++) {
+        if (is_kernel(rx, d->work.dense[k])) d->list[n++] = d->work.dense[k];
+    }
+    qsort(d->list, n, sizeof(int), cmp_int);
+    for (int k = 0; k < n; k++) h = (h ^ (unsigned)d->list[k]) * 16777619u;
+
+    unsigned mask = d->tcap - 1;
+    for (unsigned i = h & mask;; i = (i + 1) & mask) {
+        int id = d->table[i];
+        if (id < 0) {
+            if (d->nstates == RX_DFA_STATES) return -1;
+            if (d->pool_used + n > d->pool_cap) {
+                size_t cap = (d->pool_cap + n) * 2;
+                int *bigger = realloc(d->pool, cap * sizeof(int));
+                if (bigger == NULL) return -1;
+                d->pool = bigger;
+                d->pool_cap = cap;
+            }
+            id = d->nstates++;
+            struct rx_dstate *ds = &d->states[id];
+            ds->off = d->pool_used;
+            ds->n = n;
+            ds->hash = h;
+            memcpy(d->pool + d->pool_used, d->list, n * sizeof(int));
+            d->pool_used += n;
+
+            ds->flags = 0;
+            for (int k = 0; k < n; k++) {
+                if (rx->st[d->list[k]].type == NFA_MATCH) ds->flags |= RX_ACCEPT;
+            }
+            if (accepts_at_eol(rx, d->list, n, &d->tmp, d->stack)) ds->flags |= RX_EOL_ACCEPT;
+            if (n == 0) ds->flags |= RX_DEAD;
+            for (int k = 0; k < rx->nclasses; k++) d->trans[id * rx->nclasses + k] = RX_UNKNOWN;
+            d->table[i] = id;
+            return id;
+        }
+        struct rx_dstate *ds = &d->states[id];
+        if (ds->hash == h && ds->n == n && memcmp(d->pool + ds->off, d->list, n * sizeof(int)) == 0)
+            return id;
+    }
+}
+
+/* 캐시 비우기 (줄 시작 상태만 다시 만듦) */
+static void dfa_reset(struct rx_dfa *d) {
+    for (int k = 0; k < d->tcap; k++) d->table[k] = -1;
+    d->nstates = 0;
+    d->pool_used = 0;
+    d->work.n = 0;
+    closure(d->rx, &d->work, d->stack, d->rx->start, 1, 0);
+    d->start = dfa_intern(d);
+    d->scanned = 0;
+}
+
+static struct rx_dfa *dfa_new(const struct grep_regex *rx) {
+    struct rx_dfa *d = calloc(1, sizeof(*d));
+
+    if (d == NULL) return NULL;
+    d->gen = rx->gen;
+    d->rx = rx;
+    d->tcap = RX_DFA_STATES * 2;
+    d->states = malloc(RX_DFA_STATES * sizeof(*d->states));
+    d->trans = malloc((size_t)RX_DFA_STATES * rx->nclasses * sizeof(int));
+    d->table = malloc(d->tcap * sizeof(int));
+    d->stack = malloc(rx->nstates * sizeof(int));
+    d->list = malloc(rx->nstates * sizeof(int));
+    if (d->states == NULL || d->trans == NULL || d->table == NULL || d->stack == NULL ||
+        d->list == NULL || sparse_init(&d->work, rx->nstates) < 0 || sparse_init(&d->tmp, rx->nstates) < 0) {
+        dfa_free(d);
+        return NULL;
+    }
+    closure(rx, &d->work, d->stack, rx->start, 1, 1);
+    for (int k = 0; k < d->work.n; k++) {
+        if (rx->st[d->work.dense[k]].type == NFA_MATCH) d->empty_match = 1;
+    }
+    dfa_reset(d);
+    return d;
+}
+
+/*
+ * DFA 전이 계산 함수
+ * 설명: 상태 s의 NFA 상태들을 클래스 cls의 대표 바이트로 옮기고, 모든 위치에서
+ *       매칭이 새로 시작될 수 있도록 시작 상태의 closure를 더합니다.
+ *       캐시가 가득 차면 비운 뒤 다시 넣으며, 비운 뒤 스캔한 양이 너무 적으면
+ *       (상태 폭발) NFA 시뮬레이션으로 전환합니다.
+ * 반환값: 다음 상태 번호, NFA로 전환했으면 -1
+ */
+static int dfa_next(struct rx_dfa *d, int s, int cls) {
+    const struct grep_regex *rx = d->rx;
+    int b = rx->class_rep[cls];
+    const struct rx_dstate *ds = &d->states[s];
+    int t;
+
+    d->work.n = 0;
+    for (int k = 0; k < ds->n; k++) {
+        const struct rx_state *st = &rx->st[d->pool[ds->off + k]];
+        if (st->type == NFA_SET && set_has(&rx->sets[st->set], b))
+            closure(rx, &d->work, d->stack, st->out, 0, 0);
+    }
+    closure(rx, &d->work, d->stack, rx->start, 0, 0);
+
+    t = dfa_intern(d);
+    if (t < 0) {
+        if (d->scanned < (size_t)RX_DFA_STATES * RX_MIN_REUSE) {
+            d->use_nfa = 1;
+            return -1;
+        }
+        // work는 dfa_reset이 덮어쓰므로 다시 계산
+        int *copy = malloc(d->work.n * sizeof(int)), n = d->work.n;
+        if (copy == NULL) {
+            d->use_nfa = 1;
+            return -1;
+        }
+        memcpy(copy, d->work.dense, n * sizeof(int));
+        dfa_reset(d);
+        d->work.n = 0;
+        for (int k = 0; k < n; k++) sparse_add(&d->work, copy[k]);
+        free(copy);
+        t = dfa_intern(d);
+        if (t < 0) {
+            d->use_nfa = 1;
+            return -1;
+        }
+        return t;
+    }
+    // 느린 경로로 보낼 상태는 음수로 저장 (바이트마다 플래그를 읽지 않도록)
+    d->trans[s * rx->nclasses + cls] = (d->states[t].flags & (RX_ACCEPT | RX_DEAD)) ? -(t + 2) : t * rx->nclasses;
+    return t;
+}
+
+/* ---------------------------------------------------------------------- */
+/* 스캔                                                                    */
+/* ---------------------------------------------------------------------- */
+
+static int line_found(const unsigned char *ls, const unsigned char *p, const unsigned char *end,
+                      const char **out_ls, const char **out_le) {
+    const unsigned char *nl = memchr(p, '\n', end - p);
+    *out_ls = (const char *)ls;
+    *out_le = (const char *)(nl != NULL ? nl + 1 : end);
+    return 1;
+}
+
+/*
+ * NFA 시뮬레이션 함수 (상태 폭발 시 사용)
+ * 설명: 현재 NFA 상태 집합을 바이트마다 옮깁니다. 시간은 입력 크기 * NFA 크기로 선형입니다.
+ * 반환값: 1(매칭된 줄을 찾음), 0(없음)
+ */
+static int nfa_scan(struct rx_dfa *d, const unsigned char *p, const unsigned char *end,
+                    const char **out_ls, const char **out_le) {
+    const struct grep_regex *rx = d->rx;
+    struct sparse *cur = &d->work, *next = &d->tmp;
+    const unsigned char *ls = p;
+    int n;
+
+    while (ls < end) {
+        const unsigned char *nl = memchr(ls, '\n', end - ls);
+        const unsigned char *le = (nl != NULL) ? nl : end;
+
+        cur->n = 0;
+        closure(rx, cur, d->stack, rx->start, 1, 0);
+        for (p = ls;; p++) {
+            n = 0;
+            for (int k = 0; k < cur->n; k++) {
+                if (is_kernel(rx, cur->dense[k])) d->list[n++] = cur->dense[k];
+            }
+            if (p == le) {
+                // accepts_at_eol이 next를 쓰므로 목록은 list에 복사해 둠
+                if ((p == ls && d->empty_match) || accepts_at_eol(rx, d->list, n, next, d->stack))
+                    return line_found(ls, p, end, out_ls, out_le);
+                break;
+            }
+            for (int k = 0; k < n; k++) {
+                if (rx->st[d->list[k]].type == NFA_MATCH) return line_found(ls, p, end, out_ls, out_le);
+            }
+            next->n = 0;
+            for (int k = 0; k < n; k++) {
+                const struct rx_state *st = &rx->st[d->list[k]];
+                if (st->type == NFA_SET && set_has(&rx->sets[st->set], *p))
+                    closure(rx, next, d->stack, st->out, 0, 0);
+            }
+            closure(rx, next, d->stack, rx->start, 0, 0);
+            struct sparse *t = cur;
+            cur = next;
+            next = t;
+        }
+        ls = le + 1;
+    }
+    return 0;
+}
+
+/*
+ * DFA 스캔 함수
+ * 설명: [p, end)를 한 바이트씩 DFA로 읽으며, 개행에서 $ 매칭을 확인하고 상태를 줄 시작으로
+ *       되돌립니다. 빠른 경로는 표 조회 하나와 부호 검사 하나이고 (상태는 행 위치로 들고 다녀
+ *       곱셈도 없음), 개행/새 전이/매칭/빈 상태는 모두 음수 값으로 느린 경로에 보냅니다.
+ * 반환값: 1(매칭된 줄 [ls, le)를 찾음), 0(없음)
+ */
+static int dfa_scan(struct rx_dfa *d, const unsigned char *p, const unsigned char *end,
+                    const char **out_ls, const char **out_le) {
+    const struct grep_regex *rx = d->rx;
+    const unsigned char *map = rx->classmap;
+    const unsigned char *ls = p, *begin = p;
+    const int *trans = d->trans;
+    int nc = rx->nclasses;
+    int s = d->start, row = s * nc, t = 0;
+    int found = 0;
+
+    if (d->use_nfa) return nfa_scan(d, p, end, out_ls, out_le);
+    if (p < end && (d->states[s].flags & RX_ACCEPT)) return line_found(ls, p, end, out_ls, out_le);
+
+    while (p < end) {
+        while (p < end && (t = trans[row + map[*p]]) >= 0) {
+            row = t;
+            p++;
+        }
+        if (p == end) break;
+        s = row / nc;
+
+        if (*p == '\n') {
+            if ((d->states[s].flags & RX_EOL_ACCEPT) || (p == ls && d->empty_match)) {
+                found = line_found(ls, p, end, out_ls, out_le);
+                break;
+            }
+            ls = ++p;
+            s = d->start;
+            row = s * nc;
+            if (p < end && (d->states[s].flags & RX_ACCEPT)) {
+                found = line_found(ls, p, end, out_ls, out_le);
+                break;
+            }
+            continue;
+        }
+        if (t == RX_UNKNOWN) {
+            d->scanned += p - begin;
+            begin = p;
+            t = dfa_next(d, s, map[*p]);
+            if (t < 0) return nfa_scan(d, ls, end, out_ls, out_le);
+        } else {
+            t = -t - 2;
+        }
+        s = t;
+        row = s * nc;
+        if (d->states[s].flags & RX_ACCEPT) {
+            found = line_found(ls, p, end, out_ls, out_le);
+            break;
+        }
+        p++;
+        if (d->states[s].flags & RX_DEAD) {
+            // ^로 고정된 패턴이 이 줄에서 실패: 다음 줄로
+            const unsigned char *nl = memchr(p, '\n', end - p);
+            p = (nl != NULL) ? nl : end;
+        }
+    }
+    d->scanned += p - begin;
+    s = row / nc;
+    // 개행 없이 끝나는 마지막 줄
+    if (!found && p == end && ls < end && (d->states[s].flags & RX_EOL_ACCEPT))
+        found = line_found(ls, end, end, out_ls, out_le);
+    return found;
+}
+
+static pthread_key_t dfa_key;
+static pthread_once_t dfa_once = PTHREAD_ONCE_INIT;
+
+static void dfa_key_init(void) {
+    pthread_key_create(&dfa_key, dfa_free);
+}
+
+/* 이 스레드의 DFA 캐시 (다른 정규식의 것이면 새로 만듦) */
+static struct rx_dfa *dfa_get(const struct grep_regex *rx) {
+    struct rx_dfa *d;
+
+    pthread_once(&dfa_once, dfa_key_init);
+    d = pthread_getspecific(dfa_key);
+    if (d != NULL && d->gen == rx->gen) return d;
+    dfa_free(d);
+    d = dfa_new(rx);
+    pthread_setspecific(dfa_key, d);
+    return d;
+}
+
+/*
+ * 줄 찾기 함수
+ * 설명: 필수 리터럴이 있으면 grep_find로 후보 위치를 찾고 그 줄만 DFA로 확인합니다.
+ *       리터럴이 없으면 버퍼 전체를 DFA로 한 번에 스캔합니다.
+ *       p는 줄의 시작이어야 합니다.
+ * 반환값: 1(매칭된 줄 [ls, le)를 찾음), 0(없음)
+ */
+int grep_regex_find_line(const struct grep_regex *rx, const char *p, const char *end,
+                         const char **ls, const char **le) {
+    struct rx_dfa *d = dfa_get(rx);
+
+    if (d == NULL) {
+        fprintf(stderr, "%sgrep: memory exhausted%s\n", COLOR_RED, COLOR_RESET);
+        return 0;
+    }
+    if (!rx->has_lit)
+        return dfa_scan(d, (const unsigned char *)p, (const unsigned char *)end, ls, le);
+
+    while (p < end) {
+        const char *m = grep_find(&rx->lit, p, end - p);
+        const char *s, *e;
+
+        if (m == NULL) return 0;
+        s = memrchr(p, '\n', m - p);
+        s = (s != NULL) ? s + 1 : p;
+        e = memchr(m, '\n', end - m);
+        e = (e != NULL) ? e + 1 : end;
+        if (dfa_scan(d, (const unsigned char *)s, (const unsigned char *)e, ls, le)) return 1;
+        p = e;
+    }
+    return 0;
+}
+
+void grep_regex_free(struct grep_regex *rx) {
+    struct rx_dfa *d;
+
+    if (rx == NULL) return;
+    // 이 스레드의 캐시가 이 정규식의 것이면 같이 해제 (쉘에서 grep을 여러 번 실행할 때)
+    pthread_once(&dfa_once, dfa_key_init);
+    d = pthread_getspecific(dfa_key);
+    if (d != NULL && d->gen == rx->gen) {
+        dfa_free(d);
+        pthread_setspecific(dfa_key, NULL);
+    }
+    if (rx->has_lit) grep_free(&rx->lit);
+    for (int k = 0; k < rx->nexact; k++) free(rx->exact[k]);
+    free(rx->exact);
+    free(rx->st);
+    free(rx->sets);
+    free(rx);
+}
@@ -0,0 +1,387 @@
+/*
+ * grep_walk.c
+ * 설명: -r 디렉토리 순회
+ *
+ *   - 스레드마다 디렉토리 작업 덱을 두고, 자기 덱은 뒤에서 꺼내 깊이 우선으로 돌다가
+ *     (열린 fd가 적고 같은 하위 트리를 이어서 읽음) 비면 다른 스레드 덱의 앞에서
+ *     (얕은 디렉토리 = 큰 하위 트리) 훔쳐 옵니다. 잠금은 덱마다 따로라 경쟁이 적습니다.
+ *   - 디렉토리는 부모 fd 기준 openat으로 열고 getdents64로 읽으며, d_type으로 파일과
+ *     디렉토리를 구분해 항목마다 stat하지 않습니다 (d_type이 없는 파일 시스템에서만 fstatat).
+ *     부모 fd는 하위 디렉토리가 모두 열릴 때까지만 열어 둡니다.
+ *   - 심볼릭 링크는 따라가지 않습니다 (GNU grep -r과 같음, 인자로 준 디렉토리만 따라감).
+ *   - 찾은 파일은 스레드별로 모았다가 경로 순으로 정렬해 돌려주므로, 스레드 수와 관계없이
+ *     결과 순서가 같습니다.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+#include "grep_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define WALK_DENTS_SIZE  (64 * 1024)   // getdents64 한 번에 읽을 버퍼 크기 (스레드마다)
+
+/*
+ * 읽을 디렉토리 하나
+ * 설명: pending은 "자신의 탐색 + 아직 열지 않은 하위 디렉토리 수"이며,
+ *       0이 되면 더 이상 이 fd로 openat 할 일이 없으므로 닫고 해제합니다.
+ */
+struct walk_dir {
+    struct walk_dir *parent;   // openat 기준 (열고 나면 필요 없음)
+    char *path;                // 출력용 경로 (최상위가 ""이면 현재 디렉토리 기준 상대 경로)
+    const char *name;          // 부모 기준 이름 (path 안을 가리킴)
+    int fd;
+    atomic_int pending;
+};
+
+/* 작업 덱: 주인은 뒤(tail)에서, 다른 스레드는 앞(head)에서 꺼냄 */
+struct walk_deque {
+    pthread_mutex_t lock;
+    struct walk_dir **v;
+    size_t head, tail, cap;
+};
+
+struct walk_ctx;
+
+struct walk_worker {
+    struct walk_ctx *ctx;
+    int id;
+    struct walk_deque dq;
+    char **files;              // 이 스레드가 찾은 파일
+    size_t nfiles, cap;
+};
+
+struct walk_ctx {
+    const struct grep_walk_filter *flt;
+    struct walk_worker *workers;
+    int nworkers;
+    atomic_long active;        // 덱에 있거나 읽고 있는 디렉토리 수
+    atomic_int idle;           // 일을 기다리는 스레드 수
+    atomic_int nomem;
+    pthread_mutex_t lock;      // idle 대기와 종료 알림용
+    pthread_cond_t cv;
+    int done;
+};
+
+/* 경로 잇기 (prefix가 비어 있으면 name만) */
+static char *join_path(const char *prefix, const char *name) {
+    size_t a = strlen(prefix), b = strlen(name);
+    int slash = (a > 0 && prefix[a - 1] != '/');
+    char *s = malloc(a + slash + b + 1);
+
+    if (s == NULL) return NULL;
+    memcpy(s, prefix, a);
+    if (slash) s[a] = '/';
+    memcpy(s + a + slash, name, b + 1);
+    return s;
+}
+
+static int match_any(char *const globs[], int n, const char *name) {
+    for (int k = 0; k < n; k++)
+        if (fnmatch(globs[k], name, 0) == 0) return 1;
+    return 0;
+}
+
+/* --include/--exclude: 이 이름의 파일을 검색할지 */
+static int want_file(const struct grep_walk_filter *flt, const char *name) {
+    if (flt == NULL) return 1;
+    if (flt->ninclude > 0 && !match_any(flt->include, flt->ninclude, name)) return 0;
+    return !match_any(flt->exclude, flt->nexclude, name);
+}
+
+static void dir_release(struct walk_dir *d) {
+    if (atomic_fetch_sub(&d->pending, 1) != 1) return;
+    if (d->fd >= 0) close(d->fd);
+    free(d->path);
+    free(d);
+}
+
+static int deque_push(struct walk_deque *dq, struct walk_dir *d) {
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail == dq->cap) {
+        if (dq->head > 0) {
+            // 앞에서 훔쳐 간 자리를 재사용
+            memmove(dq->v, dq->v + dq->head, (dq->tail - dq->head) * sizeof(*dq->v));
+            dq->tail -= dq->head;
+            dq->head = 0;
+        } else {
+            size_t cap = dq->cap ? dq->cap * 2 : 64;
+            struct walk_dir **bigger = realloc(dq->v, cap * sizeof(*bigger));
+            if (bigger == NULL) {
+                pthread_mutex_unlock(&dq->lock);
+                return -1;
+            }
+            dq->v = bigger;
+            dq->cap = cap;
+        }
+    }
+    dq->v[dq->tail++] = d;
+    pthread_mutex_unlock(&dq->lock);
+    return 0;
+}
+
+/* from_front: 다른 스레드가 훔칠 때 (가장 먼저 넣은 얕은 디렉토리) */
+static struct walk_dir *deque_take(struct walk_deque *dq, int from_front) {
+    struct walk_dir *d = NULL;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail > dq->head) {
+        d = from_front ? dq->v[dq->head++] : dq->v[--dq->tail];
+        if (dq->head == dq->tail) dq->head = dq->tail = 0;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return d;
+}
+
+static int deque_empty(struct walk_deque *dq) {
+    pthread_mutex_lock(&dq->lock);
+    int empty = (dq->tail == dq->head);
+    pthread_mutex_unlock(&dq->lock);
+    return empty;
+}
+
+/* 하위 디렉토리를 자기 덱에 넣고, 기다리는 스레드가 있으면 깨움 */
+static void push_dir(struct walk_worker *w, struct walk_dir *d) {
+    struct walk_ctx *ctx = w->ctx;
+
+    atomic_fetch_add(&ctx->active, 1);
+    if (deque_push(&w->dq, d) < 0) {
+        atomic_store(&ctx->nomem, 1);
+        atomic_fetch_sub(&ctx->active, 1);
+        dir_release(d->parent);
+        free(d->path);
+        free(d);
+        return;
+    }
+    // 덱에 넣은 뒤 idle을 읽어야, 잠들기 직전 덱을 확인한 스레드를 놓치지 않음
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&ctx->idle) > 0) {
+        pthread_mutex_lock(&ctx->lock);
+        pthread_cond_signal(&ctx->cv);
+        pthread_mutex_unlock(&ctx->lock);
+    }
+}
+
+static void add_file(struct walk_worker *w, char *path) {
+    if (w->nfiles == w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 256;
+        char **bigger = realloc(w->files, cap * sizeof(*bigger));
+        if (bigger == NULL) {
+            atomic_store(&w->ctx->nomem, 1);
+            free(path);
+            return;
+        }
+        w->files = bigger;
+        w->cap = cap;
+    }
+    w->files[w->nfiles++] = path;
+}
+
+/*
+ * 디렉토리 하나 읽기
+ * 설명: 파일은 이름 거르기를 통과하면 목록에 넣고, 하위 디렉토리는 자기 덱에 넣습니다.
+ */
+static void scan_dir(struct walk_worker *w, struct walk_dir *d, char *buf) {
+    const struct grep_walk_filter *flt = w->ctx->flt;
+    int parent_fd = d->parent != NULL ? d->parent->fd : AT_FDCWD;
+    int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (d->parent != NULL ? O_NOFOLLOW : 0);
+
+    d->fd = openat(parent_fd, d->name, flags);
+    if (d->parent != NULL) dir_release(d->parent);
+    d->parent = NULL;
+    if (d->fd < 0) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, d->path[0] ? d->path : ".", strerror(errno), COLOR_RESET);
+        dir_release(d);
+        return;
+    }
+
+    for (;;) {
+        ssize_t n = getdents64(d->fd, buf, WALK_DENTS_SIZE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0)
+            fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, d->path[0] ? d->path : ".", strerror(errno), COLOR_RESET);
+        if (n <= 0) break;
+
+        for (ssize_t off = 0; off < n; ) {
+            struct dirent64 *e = (struct dirent64 *)(buf + off);
+            const char *name = e->d_name;
+            unsigned char type = e->d_type;
+
+            off += e->d_reclen;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+            if (type == DT_UNKNOWN) {
+                struct stat sb;
+                if (fstatat(d->fd, name, &sb, AT_SYMLINK_NOFOLLOW) < 0) continue;
+                type = S_ISDIR(sb.st_mode) ? DT_DIR : S_ISREG(sb.st_mode) ? DT_REG : DT_LNK;
+            }
+
+            if (type == DT_DIR) {
+                if (flt != NULL && match_any(flt->exclude_dir, flt->nexclude_dir, name)) continue;
+                struct walk_dir *c = calloc(1, sizeof(*c));
+                char *path = join_path(d->path, name);
+                if (c == NULL || path == NULL) {
+                    free(c);
+                    free(path);
+                    atomic_store(&w->ctx->nomem, 1);
+                    continue;
+                }
+                c->parent = d;
+                c->path = path;
+                c->name = path + strlen(path) - strlen(name);
+                c->fd = -1;
+                atomic_init(&c->pending, 1);
+                atomic_fetch_add(&d->pending, 1);
+                push_dir(w, c);
+            } else if (type == DT_REG && want_file(flt, name)) {
+                char *path = join_path(d->path, name);
+                if (path == NULL) atomic_store(&w->ctx->nomem, 1);
+                else add_file(w, path);
+            }
+        }
+    }
+    dir_release(d);
+}
+
+/* 다른 스레드의 덱에서 훔치기 (자기 다음 스레드부터 차례로) */
+static struct walk_dir *steal(struct walk_worker *w) {
+    struct walk_ctx *ctx = w->ctx;
+
+    for (int k = 1; k < ctx->nworkers; k++) {
+        struct walk_dir *d = deque_take(&ctx->workers[(w->id + k) % ctx->nworkers].dq, 1);
+        if (d != NULL) return d;
+    }
+    return NULL;
+}
+
+static int any_work(struct walk_ctx *ctx) {
+    for (int k = 0; k < ctx->nworkers; k++)
+        if (!deque_empty(&ctx->workers[k].dq)) return 1;
+    return 0;
+}
+
+/* 순회 스레드: 모든 디렉토리를 다 읽을 때까지 자기 덱, 없으면 훔친 디렉토리를 읽음 */
+static void *walk_worker_main(void *arg) {
+    struct walk_worker *w = arg;
+    struct walk_ctx *ctx = w->ctx;
+    char *buf = malloc(WALK_DENTS_SIZE);
+
+    if (buf == NULL) return NULL;   // 다른 스레드(최소한 호출한 스레드)가 계속 처리
+    for (;;) {
+        struct walk_dir *d = deque_take(&w->dq, 0);
+        if (d == NULL) d = steal(w);
+        if (d != NULL) {
+            scan_dir(w, d, buf);
+            if (atomic_fetch_sub(&ctx->active, 1) == 1) {
+                pthread_mutex_lock(&ctx->lock);
+                ctx->done = 1;
+                pthread_cond_broadcast(&ctx->cv);
+                pthread_mutex_unlock(&ctx->lock);
+            }
+            continue;
+        }
+
+        pthread_mutex_lock(&ctx->lock);
+        atomic_fetch_add(&ctx->idle, 1);
+        while (!ctx->done && !any_work(ctx))
+            pthread_cond_wait(&ctx->cv, &ctx->lock);
+        atomic_fetch_sub(&ctx->idle, 1);
+        int done = ctx->done;
+        pthread_mutex_unlock(&ctx->lock);
+        if (done) break;
+    }
+    free(buf);
+    return NULL;
+}
+
+static int cmp_path(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/*
+ * 디렉토리 트리 순회 함수 (-r)
+ * 설명: root 아래의 일반 파일 중 이름 거르기를 통과한 것을 경로 순으로 돌려줍니다
+ *       (*paths와 각 경로는 호출자가 해제). root가 ""이면 현재 디렉토리를 돌며
+ *       경로 앞에 "./"를 붙이지 않습니다. 읽을 수 없는 디렉토리는 오류를 출력하고 건너뜁니다.
+ * 반환값: 0(성공), -1(메모리 부족, 오류 메시지 출력됨)
+ */
+int grep_walk(const char *root, const struct grep_walk_filter *flt, int jobs,
+              char ***paths, size_t *npaths) {
+    struct walk_ctx ctx;
+    struct walk_dir *top = calloc(1, sizeof(*top));
+    pthread_t *tids;
+    int started = 0, status = 0;
+    size_t total = 0;
+
+    *paths = NULL;
+    *npaths = 0;
+    if (jobs < 1) jobs = 1;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.workers = calloc(jobs, sizeof(*ctx.workers));
+    tids = malloc(jobs * sizeof(*tids));
+    if (top == NULL || ctx.workers == NULL || tids == NULL || (top->path = strdup(root)) == NULL) {
+        fprintf(stderr, "%sgrep: %s%s\n", COLOR_RED, strerror(ENOMEM), COLOR_RESET);
+        free(top);
+        free(ctx.workers);
+        free(tids);
+        return -1;
+    }
+    top->name = root[0] != '\0' ? top->path : ".";
+    top->fd = -1;
+    atomic_init(&top->pending, 1);
+
+    ctx.flt = flt;
+    ctx.nworkers = jobs;
+    atomic_init(&ctx.active, 1);
+    atomic_init(&ctx.idle, 0);
+    atomic_init(&ctx.nomem, 0);
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cv, NULL);
+    for (int k = 0; k < jobs; k++) {
+        ctx.workers[k].ctx = &ctx;
+        ctx.workers[k].id = k;
+        pthread_mutex_init(&ctx.workers[k].dq.lock, NULL);
+    }
+    deque_push(&ctx.workers[0].dq, top);
+
+    for (int k = 1; k < jobs; k++)
+        if (pthread_create(&tids[started], NULL, walk_worker_main, &ctx.workers[k]) == 0) started++;
+    walk_worker_main(&ctx.workers[0]);
+    for (int k = 0; k < started; k++) pthread_join(tids[k], NULL);
+
+    // 스레드별 목록을 모아 경로 순으로 정렬
+    for (int k = 0; k < jobs; k++) total += ctx.workers[k].nfiles;
+    *paths = malloc((total ? total : 1) * sizeof(char *));
+    if (*paths == NULL) atomic_store(&ctx.nomem, 1);
+    for (int k = 0; k < jobs; k++) {
+        struct walk_worker *w = &ctx.workers[k];
+        for (size_t j = 0; j < w->nfiles; j++) {
+            if (*paths != NULL) (*paths)[(*npaths)++] = w->files[j];
+            else free(w->files[j]);
+        }
+        free(w->files);
+        free(w->dq.v);
+        pthread_mutex_destroy(&w->dq.lock);
+    }
+    if (*paths != NULL) qsort(*paths, *npaths, sizeof(char *), cmp_path);
+
+    if (atomic_load(&ctx.nomem)) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, root[0] ? root : ".", strerror(ENOMEM), COLOR_RESET);
+        status = -1;
+    }
+    pthread_mutex_destroy(&ctx.lock);
+    pthread_cond_destroy(&ctx.cv);
+    free(ctx.workers);
+    free(tids);
+    return status;
+}
@@ -0,0 +1,527 @@
+/* jobs.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "jobs.h"
+
+#define REAP_RING_SIZE 256   // SIGCHLD 핸들러가 채우는 링 버퍼 크기 (2의 거듭제곱)
+
+/*
+ * 회수 이벤트 링 버퍼 (단일 생산자: SIGCHLD 핸들러, 단일 소비자: 메인 루프)
+ * 핸들러는 빈 칸이 있을 때만 wait4를 호출하므로, 링이 가득 차면 나머지 자식은
+ * 좀비로 남아 있다가 jobs_reap이 링을 비운 뒤 다시 회수합니다.
+ */
+struct reap_event {
+    pid_t pid;
+    int status;
+    struct rusage ru;
+    struct timespec when;     // 회수 시각 (clock_gettime은 async-signal-safe)
+};
+
+static struct reap_event ring[REAP_RING_SIZE];
+static atomic_uint ring_head;                   // 핸들러가 다음에 쓸 위치
+static atomic_uint ring_tail;                   // 메인 루프가 다음에 읽을 위치
+static volatile sig_atomic_t ring_full;         // 링이 가득 차서 회수를 멈췄는지
+
+/* 작업 표 */
+static struct job **jobs;
+static int njobs;
+static int jobs_cap;
+static struct job *current_job;                 // %+ 작업 (가장 최근에 만들어지거나 정지됨)
+
+static void (*done_hook)(const struct job *job); // 끝난 작업을 표에서 지우기 전에 호출
+
+static int job_control;                         // 프로세스 그룹/터미널 제어 사용 여부
+static pid_t shell_pgid;
+
+/* 빈 칸이 있는 동안 종료/정지/재개된 자식을 회수하여 링에 넣음 */
+static void reap_into_ring(void) {
+    for (;;) {
+        unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+        unsigned tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+
+        if (head - tail == REAP_RING_SIZE) {
+            ring_full = 1;
+            return;
+        }
+
+        struct reap_event *ev = &ring[head % REAP_RING_SIZE];
+        pid_t pid = wait4(-1, &ev->status, WNOHANG | WUNTRACED | WCONTINUED, &ev->ru);
+        if (pid <= 0) return;
+
+        ev->pid = pid;
+        clock_gettime(CLOCK_MONOTONIC, &ev->when);
+        atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+    }
+}
+
+/* SIGCHLD 핸들러: wait4와 원자적 연산만 사용 (async-signal-safe) */
+static void handle_sigchld(int signo) {
+    int saved_errno = errno;
+    (void)signo;
+    reap_into_ring();
+    errno = saved_errno;
+}
+
+/*
+ * 작업 제어 초기화 함수
+ * 설명: SIGCHLD 핸들러를 설치합니다. job_control이면 쉘을 자신의 프로세스 그룹에 두고
+ *       터미널의 전경 그룹으로 만들며, 작업 제어 시그널(SIGTSTP, SIGTTIN, SIGTTOU)은
+ *       쉘에서 무시합니다.
+ */
+void jobs_init(int use_job_control) {
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_sigchld;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGCHLD, &sa, NULL);
+
+    job_control = use_job_control;
+    if (!job_control) return;
+
+    // 쉘이 배경에서 실행되었다면 전경이 될 때까지 대기
+    while (tcgetpgrp(STDIN_FILENO) != (shell_pgid = getpgrp()))
+        kill(-shell_pgid, SIGTTIN);
+
+    signal(SIGTSTP, SIG_IGN);
+    signal(SIGTTIN, SIG_IGN);
+    signal(SIGTTOU, SIG_IGN);
+
+    if (getpid() != shell_pgid && setpgid(0, 0) == 0) shell_pgid = getpid();
+    tcsetpgrp(STDIN_FILENO, shell_pgid);
+}
+
+int jobs_job_control(void) {
+    return job_control;
+}
+
+/*
+ * 작업 생성 함수
+ * 설명: 번호는 사용 중인 가장 큰 번호 + 1 입니다.
+ * 반환값: 새 작업, 메모리 부족이면 NULL
+ */
+struct job *job_create(const char *cmd, int bg) {
+    struct job *job = calloc(1, sizeof(*job));
+    int id = 0;
+
+    if (job == NULL) return NULL;
+    if (njobs == jobs_cap) {
+        int cap = jobs_cap ? jobs_cap * 2 : 16;
+        struct job **grown = realloc(jobs, sizeof(*jobs) * cap);
+        if (grown == NULL) {
+            free(job);
+            return NULL;
+        }
+        jobs = grown;
+        jobs_cap = cap;
+    }
+
+    job->cmd = strdup(cmd != NULL ? cmd : "");
+    if (job->cmd == NULL) {
+        free(job);
+        return NULL;
+    }
+    for (int k = 0; k < njobs; k++)
+        if (jobs[k]->id > id) id = jobs[k]->id;
+    job->id = id + 1;
+    job->state = JOB_RUNNING;
+    job->bg = bg;
+    jobs[njobs++] = job;
+    if (bg) current_job = job;
+    return job;
+}
+
+/*
+ * 다음 프로세스가 들어갈 프로세스 그룹
+ * 반환값: -1(작업 제어 없음), 0(첫 프로세스: 자신의 pid로 새 그룹), 그 외 작업의 그룹
+ */
+pid_t job_next_pgid(const struct job *job) {
+    if (!job_control) return -1;
+    return job->pgid;
+}
+
+/*
+ * 작업에 프로세스 추가
+ * 설명: 자식과 부모 양쪽에서 setpgid를 호출하여 exec 전후의 경쟁을 없앱니다.
+ *       (자식이 이미 exec 했으면 EACCES로 실패하지만 그룹은 이미 설정되어 있음)
+ *       start는 launch 직전에 잰 시각입니다. 빨리 끝난 자식은 등록 전에 SIGCHLD
+ *       핸들러가 회수할 수 있으므로, 등록 시각을 쓰면 종료 시각보다 늦어질 수 있습니다.
+ * 반환값: 0(성공), -1(메모리 부족)
+ */
+int job_add_proc(struct job *job, pid_t pid, const char *cmd, const struct timespec *start) {
+    if (job->nprocs == job->cap) {
+        int cap = job->cap ? job->cap * 2 : 4;
+        struct job_proc *grown = realloc(job->procs, sizeof(*grown) * cap);
+        if (grown == NULL) return -1;
+        job->procs = grown;
+        job->cap = cap;
+    }
+
+    job->procs[job->nprocs].cmd = NULL;
+    return job_reuse_proc(job, job->nprocs++, pid, cmd, start);
+}
+
+/*
+ * 끝난 프로세스 자리에 새 프로세스 등록
+ * 설명: parallel처럼 한 작업에서 수많은 자식을 차례로 실행할 때 끝난 자리(JOB_DONE)를
+ *       다시 써서, procs 배열과 회수 이벤트마다 하는 검색을 동시 실행 수만큼으로 묶어 둡니다.
+ * 반환값: 0
+ */
+int job_reuse_proc(struct job *job, int i, pid_t pid, const char *cmd,
+                   const struct timespec *start) {
+    struct job_proc *p = &job->procs[i];
+
+    if (job_control && job->pgid >= 0) {
+        if (job->pgid == 0) job->pgid = pid;
+        setpgid(pid, job->pgid);
+    }
+
+    free(p->cmd);
+    memset(p, 0, sizeof(*p));
+    p->pid = pid;
+    p->state = JOB_RUNNING;
+    p->cmd = strdup(cmd != NULL ? cmd : "");
+    p->start = *start;
+    job->state = JOB_RUNNING;
+    return 0;
+}
+
+/*
+ * 완료 훅 등록 함수
+ * 설명: 끝난 작업이 표에서 제거되기 직전에 호출됩니다 (자원 사용량 기록용).
+ */
+void jobs_set_done_hook(void (*hook)(const struct job *job)) {
+    done_hook = hook;
+}
+
+/* 작업 표에서 제거하고 메모리 해제 */
+void job_remove(struct job *job) {
+    if (job->state == JOB_DONE && done_hook != NULL) done_hook(job);
+
+    for (int k = 0; k < njobs; k++) {
+        if (jobs[k] != job) continue;
+        memmove(&jobs[k], &jobs[k + 1], sizeof(*jobs) * (njobs - k - 1));
+        njobs--;
+        break;
+    }
+    if (current_job == job) {
+        current_job = NULL;
+        // 가장 최근의 배경/정지 작업을 새 현재 작업으로
+        for (int k = njobs - 1; k >= 0 && current_job == NULL; k--)
+            if (jobs[k]->bg || jobs[k]->state == JOB_STOPPED) current_job = jobs[k];
+    }
+    for (int k = 0; k < job->nprocs; k++) free(job->procs[k].cmd);
+    free(job->procs);
+    free(job->cmd);
+    free(job);
+}
+
+/* 프로세스 상태로부터 작업 전체 상태 다시 계산 */
+static void job_update_state(struct job *job) {
+    int running = 0, stopped = 0;
+
+    for (int k = 0; k < job->nprocs; k++) {
+        if (job->procs[k].state == JOB_RUNNING) running++;
+        else if (job->procs[k].state == JOB_STOPPED) stopped++;
+    }
+
+    int state = running ? JOB_RUNNING : (stopped ? JOB_STOPPED : JOB_DONE);
+    if (state != job->state) {
+        job->state = state;
+        job->notified = 0;
+        if (state == JOB_STOPPED) current_job = job;
+    }
+}
+
+/* 회수 이벤트 하나를 해당 작업의 프로세스에 반영 */
+static void apply_event(const struct reap_event *ev) {
+    for (int k = 0; k < njobs; k++) {
+        struct job *job = jobs[k];
+        for (int i = 0; i < job->nprocs; i++) {
+            struct job_proc *p = &job->procs[i];
+            // 이미 끝난 자리는 건너뜀 (pid가 재사용되면 살아 있는 쪽에 반영되어야 함)
+            if (p->pid != ev->pid || p->state == JOB_DONE) continue;
+
+            if (WIFSTOPPED(ev->status)) {
+                p->state = JOB_STOPPED;
+                p->status = ev->status;
+            } else if (WIFCONTINUED(ev->status)) {
+                p->state = JOB_RUNNING;
+            } else {
+                p->state = JOB_DONE;
+                p->status = ev->status;
+                p->ru = ev->ru;
+                p->end = ev->when;
+            }
+            job_update_state(job);
+            return;
+        }
+    }
+}
+
+/*
+ * 회수 이벤트 처리 함수
+ * 설명: SIGCHLD 핸들러가 링에 넣은 이벤트를 작업 표에 반영합니다.
+ *       링이 가득 차서 회수가 멈췄다면 SIGCHLD를 막은 상태에서 직접 이어서 회수합니다.
+ */
+void jobs_reap(void) {
+    for (;;) {
+        unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&ring_head, memory_order_acquire);
+
+        while (tail != head) {
+            apply_event(&ring[tail % REAP_RING_SIZE]);
+            tail++;
+            atomic_store_explicit(&ring_tail, tail, memory_order_release);
+        }
+
+        if (!ring_full) return;
+
+        sigset_t block, old;
+        sigemptyset(&block);
+        sigaddset(&block, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &block, &old);
+        ring_full = 0;
+        reap_into_ring();
+        sigprocmask(SIG_SETMASK, &old, NULL);
+    }
+}
+
+/*
+ * 자식 상태 변화 대기 함수
+ * 설명: 아직 반영하지 않은 회수 이벤트가 없으면 SIGCHLD가 올 때까지 sigsuspend로
+ *       잠든 뒤 이벤트를 작업 표에 반영합니다. 여러 자식을 동시에 기다리는 쪽이
+ *       폴링 없이 "아무 자식이나 끝날 때까지" 기다릴 때 사용합니다.
+ */
+void jobs_wait_event(void) {
+    sigset_t block, old;
+
+    sigemptyset(&block);
+    sigaddset(&block, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &block, &old);
+    if (atomic_load_explicit(&ring_head, memory_order_acquire) ==
+            atomic_load_explicit(&ring_tail, memory_order_relaxed) && !ring_full)
+        sigsuspend(&old);
+    sigprocmask(SIG_SETMASK, &old, NULL);
+    jobs_reap();
+}
+
+/*
+ * 작업 대기 함수
+ * 설명: 작업이 끝나거나 정지할 때까지 sigsuspend로 잠듭니다. fg이면 그동안
+ *       터미널을 작업의 프로세스 그룹에 넘기고, 끝나면 쉘이 다시 가져옵니다.
+ * 반환값: 마지막 프로세스의 원시 wait 상태 (정지했으면 정지한 프로세스의 상태)
+ */
+int job_wait(struct job *job, int fg) {
+    sigset_t block, old;
+
+    if (fg && job_control && job->pgid > 0) tcsetpgrp(STDIN_FILENO, job->pgid);
+
+    sigemptyset(&block);
+    sigaddset(&block, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &block, &old);
+    for (;;) {
+        jobs_reap();
+        if (job->state != JOB_RUNNING) break;
+        sigsuspend(&old);
+    }
+    sigprocmask(SIG_SETMASK, &old, NULL);
+
+    if (fg && job_control) tcsetpgrp(STDIN_FILENO, shell_pgid);
+
+    if (job->state == JOB_STOPPED) {
+        for (int k = 0; k < job->nprocs; k++)
+            if (job->procs[k].state == JOB_STOPPED) return job->procs[k].status;
+    }
+    return job->nprocs > 0 ? job->procs[job->nprocs - 1].status : 0;
+}
+
+/*
+ * 정지된(또는 배경) 작업 재개 함수 (fg, bg)
+ * 설명: 프로세스 그룹 전체에 SIGCONT를 보냅니다. fg이면 끝날 때까지 기다립니다.
+ * 반환값: fg이면 job_wait의 상태, bg이면 0
+ */
+int job_continue(struct job *job, int fg) {
+    for (int k = 0; k < job->nprocs; k++)
+        if (job->procs[k].state == JOB_STOPPED) job->procs[k].state = JOB_RUNNING;
+    job->state = JOB_RUNNING;
+    job->bg = !fg;
+
+    if (fg && job_control && job->pgid > 0) tcsetpgrp(STDIN_FILENO, job->pgid);
+    if (job->pgid > 0) {
+        kill(-job->pgid, SIGCONT);
+    } else {
+        for (int k = 0; k < job->nprocs; k++)
+            if (job->procs[k].state != JOB_DONE) kill(job->procs[k].pid, SIGCONT);
+    }
+    if (!fg) return 0;
+    return job_wait(job, 1);
+}
+
+struct job *job_current(void) {
+    return current_job;
+}
+
+/*
+ * 작업 지정자 해석 함수
+ * 설명: %N, N (작업 번호), %+, %% (현재 작업), 또는 작업에 속한 pid
+ * 반환값: 작업, 없으면 NULL
+ */
+struct job *job_find(const char *spec) {
+    if (spec == NULL || strcmp(spec, "%+") == 0 || strcmp(spec, "%%") == 0 ||
+        strcmp(spec, "%") == 0)
+        return current_job;
+
+    if (spec[0] == '%') {
+        int id = atoi(spec + 1);
+        for (int k = 0; k < njobs; k++)
+            if (jobs[k]->id == id) return jobs[k];
+        return NULL;
+    }
+
+    pid_t pid = (pid_t)atol(spec);
+    for (int k = 0; k < njobs; k++) {
+        for (int i = 0; i < jobs[k]->nprocs; i++)
+            if (jobs[k]->procs[i].pid == pid) return jobs[k];
+    }
+    return NULL;
+}
+
+/*
+ * 모든 실행 중인 작업 대기 (wait)
+ * 반환값: 마지막으로 기다린 작업의 원시 상태
+ */
+int jobs_wait_all(void) {
+    int status = 0;
+
+    jobs_reap();
+    for (int k = 0; k < njobs; ) {
+        struct job *job = jobs[k];
+        if (job->state == JOB_STOPPED) {
+            k++;
+            continue;
+        }
+        status = job_wait(job, 0);
+        job_remove(job);
+    }
+    return status;
+}
+
+/* 작업 상태 문자열 ("Running", "Done", "Exit 1", "Killed" ...) */
+static const char *state_text(const struct job *job, char *buf, size_t size) {
+    if (job->state == JOB_RUNNING) return "Running";
+    if (job->state == JOB_STOPPED) return "Stopped";
+
+    int status = job->nprocs > 0 ? job->procs[job->nprocs - 1].status : 0;
+    if (WIFSIGNALED(status)) {
+        snprintf(buf, size, "%s", strsignal(WTERMSIG(status)));
+    } else if (WEXITSTATUS(status) != 0) {
+        snprintf(buf, size, "Exit %d", WEXITSTATUS(status));
+    } else {
+        return "Done";
+    }
+    return buf;
+}
+
+static void print_job(FILE *out, const struct job *job) {
+    char buf[64];
+    fprintf(out, "[%d]%c  %-22s %s%s\n", job->id, job == current_job ? '+' : ' ',
+            state_text(job, buf, sizeof(buf)), job->cmd, job->bg && job->state == JOB_RUNNING ? " &" : "");
+}
+
+/*
+ * 배경 작업 알림 함수 (대화형 모드에서 프롬프트 출력 전에 호출)
+ * 설명: 끝난 배경 작업은 알린 뒤 표에서 제거하고, 정지한 작업은 한 번만 알립니다.
+ */
+void jobs_notify(FILE *out) {
+    jobs_reap();
+    for (int k = 0; k < njobs; ) {
+        struct job *job = jobs[k];
+        if (!job->notified && job->state != JOB_RUNNING) {
+            print_job(out, job);
+            job->notified = 1;
+        }
+        if (job->state == JOB_DONE && job->notified) {
+            job_remove(job);
+            continue;
+        }
+        k++;
+    }
+}
+
+/* 아직 회수되지 않은 좀비 프로세스 수 (/proc/PID/stat의 상태가 Z) */
+static int count_zombies(void) {
+    int zombies = 0;
+
+    for (int k = 0; k < njobs; k++) {
+        for (int i = 0; i < jobs[k]->nprocs; i++) {
+            char path[64], buf[256];
+            FILE *fp;
+
+            if (jobs[k]->procs[i].state == JOB_DONE) continue;
+            snprintf(path, sizeof(path), "/proc/%d/stat", (int)jobs[k]->procs[i].pid);
+            fp = fopen(path, "re");
+            if (fp == NULL) continue;
+            if (fgets(buf, sizeof(buf), fp) != NULL) {
+                char *paren = strrchr(buf, ')');   // 명령어 이름에 공백이 있어도 안전
+                if (paren != NULL && paren[1] == ' ' && paren[2] == 'Z') zombies++;
+            }
+            fclose(fp);
+        }
+    }
+    return zombies;
+}
+
+static double tv_sec(struct timeval tv) {
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/*
+ * 작업 목록 출력 함수 (jobs, jobs -l)
+ * 설명: verbose이면 프로세스별 pid와 종료 시 자원 사용량(user/sys 시간, 최대 RSS),
+ *       그리고 좀비/미보고 작업 수를 함께 출력합니다.
+ *       출력한 뒤 끝난 작업은 보고된 것으로 보고 표에서 제거합니다.
+ */
+void jobs_print(FILE *out, int verbose) {
+    int unreported = 0;
+
+    jobs_reap();
+    for (int k = 0; k < njobs; k++) {
+        struct job *job = jobs[k];
+        if (job->state == JOB_DONE && !job->notified) unreported++;
+        print_job(out, job);
+        if (!verbose) continue;
+
+        for (int i = 0; i < job->nprocs; i++) {
+            const struct job_proc *p = &job->procs[i];
+            if (p->state != JOB_DONE) {
+                fprintf(out, "      %-8d %s\n", (int)p->pid,
+                        p->state == JOB_STOPPED ? "stopped" : "running");
+                continue;
+            }
+            fprintf(out, "      %-8d exited  user %.3fs sys %.3fs maxrss %ldKB\n",
+                    (int)p->pid, tv_sec(p->ru.ru_utime), tv_sec(p->ru.ru_stime), p->ru.ru_maxrss);
+        }
+    }
+    if (verbose)
+        fprintf(out, "zombies: %d, finished but unreported: %d\n", count_zombies(), unreported);
+
+    for (int k = 0; k < njobs; ) {
+        if (jobs[k]->state == JOB_DONE) {
+            job_remove(jobs[k]);
+            continue;
+        }
+        jobs[k]->notified = 1;
+        k++;
+    }
+}
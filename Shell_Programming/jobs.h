@@ -0,0 +1,63 @@
+/* jobs.h */
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <time.h>
+
+/* 작업(또는 프로세스) 상태 */
+enum job_state {
+    JOB_RUNNING,
+    JOB_STOPPED,
+    JOB_DONE
+};
+
+/* 작업에 속한 프로세스 하나 (파이프라인의 한 단계) */
+struct job_proc {
+    pid_t pid;
+    int state;            // enum job_state
+    int status;           // wait4가 돌려준 원시 상태
+    struct rusage ru;     // 종료 시 wait4가 돌려준 자원 사용량
+    struct timespec start;  // 실행 시각 (CLOCK_MONOTONIC)
+    struct timespec end;    // 회수 시각 (SIGCHLD 핸들러에서 기록)
+    char *cmd;            // 이 단계의 명령어 문자열
+};
+
+/* 작업: 하나의 프로세스 그룹으로 실행된 파이프라인 */
+struct job {
+    int id;               // [1], [2], ...
+    pid_t pgid;           // 프로세스 그룹 (작업 제어가 꺼져 있으면 0, -1이면 쉘의 그룹에서 실행)
+    int state;            // enum job_state
+    int bg;               // 백그라운드 작업 여부
+    int notified;         // 종료/정지를 사용자에게 알렸는지 여부
+    int nprocs;
+    int cap;
+    struct job_proc *procs;
+    char *cmd;            // 표시용 명령어 문자열
+};
+
+void jobs_init(int job_control);
+int jobs_job_control(void);
+
+struct job *job_create(const char *cmd, int bg);
+pid_t job_next_pgid(const struct job *job);
+int job_add_proc(struct job *job, pid_t pid, const char *cmd, const struct timespec *start);
+int job_reuse_proc(struct job *job, int i, pid_t pid, const char *cmd,
+                   const struct timespec *start);
+void job_remove(struct job *job);
+void jobs_set_done_hook(void (*hook)(const struct job *job));
+
+void jobs_reap(void);
+void jobs_wait_event(void);
+int job_wait(struct job *job, int fg);
+int job_continue(struct job *job, int fg);
+struct job *job_find(const char *spec);
+struct job *job_current(void);
+int jobs_wait_all(void);
+
+void jobs_notify(FILE *out);
+void jobs_print(FILE *out, int verbose);
+
+#endif
@@ -0,0 +1,372 @@
+/* launch.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <dirent.h>
+#include <sys/mman.h>
+
+#include "launch.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+extern char **environ;
+
+/*
+ * 기본 실행 방식 선택
+ * 설명: MYSHELL_LAUNCHER=fork 이면 fork, 그 외에는 posix_spawn을 사용합니다.
+ */
+int launch_default_mode(void) {
+    const char *mode = getenv("MYSHELL_LAUNCHER");
+
+    if (mode != NULL && strcmp(mode, "fork") == 0) return LAUNCH_FORK;
+    return LAUNCH_SPAWN;
+}
+
+/* 재지향 종류별 open 플래그 (파일을 여는 종류만) */
+static int redir_flags(int type) {
+    switch (type) {
+        case REDIR_IN:     return O_RDONLY;
+        case REDIR_OUT:    return O_WRONLY | O_CREAT | O_TRUNC;
+        case REDIR_APPEND: return O_WRONLY | O_CREAT | O_APPEND;
+        default:           return -1;
+    }
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/*
+ * here 문서 fd 생성
+ * 설명: 내용을 memfd(메모리 파일)에 쓰고 처음으로 되감아 돌려줍니다.
+ *       memfd를 쓸 수 없으면 파이프 버퍼에 들어가는 크기까지만 파이프로 전달합니다.
+ *       임시 파일은 만들지 않으며, 모든 fd는 O_CLOEXEC입니다.
+ */
+static int heredoc_fd(const char *body, size_t len) {
+    int fd = memfd_create("heredoc", MFD_CLOEXEC);
+
+    if (fd >= 0) {
+        if (write_all(fd, body, len) < 0 || lseek(fd, 0, SEEK_SET) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    int pfd[2];
+    if (pipe2(pfd, O_CLOEXEC) < 0) return -1;
+    if (len > (size_t)fcntl(pfd[1], F_GETPIPE_SZ) &&
+        fcntl(pfd[1], F_SETPIPE_SZ, (int)len) < 0) {
+        close(pfd[0]);
+        close(pfd[1]);
+        errno = EFBIG;
+        return -1;
+    }
+    if (write_all(pfd[1], body, len) < 0) {
+        close(pfd[0]);
+        close(pfd[1]);
+        return -1;
+    }
+    close(pfd[1]);
+    return pfd[0];
+}
+
+/*
+ * 재지향 준비 함수 (부모에서 실행 전에 호출)
+ * 설명: here 문서와 here 문자열의 내용을 fd로 만들어 src_fd에 저장합니다.
+ *       자식을 실행한 뒤에는 redir_release로 부모 쪽 fd를 닫습니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int redir_prepare(struct redir *redirs, int n) {
+    for (int k = 0; k < n; k++) {
+        struct redir *r = &redirs[k];
+        if (r->type != REDIR_HEREDOC && r->type != REDIR_HERESTR) continue;
+
+        r->src_fd = heredoc_fd(r->target, r->len);
+        if (r->src_fd < 0) {
+            perror("here-document failed");
+            redir_release(redirs, k);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void redir_release(struct redir *redirs, int n) {
+    for (int k = 0; k < n; k++) {
+        struct redir *r = &redirs[k];
+        if ((r->type == REDIR_HEREDOC || r->type == REDIR_HERESTR) && r->src_fd >= 0) {
+            close(r->src_fd);
+            r->src_fd = -1;
+        }
+    }
+}
+
+/* 재지향 하나 적용 */
+static int apply_one(const struct redir *r) {
+    int fd;
+
+    if (r->type == REDIR_DUP || r->type == REDIR_HEREDOC || r->type == REDIR_HERESTR) {
+        if (r->src_fd < 0) {
+            close(r->fd); // n>&-
+            return 0;
+        }
+        if (r->src_fd == r->fd) {
+            fcntl(r->fd, F_SETFD, 0);
+            return 0;
+        }
+        if (dup2(r->src_fd, r->fd) < 0) {
+            fprintf(stderr, "%s%d: %s%s\n", COLOR_RED, r->src_fd, strerror(errno), COLOR_RESET);
+            return -1;
+        }
+        return 0;
+    }
+
+    fd = open(r->target, redir_flags(r->type) | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(r->type == REDIR_IN ? "open input file failed" : "open output file failed");
+        return -1;
+    }
+    if (fd != r->fd) {
+        dup2(fd, r->fd);
+        close(fd);
+    } else {
+        // 같은 번호로 열렸으면 exec 후에도 남도록 O_CLOEXEC 해제
+        fcntl(fd, F_SETFD, 0);
+    }
+    return 0;
+}
+
+/*
+ * 재지향 적용 함수
+ * 설명: 목록 순서대로 적용합니다 (2>&1 > file 과 > file 2>&1 은 결과가 다름).
+ *       fork한 자식 프로세스에서 사용합니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int redir_apply(const struct redir *redirs, int n) {
+    for (int k = 0; k < n; k++) {
+        if (apply_one(&redirs[k]) < 0) return -1;
+    }
+    return 0;
+}
+
+/*
+ * 되돌릴 수 있는 재지향 적용 함수 (쉘 내부 실행용)
+ * 설명: 각 대상 fd를 처음 바꾸기 전에 10번 이상의 O_CLOEXEC fd로 복제해 둡니다.
+ *       undo는 n칸이어야 하며, 성공/실패와 관계없이 redir_restore로 되돌립니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+int redir_apply_saved(const struct redir *redirs, int n, struct redir_undo *undo) {
+    for (int k = 0; k < n; k++) {
+        int fd = redirs[k].fd;
+
+        undo[k].fd = fd;
+        undo[k].saved = -1;
+        for (int j = 0; j < k; j++) {
+            if (undo[j].fd == fd) {
+                undo[k].saved = -2;
+                break;
+            }
+        }
+        if (undo[k].saved == -1) {
+            undo[k].saved = fcntl(fd, F_DUPFD_CLOEXEC, 10);
+            if (undo[k].saved < 0 && errno != EBADF) {
+                perror("redirection failed");
+                for (int j = k; j < n; j++) undo[j].saved = -2;
+                return -1;
+            }
+        }
+    }
+
+    fflush(NULL);
+    return redir_apply(redirs, n);
+}
+
+/* redir_apply_saved로 바꾼 fd들을 원래대로 복원 */
+void redir_restore(struct redir_undo *undo, int n) {
+    fflush(NULL);
+    for (int k = n - 1; k >= 0; k--) {
+        if (undo[k].saved == -2) continue;
+        if (undo[k].saved >= 0) {
+            dup2(undo[k].saved, undo[k].fd);
+            close(undo[k].saved);
+        } else {
+            close(undo[k].fd); // 원래 닫혀 있던 fd
+        }
+    }
+}
+
+/*
+ * 외부 명령어 실행 함수 (자식 프로세스용)
+ * 설명: 캐시된 절대 경로로 바로 execv 하고, 경로가 사라졌거나(ENOENT)
+ *       실행할 수 없으면 execvp로 PATH를 다시 검색합니다.
+ */
+void exec_external(char *argv[], const char *path) {
+    if (path != NULL) execv(path, argv);
+
+    execvp(argv[0], argv);
+    fprintf(stderr, "%s%s: command not found%s\n",
+            COLOR_RED, argv[0], COLOR_RESET);
+    exit(127);
+}
+
+/*
+ * exec 없이 실행하는 자식의 fd 정리 함수
+ * 설명: 내장 명령어 자식은 exec 하지 않으므로 O_CLOEXEC fd(파이프의 다른 쪽 끝 등)가
+ *       그대로 남습니다. 자기 출력 파이프의 읽기 쪽이 남아 있으면 다음 단계가 먼저 끝나도
+ *       (grep ... | head) SIGPIPE를 받지 못하고 멈추므로, exec처럼 모두 닫습니다.
+ */
+static void close_cloexec_fds(void) {
+    DIR *dir = opendir("/proc/self/fd");
+    struct dirent *e;
+
+    if (dir == NULL) return;
+    while ((e = readdir(dir)) != NULL) {
+        int fd = atoi(e->d_name);
+        int flags;
+
+        if (fd <= STDERR_FILENO || fd == dirfd(dir)) continue;
+        flags = fcntl(fd, F_GETFD);
+        if (flags >= 0 && (flags & FD_CLOEXEC)) close(fd);
+    }
+    closedir(dir);
+}
+
+/*
+ * fork 방식 실행 함수
+ * 설명: 내장 명령어(spec->fn)처럼 spawn으로 표현할 수 없는 경우에 사용합니다.
+ * 반환값: 자식 pid, 실패 시 -1
+ */
+pid_t launch_fork(const struct launch_spec *spec) {
+    pid_t pid;
+
+    fflush(NULL); // 자식에 출력 버퍼가 복제되지 않도록 먼저 비움
+    pid = fork();
+    if (pid != 0) return pid;
+
+    // [자식 프로세스] 작업의 프로세스 그룹에 들어가고 시그널은 기본 동작으로 복원
+    if (spec->pgid >= 0) setpgid(0, spec->pgid);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGQUIT, SIG_DFL);
+    signal(SIGTSTP, SIG_DFL);
+    signal(SIGTTIN, SIG_DFL);
+    signal(SIGTTOU, SIG_DFL);
+
+    // 표준 입출력을 파이프로 연결
+    // (원래 파이프 fd는 O_CLOEXEC이므로 exec 시 자동으로 닫힘)
+    if (spec->in_fd >= 0) dup2(spec->in_fd, STDIN_FILENO);
+    if (spec->out_fd >= 0) dup2(spec->out_fd, STDOUT_FILENO);
+
+    if (redir_apply(spec->redirs, spec->nredirs) < 0) _exit(EXIT_FAILURE);
+
+    // 내장 명령어는 쉘의 SIGCHLD 핸들러를 그대로 써서 자신이 만든 자식을 회수함 (parallel)
+    if (spec->fn != NULL) {
+        int status;
+
+        close_cloexec_fds();
+        status = spec->fn(spec->argv);
+        fflush(NULL);
+        _exit(status);
+    }
+    signal(SIGCHLD, SIG_DFL);
+    exec_external(spec->argv, spec->path);
+    return -1;
+}
+
+/*
+ * posix_spawn 방식 실행 함수
+ * 설명: 파이프 연결과 재지향은 file actions로, 자식의 시그널 기본 동작 복원은
+ *       POSIX_SPAWN_SETSIGDEF 속성으로, 프로세스 그룹은 POSIX_SPAWN_SETPGROUP으로 지정합니다. glibc는 CLONE_VM|CLONE_VFORK로
+ *       자식을 만들므로 쉘의 힙이 커도 페이지 테이블을 복사하지 않습니다.
+ * 반환값: 자식 pid, 실패 시 -1 (errno 설정)
+ */
+pid_t launch_spawn(const struct launch_spec *spec) {
+    posix_spawn_file_actions_t fa;
+    posix_spawnattr_t attr;
+    sigset_t def, empty;
+    pid_t pid = -1;
+    int err;
+
+    if (spec->fn != NULL) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    fflush(NULL); // 쉘의 출력 버퍼를 자식 출력보다 먼저 내보냄
+    posix_spawn_file_actions_init(&fa);
+    posix_spawnattr_init(&attr);
+
+    if (spec->in_fd >= 0) posix_spawn_file_actions_adddup2(&fa, spec->in_fd, STDIN_FILENO);
+    if (spec->out_fd >= 0) posix_spawn_file_actions_adddup2(&fa, spec->out_fd, STDOUT_FILENO);
+    for (int k = 0; k < spec->nredirs; k++) {
+        const struct redir *r = &spec->redirs[k];
+
+        if (redir_flags(r->type) >= 0)
+            posix_spawn_file_actions_addopen(&fa, r->fd, r->target, redir_flags(r->type), 0644);
+        else if (r->src_fd < 0)
+            posix_spawn_file_actions_addclose(&fa, r->fd);
+        else
+            posix_spawn_file_actions_adddup2(&fa, r->src_fd, r->fd);
+    }
+
+    sigemptyset(&def);
+    sigaddset(&def, SIGINT);
+    sigaddset(&def, SIGQUIT);
+    sigaddset(&def, SIGTSTP);
+    sigaddset(&def, SIGTTIN);
+    sigaddset(&def, SIGTTOU);
+    sigemptyset(&empty);
+    posix_spawnattr_setsigdefault(&attr, &def);
+    posix_spawnattr_setsigmask(&attr, &empty);
+    if (spec->pgid >= 0) {
+        posix_spawnattr_setpgroup(&attr, spec->pgid);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK |
+                                        POSIX_SPAWN_SETPGROUP);
+    } else {
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+    }
+
+    if (spec->path != NULL)
+        err = posix_spawn(&pid, spec->path, &fa, &attr, spec->argv, environ);
+    else
+        err = posix_spawnp(&pid, spec->argv[0], &fa, &attr, spec->argv, environ);
+
+    posix_spawn_file_actions_destroy(&fa);
+    posix_spawnattr_destroy(&attr);
+
+    if (err != 0) {
+        errno = err;
+        return -1;
+    }
+    return pid;
+}
+
+/*
+ * 실행 함수
+ * 설명: spawn 방식이 실패하면 (명령어 없음, 재지향 실패 등) fork 방식으로 다시 실행하여
+ *       fork 방식과 같은 오류 메시지와 종료 상태를 얻습니다.
+ * 반환값: 자식 pid, 실패 시 -1
+ */
+pid_t launch(const struct launch_spec *spec, int mode) {
+    if (mode == LAUNCH_SPAWN && spec->fn == NULL) {
+        pid_t pid = launch_spawn(spec);
+        if (pid > 0) return pid;
+    }
+    return launch_fork(spec);
+}
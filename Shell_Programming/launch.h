@@ -0,0 +1,66 @@
+/* launch.h */
+#ifndef LAUNCH_H
+#define LAUNCH_H
+
+#include <sys/types.h>
+
+#include <stddef.h>
+
+/* 재지향 종류 */
+enum redir_type {
+    REDIR_IN,        // [n]< file
+    REDIR_OUT,       // [n]> file
+    REDIR_APPEND,    // [n]>> file
+    REDIR_DUP,       // [n]>&m, [n]<&m, [n]>&- (닫기)
+    REDIR_HEREDOC,   // [n]<< 구분자 (본문은 다음 줄들)
+    REDIR_HERESTR    // [n]<<< 단어
+};
+
+/* 재지향 하나 (파서가 만듦) */
+struct redir {
+    int type;
+    int fd;              // 연결할 fd (<: 0, >: 1, 2>: 2 ...)
+    const char *target;  // 파일 이름, here 문서/문자열의 내용
+    size_t len;          // here 문서/문자열 내용의 길이
+    int src_fd;          // REDIR_DUP: 복제할 fd (-1: 닫기), here 문서: redir_prepare가 만든 memfd
+};
+
+/* 쉘 안에서 재지향을 적용했다가 되돌리기 위한 기록 */
+struct redir_undo {
+    int fd;              // 재지향된 fd
+    int saved;           // 원래 fd의 복제본 (-1: 원래 닫혀 있었음, -2: 이미 저장됨)
+};
+
+/* exec 대신 자식 프로세스 안에서 실행할 함수 (내장 명령어) */
+typedef int (*launch_fn)(char *argv[]);
+
+/* 자식 프로세스 하나의 실행 명세 */
+struct launch_spec {
+    char **argv;
+    const char *path;            // 실행 파일 경로 (NULL 이면 PATH 검색)
+    int in_fd;                   // 표준 입력으로 연결할 fd (-1: 그대로)
+    int out_fd;                  // 표준 출력으로 연결할 fd (-1: 그대로)
+    const struct redir *redirs;
+    int nredirs;
+    launch_fn fn;                // NULL이 아니면 fork 후 이 함수를 실행
+    pid_t pgid;                  // -1: 쉘의 그룹 유지, 0: 새 그룹, 그 외: 해당 그룹에 합류
+};
+
+/* 실행 방식 */
+enum launch_mode {
+    LAUNCH_SPAWN,    // posix_spawn (CLONE_VM|CLONE_VFORK, 페이지 테이블 복사 없음)
+    LAUNCH_FORK      // fork + exec
+};
+
+int launch_default_mode(void);
+int redir_prepare(struct redir *redirs, int n);
+void redir_release(struct redir *redirs, int n);
+int redir_apply(const struct redir *redirs, int n);
+int redir_apply_saved(const struct redir *redirs, int n, struct redir_undo *undo);
+void redir_restore(struct redir_undo *undo, int n);
+void exec_external(char *argv[], const char *path);
+pid_t launch_fork(const struct launch_spec *spec);
+pid_t launch_spawn(const struct launch_spec *spec);
+pid_t launch(const struct launch_spec *spec, int mode);
+
+#endif
@@ -0,0 +1,684 @@
+/* ls_core.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <time.h>
+#include <pwd.h>
+#include <grp.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "ls_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define LS_DENTS_SIZE  (1 << 20)      // getdents64 한 번에 읽을 버퍼 크기
+#define LS_OUT_SIZE    (256 * 1024)   // 출력 버퍼 크기 (가득 차면 한 번에 write)
+#define LS_STAT_CHUNK  2048           // 스레드 하나가 맡을 최소 항목 수 (-l)
+#define LS_MAX_THREADS 16
+#define LS_ID_CACHE    32             // 소유자/그룹 이름 캐시 크기
+#define LS_SIX_MONTHS  (365 * 24 * 3600 / 2)
+
+/*
+ * 디렉토리 항목 하나 (16바이트)
+ * 설명: 이름은 목록의 이름 버퍼에 이어 붙여 두고 위치만 기억합니다.
+ *       key는 이름 앞 8바이트를 빅엔디안 정수로 만든 정렬 키로, 대부분의 비교가
+ *       정수 비교 한 번으로 끝납니다.
+ */
+struct ls_entry {
+    uint64_t key;
+    uint32_t name;      // names 안의 위치
+    uint16_t len;
+    uint8_t type;       // d_type (DT_UNKNOWN이면 필요할 때 직접 확인)
+};
+
+/* -l에 필요한 메타데이터 (정렬 후 항목과 같은 순서) */
+struct ls_stat {
+    int err;            // statx 실패 시 errno
+    mode_t mode;
+    nlink_t nlink;
+    uid_t uid;
+    gid_t gid;
+    off_t size;
+    dev_t rdev;
+    int64_t mtime;
+    uint64_t blocks;    // 512바이트 블록 수
+};
+
+/* 디렉토리 하나의 항목 목록 (다음 디렉토리에서 버퍼를 재사용) */
+struct ls_list {
+    struct ls_entry *ents;
+    size_t n, cap;
+    char *names;
+    size_t names_len, names_cap;
+    struct ls_stat *st;
+    size_t st_cap;
+};
+
+/* 출력 버퍼 */
+struct ls_out {
+    int fd;
+    size_t len;
+    char buf[LS_OUT_SIZE];
+};
+
+struct ls_id {
+    unsigned id;
+    char name[32];
+};
+
+struct ls_ctx {
+    const struct ls_opts *opts;
+    struct ls_out out;
+    char *dents;                  // getdents64 버퍼
+    struct ls_list **levels;      // -R 깊이별 목록
+    int nlevels;
+    char *path;                   // 현재 디렉토리 경로 (머리말, 오류 메시지용)
+    size_t path_len, path_cap;
+    int sections;                 // 지금까지 출력한 구역 수 (구역 사이 빈 줄)
+    int errors;
+    time_t now;
+    struct ls_id users[LS_ID_CACHE], groups[LS_ID_CACHE];
+    int nusers, ngroups;
+    int64_t time_key;             // time_buf를 만든 분 (같은 분이면 다시 만들지 않음)
+    char time_buf[32];
+};
+
+/* 메타데이터를 나눠 읽는 스레드 하나의 범위 */
+struct stat_range {
+    int dirfd;
+    const struct ls_list *l;
+    size_t begin, end;
+};
+
+/* ---------------- 출력 ---------------- */
+
+static void out_flush(struct ls_out *o) {
+    size_t off = 0;
+
+    while (off < o->len) {
+        ssize_t n = write(o->fd, o->buf + off, o->len - off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;  // EPIPE 등: 나머지 출력은 버림
+        }
+        off += n;
+    }
+    o->len = 0;
+}
+
+static void out_mem(struct ls_out *o, const char *s, size_t len) {
+    if (o->len + len > LS_OUT_SIZE) {
+        out_flush(o);
+        if (len > LS_OUT_SIZE) {
+            memcpy(o->buf, s, LS_OUT_SIZE);  // 긴 경로: 버퍼 단위로 나눠 씀
+            o->len = LS_OUT_SIZE;
+            out_mem(o, s + LS_OUT_SIZE, len - LS_OUT_SIZE);
+            return;
+        }
+    }
+    memcpy(o->buf + o->len, s, len);
+    o->len += len;
+}
+
+static void out_str(struct ls_out *o, const char *s) {
+    out_mem(o, s, strlen(s));
+}
+
+static void out_char(struct ls_out *o, char ch) {
+    if (o->len == LS_OUT_SIZE) out_flush(o);
+    o->buf[o->len++] = ch;
+}
+
+static void out_pad(struct ls_out *o, int n) {
+    while (n-- > 0) out_char(o, ' ');
+}
+
+static int num_width(unsigned long long v) {
+    int w = 1;
+    while (v >= 10) {
+        v /= 10;
+        w++;
+    }
+    return w;
+}
+
+/* 숫자를 width 칸에 오른쪽 정렬로 출력 */
+static void out_num(struct ls_out *o, unsigned long long v, int width) {
+    char tmp[24];
+    int n = 0;
+
+    do {
+        tmp[sizeof(tmp) - 1 - n++] = '0' + v % 10;
+        v /= 10;
+    } while (v > 0);
+    out_pad(o, width - n);
+    out_mem(o, tmp + sizeof(tmp) - n, n);
+}
+
+/* 오류 메시지 출력 (앞선 정상 출력이 먼저 보이도록 버퍼를 비운 뒤) */
+static void report(struct ls_ctx *c, const char *what, const char *path, int err) {
+    out_flush(&c->out);
+    fprintf(stderr, "%sls: %s '%s': %s%s\n", COLOR_RED, what, path, strerror(err), COLOR_RESET);
+    c->errors++;
+}
+
+/* ---------------- 목록 ---------------- */
+
+static uint64_t name_key(const char *s, size_t len) {
+    uint64_t key = 0;
+
+    for (size_t i = 0; i < 8; i++)
+        key = (key << 8) | (i < len ? (unsigned char)s[i] : 0);
+    return key;
+}
+
+static int list_add(struct ls_list *l, const char *name, size_t len, unsigned char type) {
+    if (l->n == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 1024;
+        struct ls_entry *grown = realloc(l->ents, cap * sizeof(*grown));
+        if (grown == NULL) return -1;
+        l->ents = grown;
+        l->cap = cap;
+    }
+    if (l->names_len + len + 1 > l->names_cap) {
+        size_t cap = l->names_cap ? l->names_cap * 2 : 64 * 1024;
+        while (cap < l->names_len + len + 1) cap *= 2;
+        char *grown = realloc(l->names, cap);
+        if (grown == NULL) return -1;
+        l->names = grown;
+        l->names_cap = cap;
+    }
+
+    struct ls_entry *e = &l->ents[l->n++];
+    memcpy(l->names + l->names_len, name, len + 1);
+    e->key = name_key(name, len);
+    e->name = (uint32_t)l->names_len;
+    e->len = (uint16_t)len;
+    e->type = type;
+    l->names_len += len + 1;
+    return 0;
+}
+
+static void list_free(struct ls_list *l) {
+    free(l->ents);
+    free(l->names);
+    free(l->st);
+    free(l);
+}
+
+static const char *entry_name(const struct ls_list *l, const struct ls_entry *e) {
+    return l->names + e->name;
+}
+
+static int compare_entries(const void *a, const void *b, void *arg) {
+    const struct ls_entry *x = a, *y = b;
+    const char *names = arg;
+
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    if (x->len <= 8 || y->len <= 8) return (int)x->len - (int)y->len;
+    return strcmp(names + x->name + 8, names + y->name + 8);
+}
+
+/* getdents64로 디렉토리 전체를 큰 단위로 읽어 목록에 추가 */
+static int read_dir(struct ls_ctx *c, int fd, struct ls_list *l) {
+    l->n = 0;
+    l->names_len = 0;
+
+    for (;;) {
+        ssize_t n = getdents64(fd, c->dents, LS_DENTS_SIZE);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) return 0;
+
+        for (ssize_t off = 0; off < n; ) {
+            struct dirent64 *d = (struct dirent64 *)(c->dents + off);
+            off += d->d_reclen;
+            if (d->d_name[0] == '.' && !c->opts->all) continue;
+            if (list_add(l, d->d_name, strlen(d->d_name), d->d_type) < 0) return -1;
+        }
+    }
+}
+
+/* ---------------- 메타데이터 (-l) ---------------- */
+
+static void stat_one(int dirfd, const char *name, struct ls_stat *st) {
+    struct statx sx;
+
+    if (statx(dirfd, name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, STATX_BASIC_STATS, &sx) < 0) {
+        st->err = errno;
+        return;
+    }
+    st->err = 0;
+    st->mode = sx.stx_mode;
+    st->nlink = sx.stx_nlink;
+    st->uid = sx.stx_uid;
+    st->gid = sx.stx_gid;
+    st->size = (off_t)sx.stx_size;
+    st->rdev = makedev(sx.stx_rdev_major, sx.stx_rdev_minor);
+    st->mtime = sx.stx_mtime.tv_sec;
+    st->blocks = sx.stx_blocks;
+}
+
+static void *stat_worker(void *arg) {
+    const struct stat_range *r = arg;
+
+    for (size_t i = r->begin; i < r->end; i++)
+        stat_one(r->dirfd, entry_name(r->l, &r->l->ents[i]), &r->l->st[i]);
+    return NULL;
+}
+
+/*
+ * 목록 전체의 메타데이터 읽기
+ * 설명: 항목이 많으면 여러 스레드가 구간을 나눠 statx를 동시에 호출하므로
+ *       inode가 캐시에 없는 큰 디렉토리에서도 디스크 대기가 겹쳐집니다.
+ */
+static int stat_all(struct ls_ctx *c, int dirfd, struct ls_list *l) {
+    pthread_t tids[LS_MAX_THREADS];
+    struct stat_range ranges[LS_MAX_THREADS];
+    size_t nthreads = l->n / LS_STAT_CHUNK;
+
+    if (l->n > l->st_cap) {
+        struct ls_stat *grown = realloc(l->st, l->n * sizeof(*grown));
+        if (grown == NULL) return -1;
+        l->st = grown;
+        l->st_cap = l->n;
+    }
+
+    if (nthreads > (size_t)c->opts->jobs) nthreads = c->opts->jobs;
+    if (nthreads > LS_MAX_THREADS) nthreads = LS_MAX_THREADS;
+    if (nthreads < 1) nthreads = 1;
+
+    size_t per = (l->n + nthreads - 1) / nthreads;
+    int created[LS_MAX_THREADS] = { 0 };
+    for (size_t t = 0; t < nthreads; t++) {
+        ranges[t].dirfd = dirfd;
+        ranges[t].l = l;
+        ranges[t].begin = t * per < l->n ? t * per : l->n;
+        ranges[t].end = (t + 1) * per < l->n ? (t + 1) * per : l->n;
+    }
+    // 첫 구간은 현재 스레드가 직접 처리 (스레드를 만들 수 없으면 그 구간도 직접)
+    for (size_t t = 1; t < nthreads; t++) {
+        created[t] = pthread_create(&tids[t], NULL, stat_worker, &ranges[t]) == 0;
+        if (!created[t]) stat_worker(&ranges[t]);
+    }
+    stat_worker(&ranges[0]);
+    for (size_t t = 1; t < nthreads; t++)
+        if (created[t]) pthread_join(tids[t], NULL);
+    return 0;
+}
+
+/* uid/gid → 이름 (최근에 본 것들을 캐시) */
+static const char *id_name(struct ls_id *cache, int *n, unsigned id, int is_group) {
+    for (int k = 0; k < *n; k++)
+        if (cache[k].id == id) return cache[k].name;
+
+    struct ls_id *slot = &cache[*n < LS_ID_CACHE ? (*n)++ : id % LS_ID_CACHE];
+    const char *name = NULL;
+    if (is_group) {
+        struct group *gr = getgrgid(id);
+        if (gr != NULL) name = gr->gr_name;
+    } else {
+        struct passwd *pw = getpwuid(id);
+        if (pw != NULL) name = pw->pw_name;
+    }
+    slot->id = id;
+    if (name != NULL) snprintf(slot->name, sizeof(slot->name), "%s", name);
+    else snprintf(slot->name, sizeof(slot->name), "%u", id);
+    return slot->name;
+}
+
+/* 수정 시각 문자열 (같은 분이면 이전 결과를 재사용) */
+static const char *format_time(struct ls_ctx *c, int64_t t) {
+    int recent = t > c->now - LS_SIX_MONTHS && t <= c->now + 3600;
+    int64_t key = (t / 60) * 2 + recent;
+
+    if (key != c->time_key || c->time_buf[0] == '\0') {
+        time_t tt = (time_t)t;
+        struct tm tm;
+        if (localtime_r(&tt, &tm) == NULL ||
+            strftime(c->time_buf, sizeof(c->time_buf), recent ? "%b %e %H:%M" : "%b %e  %Y", &tm) == 0)
+            snprintf(c->time_buf, sizeof(c->time_buf), "%lld", (long long)t);
+        c->time_key = key;
+    }
+    return c->time_buf;
+}
+
+static void format_mode(mode_t mode, char *s) {
+    const char *rwx = "rwxrwxrwx";
+
+    switch (mode & S_IFMT) {
+        case S_IFDIR:  s[0] = 'd'; break;
+        case S_IFLNK:  s[0] = 'l'; break;
+        case S_IFCHR:  s[0] = 'c'; break;
+        case S_IFBLK:  s[0] = 'b'; break;
+        case S_IFIFO:  s[0] = 'p'; break;
+        case S_IFSOCK: s[0] = 's'; break;
+        default:       s[0] = '-'; break;
+    }
+    for (int k = 0; k < 9; k++)
+        s[k + 1] = (mode & (0400 >> k)) ? rwx[k] : '-';
+    if (mode & S_ISUID) s[3] = (mode & S_IXUSR) ? 's' : 'S';
+    if (mode & S_ISGID) s[6] = (mode & S_IXGRP) ? 's' : 'S';
+    if (mode & S_ISVTX) s[9] = (mode & S_IXOTH) ? 't' : 'T';
+    s[10] = '\0';
+}
+
+/* -l 형식 출력 */
+static void print_long(struct ls_ctx *c, int dirfd, const struct ls_list *l, int is_dir) {
+    struct ls_out *o = &c->out;
+    int wlink = 1, wuser = 1, wgroup = 1, wsize = 1, wmajor = 0, wminor = 0, w;
+    unsigned long long blocks = 0;
+
+    // 1. 열 너비 계산
+    for (size_t i = 0; i < l->n; i++) {
+        const struct ls_stat *st = &l->st[i];
+        if (st->err) continue;
+        if ((w = num_width(st->nlink)) > wlink) wlink = w;
+        if ((w = (int)strlen(id_name(c->users, &c->nusers, st->uid, 0))) > wuser) wuser = w;
+        if ((w = (int)strlen(id_name(c->groups, &c->ngroups, st->gid, 1))) > wgroup) wgroup = w;
+        if (S_ISCHR(st->mode) || S_ISBLK(st->mode)) {
+            // 장치 번호는 주/부 번호를 각각 열로 맞춤 (GNU ls와 같은 "  5,   1")
+            if ((w = num_width(major(st->rdev))) > wmajor) wmajor = w;
+            if ((w = num_width(minor(st->rdev))) > wminor) wminor = w;
+        } else if ((w = num_width((unsigned long long)st->size)) > wsize) {
+            wsize = w;
+        }
+        blocks += (st->blocks + 1) / 2;
+    }
+    if (wmajor > 0 && wmajor + 2 + wminor > wsize) wsize = wmajor + 2 + wminor;
+
+    if (is_dir) {
+        out_str(o, "total ");
+        out_num(o, blocks, 0);
+        out_char(o, '\n');
+    }
+
+    // 2. 한 줄씩 출력
+    for (size_t i = 0; i < l->n; i++) {
+        const struct ls_stat *st = &l->st[i];
+        const char *name = entry_name(l, &l->ents[i]);
+        char mode[11];
+
+        if (st->err) {
+            report(c, "cannot access", name, st->err);
+            continue;
+        }
+
+        format_mode(st->mode, mode);
+        out_mem(o, mode, 10);
+        out_char(o, ' ');
+        out_num(o, st->nlink, wlink);
+        out_char(o, ' ');
+        const char *user = id_name(c->users, &c->nusers, st->uid, 0);
+        out_str(o, user);
+        out_pad(o, wuser - (int)strlen(user) + 1);
+        const char *group = id_name(c->groups, &c->ngroups, st->gid, 1);
+        out_str(o, group);
+        out_pad(o, wgroup - (int)strlen(group) + 1);
+        if (S_ISCHR(st->mode) || S_ISBLK(st->mode)) {
+            out_num(o, major(st->rdev), wsize - 2 - wminor);
+            out_mem(o, ", ", 2);
+            out_num(o, minor(st->rdev), wminor);
+        } else {
+            out_num(o, (unsigned long long)st->size, wsize);
+        }
+        out_char(o, ' ');
+        out_str(o, format_time(c, st->mtime));
+        out_char(o, ' ');
+        out_mem(o, name, l->ents[i].len);
+
+        if (S_ISLNK(st->mode)) {
+            char target[PATH_MAX];
+            ssize_t n = readlinkat(dirfd, name, target, sizeof(target));
+            if (n >= 0) {
+                out_mem(o, " -> ", 4);
+                out_mem(o, target, n);
+            }
+        }
+        out_char(o, '\n');
+    }
+}
+
+/* 이름만 출력: 터미널이면 열에 맞춰 (위에서 아래로), 아니면 한 줄에 하나 */
+static void print_names(struct ls_ctx *c, const struct ls_list *l) {
+    struct ls_out *o = &c->out;
+    size_t maxlen = 0;
+
+    if (l->n == 0) return;
+    if (c->opts->one_per_line || c->opts->width <= 0) {
+        for (size_t i = 0; i < l->n; i++) {
+            out_mem(o, entry_name(l, &l->ents[i]), l->ents[i].len);
+            out_char(o, '\n');
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < l->n; i++)
+        if (l->ents[i].len > maxlen) maxlen = l->ents[i].len;
+
+    size_t colw = maxlen + 2;
+    size_t cols = (size_t)c->opts->width / colw;
+    if (cols < 1) cols = 1;
+    size_t rows = (l->n + cols - 1) / cols;
+
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t i = r; i < l->n; i += rows) {
+            const struct ls_entry *e = &l->ents[i];
+            out_mem(o, entry_name(l, e), e->len);
+            if (i + rows < l->n) out_pad(o, (int)(colw - e->len));
+        }
+        out_char(o, '\n');
+    }
+}
+
+/* 정렬한 뒤 형식에 맞춰 출력 */
+static void print_list(struct ls_ctx *c, int dirfd, struct ls_list *l, int is_dir) {
+    qsort_r(l->ents, l->n, sizeof(*l->ents), compare_entries, l->names);
+
+    if (!c->opts->long_format) {
+        print_names(c, l);
+        return;
+    }
+    if (stat_all(c, dirfd, l) < 0) {
+        report(c, "cannot read metadata in", c->path, ENOMEM);
+        return;
+    }
+    print_long(c, dirfd, l, is_dir);
+}
+
+/* ---------------- 디렉토리 탐색 ---------------- */
+
+static struct ls_list *level(struct ls_ctx *c, int depth) {
+    if (depth >= c->nlevels) {
+        int n = depth + 8;
+        struct ls_list **grown = realloc(c->levels, n * sizeof(*grown));
+        if (grown == NULL) return NULL;
+        for (int k = c->nlevels; k < n; k++) grown[k] = NULL;
+        c->levels = grown;
+        c->nlevels = n;
+    }
+    if (c->levels[depth] == NULL) c->levels[depth] = calloc(1, sizeof(struct ls_list));
+    return c->levels[depth];
+}
+
+static int path_set(struct ls_ctx *c, size_t at, const char *name) {
+    size_t len = strlen(name);
+
+    if (at + len + 2 > c->path_cap) {
+        size_t cap = c->path_cap ? c->path_cap * 2 : 4096;
+        while (cap < at + len + 2) cap *= 2;
+        char *grown = realloc(c->path, cap);
+        if (grown == NULL) return -1;
+        c->path = grown;
+        c->path_cap = cap;
+    }
+    memcpy(c->path + at, name, len + 1);
+    c->path_len = at + len;
+    return 0;
+}
+
+static void print_header(struct ls_ctx *c) {
+    if (c->sections++ > 0) out_char(&c->out, '\n');
+    out_mem(&c->out, c->path, c->path_len);
+    out_mem(&c->out, ":\n", 2);
+}
+
+/* 항목이 (심볼릭 링크가 아닌) 디렉토리인지 */
+static int entry_is_dir(int dirfd, const struct ls_list *l, size_t i, int have_stat) {
+    const struct ls_entry *e = &l->ents[i];
+    struct stat st;
+
+    if (e->type != DT_UNKNOWN) return e->type == DT_DIR;
+    if (have_stat) return !l->st[i].err && S_ISDIR(l->st[i].mode);
+    return fstatat(dirfd, entry_name(l, e), &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+}
+
+/*
+ * 디렉토리 하나 출력 (c->path가 이 디렉토리의 경로)
+ * 설명: -R이면 하위 디렉토리를 이 디렉토리의 fd 기준 openat으로 열어
+ *       경로를 처음부터 다시 해석하지 않습니다. 깊이마다 목록 버퍼를 재사용합니다.
+ */
+static void list_dir(struct ls_ctx *c, int fd, int depth) {
+    struct ls_list *l = level(c, depth);
+
+    if (l == NULL || read_dir(c, fd, l) < 0) {
+        report(c, "reading directory", c->path, l == NULL ? ENOMEM : errno);
+        if (l == NULL) return;
+    }
+    print_list(c, fd, l, 1);
+    if (!c->opts->recursive) return;
+
+    size_t base = c->path_len;
+    int slash = base > 0 && c->path[base - 1] == '/';
+    for (size_t i = 0; i < l->n; i++) {
+        const char *name = entry_name(l, &l->ents[i]);
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+        if (!entry_is_dir(fd, l, i, c->opts->long_format)) continue;
+
+        if (!slash) c->path[base] = '/';
+        if (path_set(c, base + !slash, name) < 0) {
+            report(c, "cannot open directory", name, ENOMEM);
+            continue;
+        }
+        print_header(c);
+
+        int sub = openat(fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (sub < 0) {
+            report(c, "cannot open directory", c->path, errno);
+        } else {
+            list_dir(c, sub, depth + 1);
+            close(sub);
+        }
+        c->path[base] = '\0';
+        c->path_len = base;
+    }
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/*
+ * ls 실행 함수
+ * 설명: 인자 중 디렉토리가 아닌 것을 먼저 한 목록으로 출력하고, 디렉토리는
+ *       이름 순서대로 내용을 출력합니다 (인자가 여럿이거나 -R이면 "경로:" 머리말).
+ *       항목은 getdents64로 1MB씩 읽어 작은 고정 크기 구조체와 이름 버퍼에
+ *       모으므로 항목 수가 많아도 항목마다 malloc 하지 않으며, d_type이 있으면
+ *       -R에서도 stat을 호출하지 않습니다. 출력은 큰 버퍼에 모아 write 합니다.
+ * 반환값: 오류 개수 (0이면 성공)
+ */
+int ls_run(char *const paths[], int npaths, const struct ls_opts *opts) {
+    static char *const dot[] = { "." };
+    struct ls_ctx *c = calloc(1, sizeof(*c));
+    struct ls_list files = { 0 };
+    char **dirs = NULL;
+    int ndirs = 0, errors;
+
+    if (npaths == 0) {
+        paths = dot;
+        npaths = 1;
+    }
+    if (c != NULL) {
+        c->dents = malloc(LS_DENTS_SIZE);
+        dirs = malloc(npaths * sizeof(*dirs));
+    }
+    if (c == NULL || c->dents == NULL || dirs == NULL) {
+        perror("ls");
+        if (c != NULL) free(c->dents);
+        free(c);
+        free(dirs);
+        return 1;
+    }
+    c->opts = opts;
+    c->out.fd = STDOUT_FILENO;
+    c->now = time(NULL);
+
+    // 1. 인자 분류: 디렉토리(-l이면 링크 자체를 봄)와 그 외
+    for (int k = 0; k < npaths; k++) {
+        struct stat st;
+        int r = opts->long_format ? lstat(paths[k], &st) : stat(paths[k], &st);
+
+        if (r < 0 && !opts->long_format) r = lstat(paths[k], &st); // 끊어진 링크
+        if (r < 0) {
+            report(c, "cannot access", paths[k], errno);
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            dirs[ndirs++] = paths[k];
+        } else if (list_add(&files, paths[k], strlen(paths[k]), S_ISLNK(st.st_mode) ? DT_LNK : DT_REG) < 0) {
+            report(c, "cannot access", paths[k], ENOMEM);
+        }
+    }
+
+    // 2. 디렉토리가 아닌 인자들
+    if (files.n > 0) {
+        path_set(c, 0, ".");
+        print_list(c, AT_FDCWD, &files, 0);
+        c->sections++;
+    }
+
+    // 3. 디렉토리들
+    qsort(dirs, ndirs, sizeof(*dirs), compare_paths);
+    for (int k = 0; k < ndirs; k++) {
+        if (path_set(c, 0, dirs[k]) < 0) {
+            report(c, "cannot open directory", dirs[k], ENOMEM);
+            continue;
+        }
+        if (npaths > 1 || opts->recursive) print_header(c);
+        else c->sections++;
+
+        int fd = open(dirs[k], O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            report(c, "cannot open directory", dirs[k], errno);
+            continue;
+        }
+        list_dir(c, fd, 0);
+        close(fd);
+    }
+
+    out_flush(&c->out);
+    errors = c->errors;
+    for (int k = 0; k < c->nlevels; k++)
+        if (c->levels[k] != NULL) list_free(c->levels[k]);
+    free(c->levels);
+    free(c->path);
+    free(c->dents);
+    free(c);
+    free(files.ents);
+    free(files.names);
+    free(files.st);
+    free(dirs);
+    return errors;
+}
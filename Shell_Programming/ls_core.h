@@ -0,0 +1,19 @@
+/* ls_core.h */
+#ifndef LS_CORE_H
+#define LS_CORE_H
+
+/*
+ * ls 옵션 (-a -l -R -1 -j N)
+ */
+struct ls_opts {
+    int all;            // -a: '.'으로 시작하는 항목도 출력
+    int long_format;    // -l: 권한, 링크 수, 소유자, 크기, 수정 시각
+    int recursive;      // -R: 하위 디렉토리도 출력
+    int one_per_line;   // -1: 한 줄에 하나 (출력이 터미널이 아니면 항상)
+    int width;          // 열 출력에 쓸 터미널 폭 (0이면 한 줄에 하나)
+    int jobs;           // -l에서 메타데이터를 나눠 읽을 스레드 수
+};
+
+int ls_run(char *const paths[], int npaths, const struct ls_opts *opts);
+
+#endif
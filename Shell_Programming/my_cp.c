@@ -1,41 +1,133 @@
 /* my_cp.c */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "copy_core.h"
+#include "applets.h"
 
 #define COLOR_RED    "\x1b[31m"
 #define COLOR_RESET  "\x1b[0m"
 
-int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <source> <destination>\n", argv[0]);
+int cp_main(int argc, char *argv[]) {
+    int verbose = 0;
+    int recursive = 0;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN) * 2; // 기본값: 코어 수의 2배 (I/O 대기 고려)
+    int i = 1;
+
+    // 옵션 처리 (-v: 사용한 복사 방법 출력, -r: 디렉토리 복사, -j N: 복사 스레드 수)
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        for (int j = 1; argv[i][j] != '\0'; j++) {
+            if (argv[i][j] == 'j') {
+                const char *val = (argv[i][j + 1] != '\0') ? &argv[i][j + 1] : argv[++i];
+                if (val == NULL || atoi(val) < 1) {
+                    fprintf(stderr, "%scp: invalid number of jobs%s\n", COLOR_RED, COLOR_RESET);
+                    return 1;
+                }
+                jobs = atoi(val);
+                break;
+            }
+            switch (argv[i][j]) {
+                case 'v': verbose = 1; break;
+                case 'r':
+                case 'R': recursive = 1; break;
+                default:
+                    fprintf(stderr, "%scp: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    return 1;
+            }
+        }
+        i++;
+    }
+
+    if (argc - i != 2) {
+        fprintf(stderr, "Usage: %s [-v] [-r] [-j N] <source> <destination>\n", argv[0]);
         return 1;
     }
+    const char *src = argv[i], *dst = argv[i + 1];
+    char *target = NULL;
+    struct stat src_st, dst_st;
 
-    int src_fd = open(argv[1], O_RDONLY);
+    // 대상이 이미 있는 디렉토리면 그 안에 같은 이름으로 복사
+    if (stat(dst, &dst_st) == 0 && S_ISDIR(dst_st.st_mode)) {
+        const char *base = strrchr(src, '/');
+        base = (base != NULL && base[1] != '\0') ? base + 1 : src;
+        target = malloc(strlen(dst) + strlen(base) + 2);
+        if (target == NULL) {
+            perror("cp");
+            return 1;
+        }
+        sprintf(target, "%s/%s", dst, base);
+        dst = target;
+    }
+
+    // 디렉토리 복사 (-r)
+    if (stat(src, &src_st) == 0 && S_ISDIR(src_st.st_mode)) {
+        if (!recursive) {
+            fprintf(stderr, "%scp: -r not specified; omitting directory '%s'%s\n", COLOR_RED, src, COLOR_RESET);
+            free(target);
+            return 1;
+        }
+        struct copy_tree_opts topts = { (int)jobs, verbose };
+        int errors = copy_tree(src, dst, &topts);
+        free(target);
+        return errors ? 1 : 0;
+    }
+
+    int src_fd = open(src, O_RDONLY);
     if (src_fd < 0) {
         perror("cp: source open error");
+        free(target);
         return 1;
     }
 
-    int dst_fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fstat(src_fd, &src_st) < 0) {
+        perror("cp: stat error");
+        close(src_fd);
+        free(target);
+        return 1;
+    }
+
+    // 같은 파일로 복사하면 O_TRUNC로 원본이 지워지므로 미리 확인
+    if (stat(dst, &dst_st) == 0 &&
+        dst_st.st_dev == src_st.st_dev && dst_st.st_ino == src_st.st_ino) {
+        fprintf(stderr, "%scp: '%s' and '%s' are the same file%s\n", COLOR_RED, src, dst, COLOR_RESET);
+        close(src_fd);
+        free(target);
+        return 1;
+    }
+
+    int dst_fd = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
     if (dst_fd < 0) {
         perror("cp: dest open error");
         close(src_fd);
+        free(target);
         return 1;
     }
 
-    char buf[4096];
-    ssize_t nread;
-    while ((nread = read(src_fd, buf, sizeof(buf))) > 0) {
-        if (write(dst_fd, buf, nread) != nread) {
-            perror("cp: write error");
-            break;
-        }
+    int method;
+    int ret = 0;
+    if (copy_fd(src_fd, dst_fd, &src_st, &method) < 0) {
+        perror("cp: write error");
+        ret = 1;
+    } else if (verbose) {
+        printf("'%s' -> '%s' (%s)\n", src, dst, copy_method_name(method));
     }
 
     close(src_fd);
-    close(dst_fd);
-    return 0;
+    if (close(dst_fd) < 0) {
+        perror("cp: close error");
+        ret = 1;
+    }
+    free(target);
+    return ret;
+}
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return cp_main(argc, argv);
 }
+#endif
@@ -3,88 +3,338 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
-#include <ctype.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "grep_core.h"
+#include "applets.h"
 
 #define COLOR_RED    "\x1b[31m"
 #define COLOR_RESET  "\x1b[0m"
 
-int main(int argc, char *argv[]) {
+/* 패턴 목록 (-e, -f로 여러 개 지정) */
+struct pattern_list {
+    char **v;
+    int n, cap;
+};
+
+/*
+ * 패턴 추가 함수
+ * 설명: GNU grep처럼 패턴 안의 줄바꿈은 패턴을 나눕니다 (-e $'a\nb' == -e a -e b).
+ * 반환값: 0(성공), -1(메모리 부족)
+ */
+static int add_pattern(struct pattern_list *pl, const char *s, size_t len) {
+    for (;;) {
+        const char *nl = memchr(s, '\n', len);
+        size_t part = (nl != NULL) ? (size_t)(nl - s) : len;
+
+        if (pl->n == pl->cap) {
+            int cap = pl->cap ? pl->cap * 2 : 16;
+            char **bigger = realloc(pl->v, cap * sizeof(*bigger));
+            if (bigger == NULL) return -1;
+            pl->v = bigger;
+            pl->cap = cap;
+        }
+        pl->v[pl->n] = strndup(s, part);
+        if (pl->v[pl->n] == NULL) return -1;
+        pl->n++;
+        if (nl == NULL) return 0;
+        s = nl + 1;
+        len -= part + 1;
+    }
+}
+
+/*
+ * 패턴 파일 읽기 함수 (-f FILE)
+ * 설명: 한 줄에 패턴 하나, "-"는 표준 입력. 빈 파일은 패턴이 없으므로 아무 줄과도 맞지 않습니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+static int read_pattern_file(struct pattern_list *pl, const char *path) {
+    FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+    int status = 0;
+
+    if (fp == NULL) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+    while ((len = getline(&line, &cap, fp)) > 0) {
+        if (line[len - 1] == '\n') len--;
+        if (add_pattern(pl, line, len) < 0) {
+            fprintf(stderr, "%sgrep: memory exhausted%s\n", COLOR_RED, COLOR_RESET);
+            status = -1;
+            break;
+        }
+    }
+    if (status == 0 && ferror(fp)) {
+        fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+        status = -1;
+    }
+    free(line);
+    if (fp != stdin) fclose(fp);
+    return status;
+}
+
+static void free_patterns(struct pattern_list *pl) {
+    for (int k = 0; k < pl->n; k++) free(pl->v[k]);
+    free(pl->v);
+}
+
+/* --include=GLOB 등 이름 거르기 추가 (argv 문자열을 그대로 가리킴) */
+static int add_glob(char ***v, int *n, const char *glob) {
+    char **bigger = realloc(*v, (*n + 1) * sizeof(*bigger));
+
+    if (bigger == NULL) return -1;
+    bigger[(*n)++] = (char *)glob;
+    *v = bigger;
+    return 0;
+}
+
+static void free_filter(struct grep_walk_filter *flt) {
+    free(flt->include);
+    free(flt->exclude);
+    free(flt->exclude_dir);
+}
+
+/*
+ * 재귀 검색 함수 (-r)
+ * 설명: 디렉토리 인자는 grep_walk로 그 아래 파일 목록(경로 순)으로 펼치고, 파일 인자는 그대로 두어
+ *       인자 순서대로 검색합니다. 인자가 없으면 현재 디렉토리를 검색하며 경로 앞에 "./"를
+ *       붙이지 않습니다 (GNU grep과 같음).
+ * 반환값: 0(성공), -1(순회 중 메모리 부족)
+ */
+static int grep_recursive(const struct grep_pattern *pat, const struct grep_opts *opts,
+                          const struct grep_walk_filter *flt, char *const args[], int jobs) {
+    char *const here[] = { "", NULL };
+    char **all = NULL;
+    size_t n = 0, cap = 0;
+    int status = 0;
+
+    if (args[0] == NULL) args = here;
+    for (int k = 0; args[k] != NULL; k++) {
+        struct stat sb;
+        char **found = NULL;
+        size_t nfound = 0;
+
+        if (args[k][0] != '\0' && (stat(args[k], &sb) < 0 || !S_ISDIR(sb.st_mode))) {
+            // 파일 (또는 없는 경로: 검색할 때 오류 출력)
+            found = malloc(sizeof(*found));
+            if (found != NULL && (found[0] = strdup(args[k])) != NULL) nfound = 1;
+        } else if (grep_walk(args[k], flt, jobs, &found, &nfound) < 0) {
+            status = -1;
+        }
+
+        if (n + nfound > cap) {
+            size_t bigger_cap = (n + nfound) * 2;
+            char **bigger = realloc(all, bigger_cap * sizeof(*bigger));
+            if (bigger == NULL) {
+                for (size_t j = 0; j < nfound; j++) free(found[j]);
+                nfound = 0;
+                status = -1;
+            } else {
+                all = bigger;
+                cap = bigger_cap;
+            }
+        }
+        for (size_t j = 0; j < nfound; j++) all[n++] = found[j];
+        free(found);
+    }
+
+    // 여러 파일은 작업자 풀로 동시에 검색 (출력은 목록 순서), -j 1 이면 차례로
+    if (n > 0 && !(jobs > 1 && grep_parallel(pat, opts, all, (int)n, jobs, stdout) == 0)) {
+        for (size_t k = 0; k < n; k++) grep_path(pat, opts, all[k], stdout);
+    }
+    for (size_t k = 0; k < n; k++) free(all[k]);
+    free(all);
+    return status;
+}
+
+int grep_main(int argc, char *argv[]) {
     int i = 1;
-    int ignore_case = 0;
-    int show_line_numbers = 0;
-    int invert_match = 0;
-    int count_only = 0;
-    int list_files = 0;
+    struct grep_opts opts = { 0 };
+    struct grep_pattern pat;
+    struct pattern_list pl = { 0 };
+    struct grep_walk_filter flt = { 0 };
+    int have_patterns = 0, use_index = 0, recursive = 0, status;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN); // 기본값: CPU 코어 수
 
     // 옵션 처리
-    while (argv[i] != NULL && argv[i][0] == '-') {
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        }
+        if (strcmp(argv[i], "--build-index") == 0) {
+            // --build-index DIR...: 트라이그램 색인을 만들거나 바뀐 파일만 갱신
+            if (argv[i + 1] == NULL) {
+                fprintf(stderr, "%sgrep: option '--build-index' requires an argument%s\n", COLOR_RED, COLOR_RESET);
+                free_patterns(&pl);
+                free_filter(&flt);
+                return 1;
+            }
+            status = 0;
+            for (i++; argv[i] != NULL; i++)
+                if (grep_index_build(argv[i]) < 0) status = 1;
+            free_patterns(&pl);
+            free_filter(&flt);
+            return status;
+        }
+        if (strcmp(argv[i], "--index") == 0) {
+            // --index: 인자 디렉토리의 색인으로 후보 파일만 검색
+            use_index = 1;
+            i++;
+            continue;
+        }
+        if (strncmp(argv[i], "--include=", 10) == 0 || strncmp(argv[i], "--exclude=", 10) == 0 ||
+            strncmp(argv[i], "--exclude-dir=", 14) == 0) {
+            // -r 이름 거르기 (여러 번 지정 가능)
+            const char *glob = strchr(argv[i], '=') + 1;
+            int r;
+            if (strncmp(argv[i], "--include=", 10) == 0) r = add_glob(&flt.include, &flt.ninclude, glob);
+            else if (strncmp(argv[i], "--exclude=", 10) == 0) r = add_glob(&flt.exclude, &flt.nexclude, glob);
+            else r = add_glob(&flt.exclude_dir, &flt.nexclude_dir, glob);
+            if (r < 0) {
+                fprintf(stderr, "%sgrep: memory exhausted%s\n", COLOR_RED, COLOR_RESET);
+                free_patterns(&pl);
+                free_filter(&flt);
+                return 1;
+            }
+            i++;
+            continue;
+        }
         for (int j = 1; argv[i][j] != '\0'; j++) {
+            if (argv[i][j] == 'j') {
+                // -j N 또는 -jN: 작업자 스레드 수
+                const char *val = (argv[i][j + 1] != '\0') ? &argv[i][j + 1] : argv[++i];
+                if (val == NULL || atoi(val) < 1) {
+                    fprintf(stderr, "%sgrep: invalid number of jobs%s\n", COLOR_RED, COLOR_RESET);
+                    free_patterns(&pl);
+                    free_filter(&flt);
+                    return 1;
+                }
+                jobs = atoi(val);
+                break;
+            }
+            if (argv[i][j] == 'e' || argv[i][j] == 'f') {
+                // -e PAT / -f FILE (여러 번 지정 가능, 붙여 써도 됨: -ePAT)
+                char opt = argv[i][j];
+                const char *val = (argv[i][j + 1] != '\0') ? &argv[i][j + 1] : argv[++i];
+                if (val == NULL) {
+                    fprintf(stderr, "%sgrep: option requires an argument -- '%c'%s\n",
+                            COLOR_RED, opt, COLOR_RESET);
+                    free_patterns(&pl);
+                    free_filter(&flt);
+                    return 1;
+                }
+                if (opt == 'e' && add_pattern(&pl, val, strlen(val)) < 0) {
+                    fprintf(stderr, "%sgrep: memory exhausted%s\n", COLOR_RED, COLOR_RESET);
+                    free_patterns(&pl);
+                    free_filter(&flt);
+                    return 1;
+                }
+                if (opt == 'f' && read_pattern_file(&pl, val) < 0) {
+                    free_patterns(&pl);
+                    free_filter(&flt);
+                    return 1;
+                }
+                have_patterns = 1;
+                break;
+            }
             switch (argv[i][j]) {
-                case 'i': ignore_case = 1; break;
-                case 'n': show_line_numbers = 1; break;
-                case 'v': invert_match = 1; break;
-                case 'c': count_only = 1; break;
-                case 'l': list_files = 1; break;
+                case 'i': opts.ignore_case = 1; break;
+                case 'n': opts.show_line_numbers = 1; break;
+                case 'v': opts.invert_match = 1; break;
+                case 'c': opts.count_only = 1; break;
+                case 'l': opts.list_files = 1; break;
+                case 'r': recursive = 1; break;
+                case 'F': opts.syntax = GREP_FIXED; break;
+                case 'G': opts.syntax = GREP_BASIC; break;
+                case 'E': opts.syntax = GREP_EXTENDED; break;
                 default:
                     fprintf(stderr, "%sgrep: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    free_patterns(&pl);
+                    free_filter(&flt);
                     return 1;
             }
         }
         i++;
     }
 
-    if (argv[i] == NULL) {
-        fprintf(stderr, "%sgrep: missing search pattern%s\n", COLOR_RED, COLOR_RESET);
-        return 1;
+    // -e, -f가 없으면 첫 인자가 패턴
+    if (!have_patterns) {
+        if (argv[i] == NULL) {
+            fprintf(stderr, "%sgrep: missing search pattern%s\n", COLOR_RED, COLOR_RESET);
+            free_filter(&flt);
+            return 1;
+        }
+        if (add_pattern(&pl, argv[i], strlen(argv[i])) < 0) {
+            fprintf(stderr, "%sgrep: memory exhausted%s\n", COLOR_RED, COLOR_RESET);
+            free_patterns(&pl);
+            free_filter(&flt);
+            return 1;
+        }
+        i++;
     }
 
-    char *pattern = argv[i++];
+    status = grep_compile_list(&pat, pl.v, pl.n, opts.ignore_case, opts.syntax);
+    free_patterns(&pl);
+    if (status < 0) {
+        free_filter(&flt);
+        return 1;
+    }
 
-    // 파일 처리 루프
-    for (; argv[i] != NULL; i++) {
-        FILE *fp = fopen(argv[i], "r");
-        if (!fp) {
-            fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, argv[i], strerror(errno), COLOR_RESET);
-            continue;
-        }
+    // 재귀 검색: 줄과 -c 결과에 파일 이름을 붙이고 바이너리 파일은 건너뜀
+    if (recursive) {
+        opts.with_filename = 1;
+        opts.skip_binary = 1;
+        status = grep_recursive(&pat, &opts, &flt, &argv[i], (int)jobs) < 0 ? 1 : 0;
+        free_filter(&flt);
+        grep_free(&pat);
+        return status;
+    }
+    free_filter(&flt);
 
-        char buffer[1024];
-        int line = 1;
-        int match_count = 0;
-        int file_matched = 0;
-
-        while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-            int match = 0;
-            
-            if (ignore_case) {
-                // 대소문자 무시 검색 구현 (임시 버퍼 사용)
-                char line_lower[1024], pat_lower[256];
-                strcpy(line_lower, buffer);
-                strcpy(pat_lower, pattern);
-                for(int k=0; line_lower[k]; k++) line_lower[k] = tolower(line_lower[k]);
-                for(int k=0; pat_lower[k]; k++) pat_lower[k] = tolower(pat_lower[k]);
-                if (strstr(line_lower, pat_lower)) match = 1;
-            } else {
-                if (strstr(buffer, pattern)) match = 1;
-            }
+    // 색인 검색: 인자는 디렉토리 (없으면 현재 디렉토리)
+    if (use_index) {
+        status = 0;
+        if (argv[i] == NULL && grep_index_search(&pat, &opts, ".", (int)jobs, stdout) < 0) status = 1;
+        for (; argv[i] != NULL; i++)
+            if (grep_index_search(&pat, &opts, argv[i], (int)jobs, stdout) < 0) status = 1;
+        grep_free(&pat);
+        return status;
+    }
 
-            if (invert_match) match = !match;
+    // 파일이 없으면 stdin 처리 (파이프라인에서 사용)
+    if (argv[i] == NULL) {
+        struct grep_printer pr = { stdout, opts.show_line_numbers };
+        struct grep_state st;
 
-            if (match) {
-                match_count++;
-                file_matched = 1;
-                if (!count_only && !list_files) {
-                    if (show_line_numbers) printf("%6d: ", line);
-                    fputs(buffer, stdout);
-                }
-            }
-            line++;
-        }
+        grep_state_init(&st);
+        if (grep_fd(&pat, &opts, STDIN_FILENO, &st, grep_print_line, &pr) < 0)
+            fprintf(stderr, "%sgrep: (standard input): %s%s\n", COLOR_RED, strerror(errno), COLOR_RESET);
+        grep_report(&opts, NULL, st.count, stdout);
+    }
 
-        if (count_only) printf("%d\n", match_count);
-        if (list_files && file_matched) printf("%s\n", argv[i]);
+    // 여러 파일(또는 큰 파일)은 작업자 풀로 동시에 검색, 출력은 인자 순서 유지
+    if (argv[i] != NULL && jobs > 1 &&
+        grep_parallel(&pat, &opts, &argv[i], argc - i, (int)jobs, stdout) == 0) {
+        grep_free(&pat);
+        return 0;
+    }
 
-        fclose(fp);
+    // 파일 처리 루프 (-j 1)
+    for (; argv[i] != NULL; i++) {
+        grep_path(&pat, &opts, argv[i], stdout);
     }
+
+    grep_free(&pat);
     return 0;
 }
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return grep_main(argc, argv);
+}
+#endif
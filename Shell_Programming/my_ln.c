@@ -1,19 +1,182 @@
 /* my_ln.c */
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "applets.h"
 
 #define COLOR_RED    "\x1b[31m"
 #define COLOR_RESET  "\x1b[0m"
 
-int main(int argc, char *argv[]) {
-    if (argc != 3) {
+/* ln 옵션 */
+struct ln_opts {
+    int symbolic;     // -s: 심볼릭 링크
+    int force;        // -f: 대상이 있으면 원자적으로 교체
+    int no_deref;     // -n: 디렉토리를 가리키는 심볼릭 링크 대상을 디렉토리로 보지 않음
+    int verbose;      // -v
+};
+
+/* 대상 디렉토리 안의 같은 이름 ("dir/base") */
+static char *path_in_dir(const char *dir, const char *src) {
+    size_t len = strlen(src);
+    const char *base;
+    char *path;
+
+    while (len > 1 && src[len - 1] == '/') len--;
+    base = memrchr(src, '/', len);
+    base = (base != NULL) ? base + 1 : src;
+    len -= base - src;
+
+    size_t dlen = strlen(dir);
+    path = malloc(dlen + len + 2);
+    if (path == NULL) return NULL;
+    sprintf(path, "%s%s%.*s", dir, (dlen > 0 && dir[dlen - 1] == '/') ? "" : "/", (int)len, base);
+    return path;
+}
+
+/* 두 경로가 같은 디렉토리 항목인지 (부모 디렉토리와 마지막 이름이 모두 같은지) */
+static int same_entry(const char *a, const char *b) {
+    const char *ba = strrchr(a, '/'), *bb = strrchr(b, '/');
+    char *da = (ba != NULL) ? strndup(a, ba - a + 1) : strdup(".");
+    char *db = (bb != NULL) ? strndup(b, bb - b + 1) : strdup(".");
+    struct stat sa, sb;
+    int same;
+
+    ba = (ba != NULL) ? ba + 1 : a;
+    bb = (bb != NULL) ? bb + 1 : b;
+    same = da != NULL && db != NULL && strcmp(ba, bb) == 0 &&
+           stat(da, &sa) == 0 && stat(db, &sb) == 0 &&
+           sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+    free(da);
+    free(db);
+    return same;
+}
+
+/* 링크 하나 만들기 (dst가 없을 때) */
+static int make_link(const char *src, const char *dst, const struct ln_opts *opts) {
+    return opts->symbolic ? symlink(src, dst) : linkat(AT_FDCWD, src, AT_FDCWD, dst, 0);
+}
+
+/*
+ * 링크 생성 함수
+ * 설명: -f이면 같은 디렉토리에 임시 이름으로 링크를 만든 뒤 rename으로 덮어쓰므로
+ *       대상이 없는 순간이 생기지 않습니다 (ln -sfn 으로 배포 심볼릭 링크 교체).
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+static int link_one(const char *src, const char *dst, const struct ln_opts *opts) {
+    int r = make_link(src, dst, opts);
+
+    if (r < 0 && errno == EEXIST && opts->force) {
+        struct stat ss, ds;
+
+        // 이미 같은 파일의 하드 링크이면 rename이 아무 일도 하지 않아 임시 링크가 남으므로
+        // 먼저 처리: 같은 디렉토리 항목이면 오류, 다른 이름이면 이미 원하는 상태 (coreutils와 동일)
+        if (!opts->symbolic && lstat(src, &ss) == 0 && lstat(dst, &ds) == 0 &&
+                ss.st_dev == ds.st_dev && ss.st_ino == ds.st_ino) {
+            if (same_entry(src, dst)) {
+                fprintf(stderr, "%sln: '%s' and '%s' are the same file%s\n", COLOR_RED, src, dst, COLOR_RESET);
+                return -1;
+            }
+            r = 0;
+        } else {
+            char *tmp = malloc(strlen(dst) + 32);
+            if (tmp == NULL) {
+                errno = ENOMEM;
+            } else {
+                for (int attempt = 0; attempt < 100; attempt++) {
+                    sprintf(tmp, "%s.ln%d.%d", dst, (int)getpid(), attempt);
+                    r = make_link(src, tmp, opts);
+                    if (r == 0 || errno != EEXIST) break;
+                }
+                if (r == 0 && (r = rename(tmp, dst)) < 0) {
+                    int err = errno;
+                    unlink(tmp);
+                    errno = err;
+                } else if (r == 0 && !opts->symbolic) {
+                    unlink(tmp);   // 검사 뒤에 dst가 같은 파일로 바뀌었으면 rename이 tmp를 남김
+                }
+                free(tmp);
+            }
+        }
+    }
+
+    if (r < 0) {
+        fprintf(stderr, "%sln: failed to create %s link '%s' -> '%s': %s%s\n", COLOR_RED,
+                opts->symbolic ? "symbolic" : "hard", dst, src, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+    if (opts->verbose) printf("'%s' %s '%s'\n", dst, opts->symbolic ? "->" : "=>", src);
+    return 0;
+}
+
+int ln_main(int argc, char *argv[]) {
+    struct ln_opts opts = { 0 };
+    struct stat st;
+    int status = 0;
+    int i = 1;
+
+    // 옵션 처리 (-s: 심볼릭 링크, -f: 교체, -n: 링크를 디렉토리로 따라가지 않음, -v: 자세히)
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        }
+        for (int j = 1; argv[i][j] != '\0'; j++) {
+            switch (argv[i][j]) {
+                case 's': opts.symbolic = 1; break;
+                case 'f': opts.force = 1; break;
+                case 'n': opts.no_deref = 1; break;
+                case 'v': opts.verbose = 1; break;
+                default:
+                    fprintf(stderr, "%sln: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    return 1;
+            }
+        }
+        i++;
+    }
+
+    int nargs = argc - i;
+    if (nargs < 1) {
         fprintf(stderr, "%sln: missing file operand%s\n", COLOR_RED, COLOR_RESET);
+        fprintf(stderr, "Usage: %s [-s] [-f] [-n] [-v] <target>... [link name | directory]\n", argv[0]);
         return 1;
     }
-    if (link(argv[1], argv[2]) < 0) {
-        perror("ln");
+
+    // 인자가 하나면 현재 디렉토리에 같은 이름으로
+    const char *dst = nargs == 1 ? "." : argv[argc - 1];
+    int nsrc = nargs == 1 ? 1 : nargs - 1;
+    int r = opts.no_deref ? lstat(dst, &st) : stat(dst, &st);
+    int into_dir = r == 0 && S_ISDIR(st.st_mode);
+
+    if (nsrc > 1 && !into_dir) {
+        fprintf(stderr, "%sln: target '%s' is not a directory%s\n", COLOR_RED, dst, COLOR_RESET);
         return 1;
     }
-    return 0;
+
+    for (int k = 0; k < nsrc; k++) {
+        const char *src = argv[i + k];
+        if (!into_dir) {
+            if (link_one(src, dst, &opts) < 0) status = 1;
+            continue;
+        }
+        char *target = path_in_dir(dst, src);
+        if (target == NULL) {
+            perror("ln");
+            return 1;
+        }
+        if (link_one(src, target, &opts) < 0) status = 1;
+        free(target);
+    }
+    return status;
 }
 
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return ln_main(argc, argv);
+}
+#endif
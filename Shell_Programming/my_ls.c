@@ -1,23 +1,59 @@
 /* my_ls.c */
 #include <stdio.h>
-#include <dirent.h>
-#include <sys/types.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
 
-int main() {
-    DIR *dir;
-    struct dirent *entry;
+#include "ls_core.h"
+#include "applets.h"
 
-    dir = opendir(".");
-    if (dir == NULL) {
-        perror("opendir");
-        return 1;
-    }
-    while ((entry = readdir(dir)) != NULL) {
-        if (entry->d_name[0] != '.') { // 숨김 파일 제외
-            printf("%s  ", entry->d_name);
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+int ls_main(int argc, char *argv[]) {
+    struct ls_opts opts = { 0 };
+    struct winsize ws;
+    int i = 1;
+
+    opts.jobs = (int)sysconf(_SC_NPROCESSORS_ONLN) * 2; // 기본값: 코어 수의 2배 (I/O 대기 고려)
+
+    // 옵션 처리 (-a: 숨김 파일 포함, -l: 자세히, -R: 하위 디렉토리, -1: 한 줄에 하나, -j N: statx 스레드 수)
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        for (int j = 1; argv[i][j] != '\0'; j++) {
+            if (argv[i][j] == 'j') {
+                const char *val = (argv[i][j + 1] != '\0') ? &argv[i][j + 1] : argv[++i];
+                if (val == NULL || atoi(val) < 1) {
+                    fprintf(stderr, "%sls: invalid number of jobs%s\n", COLOR_RED, COLOR_RESET);
+                    return 2;
+                }
+                opts.jobs = atoi(val);
+                break;
+            }
+            switch (argv[i][j]) {
+                case 'a': opts.all = 1; break;
+                case 'l': opts.long_format = 1; break;
+                case 'R': opts.recursive = 1; break;
+                case '1': opts.one_per_line = 1; break;
+                default:
+                    fprintf(stderr, "%sls: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    fprintf(stderr, "Usage: %s [-alR1] [-j N] [file...]\n", argv[0]);
+                    return 2;
+            }
         }
+        i++;
     }
-    printf("\n");
-    closedir(dir);
-    return 0;
+
+    // 터미널이면 폭에 맞춰 여러 열로, 아니면 한 줄에 하나씩 출력
+    if (isatty(STDOUT_FILENO)) {
+        opts.width = 80;
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0) opts.width = ws.ws_col;
+    }
+
+    return ls_run(&argv[i], argc - i, &opts) ? 1 : 0;
+}
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return ls_main(argc, argv);
 }
+#endif
@@ -1,17 +1,73 @@
 /* my_mkdir.c */
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
-int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "사용법: %s <디렉토리명>\n", argv[0]);
-        return 1;
+#include "applets.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+/*
+ * 상위 디렉토리까지 만드는 함수 (-p)
+ * 설명: 경로의 '/'마다 잘라서 차례로 mkdir 하며, 이미 있는 디렉토리는 오류로 보지 않습니다.
+ * 반환값: 0(성공), -1(실패, errno 설정)
+ */
+static int make_parents(char *path) {
+    for (char *p = path + 1; *p != '\0'; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        int r = mkdir(path, 0755);
+        *p = '/';
+        if (r == -1 && errno != EEXIST) return -1;
     }
-    // 0755 권한으로 디렉토리 생성
-    if (mkdir(argv[1], 0755) == -1) {
-        perror("mkdir");
-        return 1;
+    if (mkdir(path, 0755) == -1) {
+        struct stat st;
+        if (errno != EEXIST || stat(path, &st) == -1 || !S_ISDIR(st.st_mode)) return -1;
     }
     return 0;
 }
+
+int mkdir_main(int argc, char *argv[]) {
+    int parents = 0;
+    int status = 0;
+    int i = 1;
+
+    // 옵션 처리 (-p: 상위 디렉토리도 만들고, 이미 있으면 무시)
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        }
+        for (int j = 1; argv[i][j] != '\0'; j++) {
+            switch (argv[i][j]) {
+                case 'p': parents = 1; break;
+                default:
+                    fprintf(stderr, "%smkdir: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    return 1;
+            }
+        }
+        i++;
+    }
+    if (argv[i] == NULL) {
+        fprintf(stderr, "사용법: %s [-p] <디렉토리명>...\n", argv[0]);
+        return 1;
+    }
+
+    for (; argv[i] != NULL; i++) {
+        // 0755 권한으로 디렉토리 생성
+        if ((parents ? make_parents(argv[i]) : mkdir(argv[i], 0755)) == -1) {
+            perror("mkdir");
+            status = 1;
+        }
+    }
+    return status;
+}
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return mkdir_main(argc, argv);
+}
+#endif
@@ -1,18 +1,252 @@
 /* my_mv.c */
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "copy_core.h"
+#include "remove_core.h"
+#include "applets.h"
 
 #define COLOR_RED    "\x1b[31m"
 #define COLOR_RESET  "\x1b[0m"
 
-int main(int argc, char *argv[]) {
-    if (argc != 3) {
+/* mv 옵션 */
+struct mv_opts {
+    unsigned flags;   // renameat2 플래그 (RENAME_NOREPLACE, RENAME_EXCHANGE)
+    int verbose;      // -v: 옮긴 항목과 방법 출력
+    int jobs;         // 다른 파일 시스템으로 디렉토리를 옮길 때 복사/삭제 스레드 수
+};
+
+/* 대상 디렉토리 안의 같은 이름 ("dir/base") */
+static char *path_in_dir(const char *dir, const char *src) {
+    size_t len = strlen(src);
+    const char *base;
+    char *path;
+
+    while (len > 1 && src[len - 1] == '/') len--;   // "a/" -> "a"
+    base = memrchr(src, '/', len);
+    base = (base != NULL) ? base + 1 : src;
+    len -= base - src;
+
+    size_t dlen = strlen(dir);
+    path = malloc(dlen + len + 2);
+    if (path == NULL) return NULL;
+    sprintf(path, "%s%s%.*s", dir, (dlen > 0 && dir[dlen - 1] == '/') ? "" : "/", (int)len, base);
+    return path;
+}
+
+static void mv_error(const char *src, const char *dst, int err) {
+    fprintf(stderr, "%smv: cannot move '%s' to '%s': %s%s\n", COLOR_RED, src, dst, strerror(err), COLOR_RESET);
+}
+
+/*
+ * 파일 시스템을 넘어 일반 파일 옮기기
+ * 설명: copy_fd(reflink -> copy_file_range -> sendfile -> read/write)로 복사하고
+ *       권한, 소유자, 시간을 옮긴 뒤 원본을 지웁니다.
+ */
+static int move_file(const char *src, const char *dst, const struct stat *st, const struct mv_opts *opts) {
+    int method;
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    int src_fd, dst_fd, err = 0;
+
+    if (opts->flags & RENAME_NOREPLACE) flags |= O_EXCL;
+
+    src_fd = open(src, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (src_fd < 0) {
+        mv_error(src, dst, errno);
+        return -1;
+    }
+    dst_fd = open(dst, flags, 0600);
+    if (dst_fd < 0) {
+        mv_error(src, dst, errno);
+        close(src_fd);
+        return -1;
+    }
+
+    if (copy_fd(src_fd, dst_fd, st, &method) < 0) {
+        err = errno;
+    } else {
+        struct timespec times[2] = { st->st_atim, st->st_mtim };
+        // 소유자는 권한이 있을 때만 유지 (일반 사용자는 EPERM)
+        if (fchown(dst_fd, st->st_uid, st->st_gid) < 0 && errno != EPERM) err = errno;
+        if (err == 0 && (fchmod(dst_fd, st->st_mode & 07777) < 0 || futimens(dst_fd, times) < 0)) err = errno;
+    }
+    close(src_fd);
+    if (close(dst_fd) < 0 && err == 0) err = errno;
+
+    if (err != 0) {
+        mv_error(src, dst, err);
+        unlink(dst);
+        return -1;
+    }
+    if (opts->verbose) printf("copied '%s' -> '%s' (%s)\n", src, dst, copy_method_name(method));
+    if (unlink(src) < 0) {
+        fprintf(stderr, "%smv: cannot remove '%s': %s%s\n", COLOR_RED, src, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+    return 0;
+}
+
+/* 파일 시스템을 넘어 심볼릭 링크 옮기기 (같은 내용의 링크를 다시 만듦) */
+static int move_symlink(const char *src, const char *dst, const struct stat *st, const struct mv_opts *opts) {
+    char *target = malloc(st->st_size + 1);
+    ssize_t n;
+
+    if (target == NULL || (n = readlink(src, target, st->st_size + 1)) < 0) {
+        mv_error(src, dst, target == NULL ? ENOMEM : errno);
+        free(target);
+        return -1;
+    }
+    target[n] = '\0';
+
+    if (!(opts->flags & RENAME_NOREPLACE)) unlink(dst);
+    if (symlink(target, dst) < 0) {
+        mv_error(src, dst, errno);
+        free(target);
+        return -1;
+    }
+    free(target);
+    if (unlink(src) < 0) {
+        fprintf(stderr, "%smv: cannot remove '%s': %s%s\n", COLOR_RED, src, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+    return 0;
+}
+
+/* 파일 시스템을 넘어 디렉토리 옮기기: 트리를 병렬 복사한 뒤 원본 트리를 병렬 삭제 */
+static int move_dir(const char *src, const char *dst, const struct mv_opts *opts) {
+    struct copy_tree_opts copts = { opts->jobs, opts->verbose };
+    struct remove_opts ropts = { 1, 0, opts->jobs };
+    struct stat st;
+
+    if (lstat(dst, &st) == 0) {
+        if (opts->flags & RENAME_NOREPLACE) {
+            mv_error(src, dst, EEXIST);
+            return -1;
+        }
+        // rename과 같이 비어 있는 디렉토리만 덮어씀
+        if (!S_ISDIR(st.st_mode) || rmdir(dst) < 0) {
+            mv_error(src, dst, S_ISDIR(st.st_mode) ? errno : ENOTDIR);
+            return -1;
+        }
+    }
+    if (copy_tree(src, dst, &copts) > 0) {
+        fprintf(stderr, "%smv: '%s' was not removed because copying failed%s\n", COLOR_RED, src, COLOR_RESET);
+        return -1;
+    }
+    return remove_path(src, &ropts) > 0 ? -1 : 0;
+}
+
+/*
+ * 항목 하나 옮기기
+ * 설명: renameat2로 원자적으로 옮깁니다 (-n: 대상이 있으면 실패, -x: 두 항목 교환).
+ *       다른 파일 시스템이라 EXDEV가 나면 복사 후 삭제로 대신합니다.
+ * 반환값: 0(성공), -1(실패, 오류 메시지 출력됨)
+ */
+static int move_one(const char *src, const char *dst, const struct mv_opts *opts) {
+    struct stat st;
+    int r = opts->flags ? renameat2(AT_FDCWD, src, AT_FDCWD, dst, opts->flags)
+                        : rename(src, dst);
+
+    if (r == 0) {
+        if (opts->verbose)
+            printf("%s '%s' -> '%s'\n", (opts->flags & RENAME_EXCHANGE) ? "exchanged" : "renamed", src, dst);
+        return 0;
+    }
+    if (errno != EXDEV || (opts->flags & RENAME_EXCHANGE)) {
+        mv_error(src, dst, errno);
+        return -1;
+    }
+
+    // 다른 파일 시스템: 종류별로 복사 후 원본 삭제
+    if (lstat(src, &st) < 0) {
+        mv_error(src, dst, errno);
+        return -1;
+    }
+    if (S_ISDIR(st.st_mode)) return move_dir(src, dst, opts);
+    if (S_ISLNK(st.st_mode)) return move_symlink(src, dst, &st, opts);
+    if (S_ISREG(st.st_mode)) return move_file(src, dst, &st, opts);
+    mv_error(src, dst, EXDEV);
+    return -1;
+}
+
+int mv_main(int argc, char *argv[]) {
+    struct mv_opts opts = { 0, 0, (int)sysconf(_SC_NPROCESSORS_ONLN) * 2 };
+    struct stat st;
+    int status = 0;
+    int i = 1;
+
+    // 옵션 처리 (-n: 덮어쓰지 않음, -x: 두 경로를 원자적으로 교환, -v: 자세히)
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        }
+        for (int j = 1; argv[i][j] != '\0'; j++) {
+            switch (argv[i][j]) {
+                case 'n': opts.flags |= RENAME_NOREPLACE; break;
+                case 'x': opts.flags |= RENAME_EXCHANGE; break;
+                case 'v': opts.verbose = 1; break;
+                default:
+                    fprintf(stderr, "%smv: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    return 1;
+            }
+        }
+        i++;
+    }
+
+    int nargs = argc - i;
+    if (nargs < 2) {
         fprintf(stderr, "%smv: missing file operand%s\n", COLOR_RED, COLOR_RESET);
+        fprintf(stderr, "Usage: %s [-n | -x] [-v] <source>... <destination>\n", argv[0]);
         return 1;
     }
-    if (rename(argv[1], argv[2]) < 0) {
-        perror("mv");
+    if (opts.flags == (RENAME_NOREPLACE | RENAME_EXCHANGE)) {
+        fprintf(stderr, "%smv: -n and -x cannot be used together%s\n", COLOR_RED, COLOR_RESET);
         return 1;
     }
-    return 0;
+
+    const char *dst = argv[argc - 1];
+
+    // -x: 정확히 두 경로를 서로 바꿈 (배포 시 디렉토리 원자적 교체)
+    if (opts.flags & RENAME_EXCHANGE) {
+        if (nargs != 2) {
+            fprintf(stderr, "%smv: -x requires exactly two operands%s\n", COLOR_RED, COLOR_RESET);
+            return 1;
+        }
+        return move_one(argv[i], dst, &opts) < 0 ? 1 : 0;
+    }
+
+    // 대상이 디렉토리면 그 안으로, 원본이 여럿이면 대상은 반드시 디렉토리
+    int into_dir = stat(dst, &st) == 0 && S_ISDIR(st.st_mode);
+    if (nargs > 2 && !into_dir) {
+        fprintf(stderr, "%smv: target '%s' is not a directory%s\n", COLOR_RED, dst, COLOR_RESET);
+        return 1;
+    }
+
+    for (; i < argc - 1; i++) {
+        if (!into_dir) {
+            if (move_one(argv[i], dst, &opts) < 0) status = 1;
+            continue;
+        }
+        char *target = path_in_dir(dst, argv[i]);
+        if (target == NULL) {
+            perror("mv");
+            return 1;
+        }
+        if (move_one(argv[i], target, &opts) < 0) status = 1;
+        free(target);
+    }
+    return status;
+}
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return mv_main(argc, argv);
 }
+#endif
@@ -2,9 +2,11 @@
 #include <stdio.h>
 #include <unistd.h>
 
+#include "applets.h"
+
 #define MAX_PATH 1024
 
-int main() {
+int pwd_main(int argc, char *argv[]) {
     char cwd[MAX_PATH];
     if (getcwd(cwd, sizeof(cwd)) != NULL) {
         printf("%s\n", cwd);
@@ -14,3 +16,9 @@ int main() {
     }
     return 0;
 }
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return pwd_main(argc, argv);
+}
+#endif
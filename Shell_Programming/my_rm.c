@@ -1,24 +1,65 @@
 /* my_rm.c */
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
 
+#include "remove_core.h"
+#include "applets.h"
+
 #define COLOR_RED    "\x1b[31m"
 #define COLOR_RESET  "\x1b[0m"
 
-int main(int argc, char *argv[]) {
-    if (argc < 2) {
+int rm_main(int argc, char *argv[]) {
+    struct remove_opts opts = { 0 };
+    int status = 0;
+    int i = 1;
+
+    opts.jobs = (int)sysconf(_SC_NPROCESSORS_ONLN) * 2; // 기본값: 코어 수의 2배 (I/O 대기 고려)
+
+    // 옵션 처리 (-r: 디렉토리 트리 삭제, -f: 없는 파일 무시, -j N: 삭제 스레드 수)
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        }
+        for (int j = 1; argv[i][j] != '\0'; j++) {
+            if (argv[i][j] == 'j') {
+                const char *val = (argv[i][j + 1] != '\0') ? &argv[i][j + 1] : argv[++i];
+                if (val == NULL || atoi(val) < 1) {
+                    fprintf(stderr, "%srm: invalid number of jobs%s\n", COLOR_RED, COLOR_RESET);
+                    return 1;
+                }
+                opts.jobs = atoi(val);
+                break;
+            }
+            switch (argv[i][j]) {
+                case 'r':
+                case 'R': opts.recursive = 1; break;
+                case 'f': opts.force = 1; break;
+                default:
+                    fprintf(stderr, "%srm: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    return 1;
+            }
+        }
+        i++;
+    }
+
+    if (argv[i] == NULL) {
+        if (opts.force) return 0;
         fprintf(stderr, "%srm: missing operand%s\n", COLOR_RED, COLOR_RESET);
         return 1;
     }
 
-    int i = 1;
-    while (argv[i] != NULL) {
-        if (unlink(argv[i]) < 0) {
-            fprintf(stderr, "rm: cannot remove '%s': %s\n", argv[i], strerror(errno));
-        }
-        i++;
+    for (; argv[i] != NULL; i++) {
+        if (remove_path(argv[i], &opts) > 0) status = 1;
     }
-    return 0;
+    return status;
+}
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return rm_main(argc, argv);
 }
+#endif
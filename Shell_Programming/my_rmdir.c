@@ -1,16 +1,41 @@
 /* my_rmdir.c */
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 
-int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "사용법: %s <디렉토리명>\n", argv[0]);
+#include "applets.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+int rmdir_main(int argc, char *argv[]) {
+    int status = 0;
+    int i = 1;
+
+    // 옵션은 없음: "--" 뒤는 '-'로 시작해도 디렉토리명
+    if (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        if (strcmp(argv[i], "--") != 0) {
+            fprintf(stderr, "%srmdir: invalid option -- '%c'%s\n", COLOR_RED, argv[i][1], COLOR_RESET);
+            return 1;
+        }
+        i++;
+    }
+    if (argv[i] == NULL) {
+        fprintf(stderr, "사용법: %s <디렉토리명>...\n", argv[0]);
         return 1;
     }
     // 디렉토리 삭제 (비어있어야 함)
-    if (rmdir(argv[1]) == -1) {
-        perror("rmdir");
-        return 1;
+    for (; i < argc; i++) {
+        if (rmdir(argv[i]) == -1) {
+            perror("rmdir");
+            status = 1;
+        }
     }
-    return 0;
+    return status;
+}
+
+#ifndef MULTICALL
+int main(int argc, char *argv[]) {
+    return rmdir_main(argc, argv);
 }
+#endif
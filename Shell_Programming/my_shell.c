@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -8,11 +9,16 @@
 #include <signal.h>
 #include <errno.h>
 #include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-/* --- 매크로 상수 정의 --- */
-#define MAX_CMD_LEN  1024   // 최대 명령어 길이
-#define MAX_ARG      64     // 최대 인자 개수
-#define DELIMITERS   " \t\n" // 토큰 구분자 (공백, 탭, 개행)
+#include "path_hash.h"
+#include "launch.h"
+#include "jobs.h"
+#include "profile.h"
+#include "shell_parser.h"
+#include "parallel.h"
+#include "applets.h"
 
 /* --- 텍스트 색상 정의 (ANSI Escape Codes) --- */
 #define COLOR_RESET  "\x1b[0m"
@@ -22,7 +28,11 @@
 #define COLOR_YELLOW "\x1b[33m"
 
 /* --- 전역 변수 --- */
-// (없음 - 가능한 지역 변수 사용 지향)
+static int launcher_mode = LAUNCH_SPAWN; // 외부 명령어 실행 방식 (MYSHELL_LAUNCHER)
+static int use_applets = 1;              // cat, grep, my_ls 등을 쉘 안에서 실행 (MYSHELL_APPLETS=0 이면 외부 프로그램)
+static int interactive = 1;              // 0이면 스크립트/-c 모드 (프롬프트, 배너 없음)
+static int last_status = 0;              // 마지막 명령어의 종료 상태
+static struct shell_parser parser;       // 줄마다 아레나를 재사용하는 명령어 파서
 
 /*
  * 함수 프로토타입 선언
@@ -33,45 +43,248 @@ void handle_sigint(int signo);
 void print_prompt();
 void print_welcome_msg();
 void print_help();
-int tokenize_command(char *cmd_line, char *argv[]);
-int check_background(char *argv[], int argc);
-void handle_redirection(char *argv[]);
-void execute_builtin_cd(char *argv[]);
-void execute_single_command(char *argv[], int is_bg);
-void execute_piped_command(char *cmd1[], char *cmd2[], int is_bg);
-void process_command_line(char *cmd_line);
-void execute_builtin_cat(char *argv[]);
-void execute_builtin_grep(char *argv[]);
+int execute_builtin_exit(char *argv[]);
+int execute_builtin_help(char *argv[]);
+int execute_builtin_cd(char *argv[]);
+int find_builtin(const char *name);
+const struct applet *find_applet(const char *name);
+int is_builtin(const char *name);
+int run_builtin(char *argv[]);
+int execute_builtin_in_shell(const struct ast_command *cmd);
+int execute_builtin_hash(char *argv[]);
+int execute_builtin_jobs(char *argv[]);
+int execute_builtin_fg(char *argv[]);
+int execute_builtin_bg(char *argv[]);
+int execute_builtin_wait(char *argv[]);
+int execute_builtin_parallel(char *argv[]);
+int decode_status(int status);
+char *format_pipeline(const struct ast_pipeline *pl);
+int execute_pipeline(const struct ast_pipeline *pl, int is_bg);
+int execute_and_or(const struct ast_and_or *ao);
+int execute_background_and_or(const struct ast_and_or *ao);
+int execute_list(const struct ast_list *list);
+int process_command_line(char *cmd_line, line_reader next, void *ctx);
+void run_buffer(char *buf, size_t len);
+int run_script(const char *path);
+
+/*
+ * 내장 명령어 표
+ * 설명: 파이프라인의 한 단계로 쓰이거나 재지향/백그라운드와 함께 쓰여도
+ *       외부 프로그램 대신 이 함수들이 실행됩니다.
+ *       cat, grep과 my_ls, my_cp 등 유틸리티는 applets.c의 애플릿 표에서 찾습니다.
+ */
+struct builtin {
+    const char *name;
+    int (*fn)(char *argv[]);
+};
+
+static const struct builtin builtins[] = {
+    { "exit", execute_builtin_exit },
+    { "help", execute_builtin_help },
+    { "cd",   execute_builtin_cd },
+    { "hash", execute_builtin_hash },
+    { "jobs", execute_builtin_jobs },
+    { "fg",   execute_builtin_fg },
+    { "bg",   execute_builtin_bg },
+    { "wait", execute_builtin_wait },
+    { "parallel", execute_builtin_parallel },
+};
+
+#define NUM_BUILTINS (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+/* 대화형 입력에서 here 문서 본문을 읽는 상태 */
+struct prompt_reader {
+    char *line;
+    size_t cap;
+};
+
+/*
+ * here 문서 본문 한 줄 읽기 함수 (대화형 모드)
+ * 설명: 보조 프롬프트 "> "를 출력하고 표준 입력에서 한 줄을 읽습니다.
+ * 반환값: 개행을 뺀 줄 (EOF면 NULL)
+ */
+static char *prompt_next_line(void *ctx) {
+    struct prompt_reader *r = ctx;
+    ssize_t n;
+
+    printf("> ");
+    fflush(stdout);
+    n = getline(&r->line, &r->cap, stdin);
+    if (n < 0) return NULL;
+    if (n > 0 && r->line[n - 1] == '\n') r->line[n - 1] = '\0';
+    return r->line;
+}
 
 /*
  * ======================================================================================
  * main 함수: 쉘의 진입점
  * ======================================================================================
  */
-int main() {
-    char cmd_line[MAX_CMD_LEN];
+int main(int argc, char *argv[]) {
+    char *cmd_line = NULL;
+    size_t cap = 0;
+    struct prompt_reader heredoc_input = { NULL, 0 };
+    const char *applets_env = getenv("MYSHELL_APPLETS");
+
+    launcher_mode = launch_default_mode();
+    if (applets_env != NULL && strcmp(applets_env, "0") == 0) use_applets = 0;
+    parser_init(&parser);
+    if (profile_init() > 0) jobs_set_done_hook(profile_job);
+
+    // 0. 비대화형 모드: my_shell -c '명령어' 또는 my_shell 스크립트
+    //    프롬프트, 배너, SIGINT 핸들러 없이 실행하고 마지막 종료 상태를 돌려줌
+    if (argc > 1) {
+        interactive = 0;
+        jobs_init(0);
+        if (strcmp(argv[1], "-c") == 0) {
+            if (argc < 3) {
+                fprintf(stderr, "%smy_shell: -c: option requires an argument%s\n",
+                        COLOR_RED, COLOR_RESET);
+                return 2;
+            }
+            run_buffer(argv[2], strlen(argv[2]));
+            return last_status;
+        }
+        return run_script(argv[1]);
+    }
 
     // 1. 초기화: 시그널 핸들러 설정 및 환영 메시지 출력
+    //    (터미널에서 실행되면 작업마다 프로세스 그룹을 만들고 전경 그룹을 전환)
     setup_signal_handlers();
+    jobs_init(isatty(STDIN_FILENO));
     print_welcome_msg();
 
     // 2. 메인 루프 (REPL: Read-Eval-Print Loop)
     while (1) {
-        // 프롬프트 출력
+        // 끝나거나 정지한 배경 작업을 알린 뒤 프롬프트 출력
+        jobs_notify(stdout);
         print_prompt();
 
-        // 사용자 입력 대기 (fgets 사용으로 버퍼 오버플로우 방지)
-        if (fgets(cmd_line, MAX_CMD_LEN, stdin) == NULL) {
+        // 사용자 입력 대기 (getline 사용으로 길이 제한 없음)
+        if (getline(&cmd_line, &cap, stdin) < 0) {
             // EOF(Ctrl-D) 입력 시 정상 종료
             printf("\n%s로그아웃 (EOF detected).%s\n", COLOR_YELLOW, COLOR_RESET);
             break;
         }
 
         // 입력된 명령어 처리 위임
-        process_command_line(cmd_line);
+        last_status = process_command_line(cmd_line, prompt_next_line, &heredoc_input);
     }
 
-    return 0;
+    free(cmd_line);
+    free(heredoc_input.line);
+    return last_status;
+}
+
+/* 스크립트/-c 버퍼를 줄 단위로 읽는 상태 */
+struct buffer_reader {
+    char *p;
+    char *end;
+    char *tail;     // 개행 없는 마지막 줄의 복사본
+};
+
+/*
+ * 버퍼에서 다음 줄 꺼내기 함수
+ * 설명: 개행 자리에 NUL을 써서 복사 없이 돌려줍니다. 개행 없는 마지막 줄은
+ *       버퍼 끝에 NUL을 쓸 수 없으므로 복사합니다.
+ *       명령어 줄과 here 문서 본문이 같은 함수로 읽힙니다.
+ * 반환값: 줄 (더 없으면 NULL)
+ */
+static char *buffer_next_line(void *ctx) {
+    struct buffer_reader *r = ctx;
+    char *line = r->p;
+    char *nl;
+
+    if (r->p >= r->end) return NULL;
+
+    nl = memchr(line, '\n', r->end - line);
+    if (nl != NULL) {
+        *nl = '\0';
+        r->p = nl + 1;
+        return line;
+    }
+
+    free(r->tail);
+    r->tail = strndup(line, r->end - line);
+    if (r->tail == NULL) perror("malloc failed");
+    r->p = r->end;
+    return r->tail;
+}
+
+/*
+ * 명령어 버퍼 실행 함수 (스크립트, -c 모드)
+ * 설명: 버퍼를 줄 단위로 잘라 순서대로 실행합니다. 줄 길이 제한이 없으며,
+ *       here 문서 본문은 명령어 줄 다음 줄부터 같은 버퍼에서 읽습니다.
+ *       '#' 주석(#! 포함)은 파서가 건너뜁니다.
+ */
+void run_buffer(char *buf, size_t len) {
+    struct buffer_reader r = { buf, buf + len, NULL };
+    char *line;
+
+    while ((line = buffer_next_line(&r)) != NULL)
+        last_status = process_command_line(line, buffer_next_line, &r);
+    free(r.tail);
+}
+
+/*
+ * 스크립트 파일 실행 함수
+ * 설명: 일반 파일은 mmap(MAP_PRIVATE)으로 한 번에 매핑하고,
+ *       파이프 등은 전체를 큰 버퍼로 읽어서 run_buffer로 실행합니다.
+ * 반환값: 마지막 명령어의 종료 상태 (파일을 열 수 없으면 127)
+ */
+int run_script(const char *path) {
+    struct stat st;
+    char *buf;
+    size_t len = 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        fprintf(stderr, "%smy_shell: %s: %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+        if (fd >= 0) close(fd);
+        return 127;
+    }
+
+    if (S_ISREG(st.st_mode)) {
+        len = st.st_size;
+        if (len == 0) {
+            close(fd);
+            return 0;
+        }
+        buf = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (buf == MAP_FAILED) {
+            perror("mmap failed");
+            return 1;
+        }
+        madvise(buf, len, MADV_SEQUENTIAL);
+        run_buffer(buf, len);
+        munmap(buf, len);
+        return last_status;
+    }
+
+    // 파이프, 장치: EOF까지 읽어 들임
+    size_t cap = 64 * 1024;
+    buf = malloc(cap);
+    while (buf != NULL) {
+        if (len == cap) {
+            char *grown = realloc(buf, cap * 2);
+            if (grown == NULL) break;
+            buf = grown;
+            cap *= 2;
+        }
+        ssize_t n = read(fd, buf + len, cap - len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        len += n;
+    }
+    close(fd);
+    if (buf == NULL) {
+        perror("malloc failed");
+        return 1;
+    }
+    run_buffer(buf, len);
+    free(buf);
+    return last_status;
 }
 
 /*
@@ -140,105 +353,48 @@ void print_help() {
     printf("   - cd [dir]: Change directory\n");
     printf("   - exit: Exit the shell\n");
     printf("   - help: Show this help message\n");
-    printf("2. External Commands: Supports standard Linux commands (ls, cp, vi...)\n");
+    printf("   - cat, grep, my_cp, my_ln, my_ls, my_mkdir, my_mv, my_pwd, my_rm, my_rmdir: Built-in utilities run without fork/exec\n");
+    printf("     (MYSHELL_APPLETS=0 runs the external programs instead)\n");
+    printf("   - hash [-r | -l | name...]: Show, clear or fill the command path cache\n");
+    printf("   - jobs [-l], fg [%%N], bg [%%N], wait [%%N | pid]: Job control\n");
+    printf("   - parallel [-j N] [-g | -k] cmd {} [::: arg...]: Run cmd for each arg (or stdin line), N at a time\n");
+    printf("2. External Commands: Supports standard Linux commands (vi, make...)\n");
     printf("3. Features:\n");
-    printf("   - Pipe (|): cmd1 | cmd2\n");
-    printf("   - Redirection (<, >): cmd > file, cmd < file\n");
+    printf("   - Pipe (|): cmd1 | cmd2 | ... | cmdN\n");
+    printf("   - Redirection (<, >, >>, 2>, 2>&1, &>, <<<, <<): cmd > file 2>&1, cmd <<< text\n");
     printf("   - Background (&): cmd &\n");
+    printf("   - Lists: cmd1 ; cmd2, cmd1 && cmd2, cmd1 || cmd2\n");
+    printf("   - Quoting: 'single', \"double\", back\\ slash, # comment\n");
+    printf("   - time cmd1 | cmd2: Per-stage real/user/sys, max RSS, context switches\n");
+    printf("   - MYSHELL_PROFILE=file: Append one JSON line per executed command\n");
     printf("--------------------------------\n");
 }
 
 /*
- * 명령어 토큰화 함수
- * 설명: 입력 문자열을 공백 단위로 잘라 argv 배열에 저장합니다.
- * 반환값: 토큰의 개수 (argc)
+ * 내장 명령어 'exit' 실행 함수
  */
-int tokenize_command(char *cmd_line, char *argv[]) {
-    int count = 0;
-    char *token;
+int execute_builtin_exit(char *argv[]) {
+    int status = last_status;
 
-    // 첫 번째 토큰 추출
-    token = strtok(cmd_line, DELIMITERS);
-    
-    while (token != NULL && count < MAX_ARG - 1) {
-        argv[count++] = token;
-        // 다음 토큰 추출
-        token = strtok(NULL, DELIMITERS);
-    }
-    
-    argv[count] = NULL; // 인자 리스트의 끝은 반드시 NULL이어야 함
-    return count;
-}
+    // exit N: 지정한 상태로 종료, 인자가 없으면 마지막 명령어의 상태 사용
+    if (argv[1] != NULL) status = atoi(argv[1]) & 0xff;
 
-/*
- * 백그라운드 실행 확인 함수
- * 설명: 명령어 마지막에 '&'가 있는지 확인하고, 있으면 제거합니다.
- * 반환값: 1(백그라운드), 0(포그라운드)
- */
-int check_background(char *argv[], int argc) {
-    if (argc > 0 && strcmp(argv[argc - 1], "&") == 0) {
-        argv[argc - 1] = NULL; // '&' 기호 제거
-        return 1;
-    }
-    return 0;
+    if (interactive) printf("Goodbye!\n");
+    exit(status);
 }
 
 /*
- * 입출력 재지향 처리 함수
- * 설명: 명령어 인자 중 '<' 또는 '>'를 찾아 파일 디스크립터를 연결합니다.
+ * 내장 명령어 'help' 실행 함수
  */
-void handle_redirection(char *argv[]) {
-    int i;
-    int fd;
-
-    for (i = 0; argv[i] != NULL; i++) {
-        // 1. 입력 재지향 (<)
-        if (strcmp(argv[i], "<") == 0) {
-            argv[i] = NULL; // 기호 제거
-            if (argv[i+1] == NULL) {
-                fprintf(stderr, "Error: No input file specified.\n");
-                exit(EXIT_FAILURE);
-            }
-            
-            // 파일 읽기 전용으로 열기
-            fd = open(argv[i+1], O_RDONLY);
-            if (fd < 0) {
-                perror("open input file failed");
-                exit(EXIT_FAILURE);
-            }
-            
-            // 표준 입력(0)을 파일로 교체
-            dup2(fd, STDIN_FILENO);
-            close(fd);
-            
-            // 파일명 인자 처리 완료 (루프 계속 진행하여 '>'도 찾음)
-        } 
-        // 2. 출력 재지향 (>)
-        else if (strcmp(argv[i], ">") == 0) {
-            argv[i] = NULL; // 기호 제거
-            if (argv[i+1] == NULL) {
-                fprintf(stderr, "Error: No output file specified.\n");
-                exit(EXIT_FAILURE);
-            }
-            
-            // 파일 쓰기 전용으로 열기 (없으면 생성, 있으면 내용 삭제)
-            fd = open(argv[i+1], O_WRONLY | O_CREAT | O_TRUNC, 0644);
-            if (fd < 0) {
-                perror("open output file failed");
-                exit(EXIT_FAILURE);
-            }
-            
-            // 표준 출력(1)을 파일로 교체
-            dup2(fd, STDOUT_FILENO);
-            close(fd);
-        }
-    }
+int execute_builtin_help(char *argv[]) {
+    print_help();
+    return 0;
 }
 
 /*
  * 내장 명령어 'cd' 실행 함수
  */
-void execute_builtin_cd(char *argv[]) {
+int execute_builtin_cd(char *argv[]) {
     char *path = argv[1];
 
     // 인자가 없으면 홈 디렉토리로 이동
@@ -249,409 +405,635 @@ void execute_builtin_cd(char *argv[]) {
     if (chdir(path) < 0) {
         fprintf(stderr, "%scdn: No such file or directory: %s%s\n", 
                 COLOR_RED, path, COLOR_RESET);
+        return 1;
     }
+    return 0;
 }
 
 /*
- * 단일 명령어 실행 함수 (fork-exec 구조)
+ * 내장 명령어 검색 함수
+ * 반환값: builtins 표의 인덱스, 내장 명령어가 아니면 -1
  */
-void execute_single_command(char *argv[], int is_bg) {
-    pid_t pid;
-    int status;
+int find_builtin(const char *name) {
+    for (int k = 0; k < NUM_BUILTINS; k++) {
+        if (strcmp(builtins[k].name, name) == 0) return k;
+    }
+    return -1;
+}
 
-    pid = fork(); // 자식 프로세스 생성
+/*
+ * 애플릿 검색 함수
+ * 설명: 경로 없이 쓴 my_ 이름(my_ls)과 원래 내장 명령어였던 cat, grep만 애플릿으로 봅니다.
+ *       애플릿은 옵션 일부만 지원하므로 ls, cp 같은 맨 이름은 시스템 프로그램을 실행하고
+ *       (ls -lh, cp -a), ./my_ls처럼 경로를 주면 그 파일을 외부 프로그램으로 실행합니다.
+ * 반환값: 애플릿, 아니면 NULL
+ */
+const struct applet *find_applet(const char *name) {
+    if (!use_applets || strchr(name, '/') != NULL) return NULL;
+    if (strncmp(name, "my_", 3) != 0 && strcmp(name, "cat") != 0 && strcmp(name, "grep") != 0)
+        return NULL;
+    return applet_find(name);
+}
 
-    if (pid < 0) {
-        // fork 실패 시
-        perror("fork failed");
-        return;
-    } 
-    else if (pid == 0) {
-        // [자식 프로세스]
-        
-        // 시그널 핸들링: 자식은 기본 동작(종료)을 따름
-        signal(SIGINT, SIG_DFL);
-        signal(SIGQUIT, SIG_DFL);
+/* 내장 명령어 또는 애플릿인지 확인 (fork/exec 없이 실행할 수 있는 명령어) */
+int is_builtin(const char *name) {
+    return find_builtin(name) >= 0 || find_applet(name) != NULL;
+}
 
-        // 재지향 처리 (파일 입출력 연결)
-        handle_redirection(argv);
+/*
+ * 내장 명령어 실행 함수
+ * 설명: 내장 명령어 표에 없으면 애플릿을 같은 프로세스에서 호출합니다.
+ * 반환값: 명령어의 종료 상태
+ */
+int run_builtin(char *argv[]) {
+    int k = find_builtin(argv[0]);
+    const struct applet *a;
 
-        // 명령어 실행
-        if (execvp(argv[0], argv) < 0) {
-            fprintf(stderr, "%s%s: command not found%s\n", 
-                    COLOR_RED, argv[0], COLOR_RESET);
-            exit(EXIT_FAILURE);
-        }
-    } 
-    else {
-        // [부모 프로세스]
-        if (is_bg) {
-            // 백그라운드 실행: 기다리지 않음
-            printf("[%d] %s started in background\n", pid, argv[0]);
-        } else {
-            // 포그라운드 실행: 자식이 끝날 때까지 대기
-            // waitpid를 사용하여 특정 자식만 기다림
-            if (waitpid(pid, &status, 0) < 0) {
-                perror("waitpid failed");
-            }
+    if (k >= 0) return builtins[k].fn(argv);
+    a = find_applet(argv[0]);
+    return (a != NULL) ? applet_run(a, argv) : 127;
+}
+
+/*
+ * 내장 명령어를 쉘 프로세스 안에서 실행하는 함수 (포그라운드, 파이프 없음)
+ * 설명: 재지향되는 fd(2>, 2>&1 포함)만 복제해 두고 재지향을 적용한 뒤 실행하며,
+ *       끝나면 쉘의 원래 fd로 복원합니다. 인자가 없으면 재지향만 수행합니다.
+ */
+int execute_builtin_in_shell(const struct ast_command *cmd) {
+    struct redir_undo small[4];
+    struct redir_undo *undo = small;
+    int status;
+
+    if (cmd->nredirs > 4) {
+        undo = malloc(cmd->nredirs * sizeof(*undo));
+        if (undo == NULL) {
+            perror("malloc failed");
+            return 1;
         }
     }
+
+    if (redir_prepare(cmd->redirs, cmd->nredirs) < 0) {
+        status = 1;
+    } else {
+        if (redir_apply_saved(cmd->redirs, cmd->nredirs, undo) < 0) status = 1;
+        else status = cmd->argc > 0 ? run_builtin(cmd->argv) : 0;
+
+        // 재지향된 출력을 비운 뒤 원래 fd 복원
+        redir_restore(undo, cmd->nredirs);
+        redir_release(cmd->redirs, cmd->nredirs);
+    }
+
+    if (undo != small) free(undo);
+    return status;
 }
 
 /*
- * 파이프라인 명령어 실행 함수 (cmd1 | cmd2)
+ * 내장 명령어 'hash' 실행 함수
+ * 설명: hash (목록), hash -r (캐시 비우기), hash -l (재입력 가능한 형식),
+ *       hash -p 경로 이름 (직접 등록), hash 이름... (미리 찾아 두기)
  */
-void execute_piped_command(char *arg1[], char *arg2[], int is_bg) {
-    int pfd[2]; // 파이프 파일 디스크립터
-    pid_t pid1, pid2;
+int execute_builtin_hash(char *argv[]) {
+    int status = 0;
 
-    // 파이프 생성
-    if (pipe(pfd) < 0) {
-        perror("pipe failed");
-        return;
+    if (argv[1] == NULL) {
+        path_hash_print(stdout, 0);
+        return 0;
     }
-
-    // 첫 번째 자식 (Writer)
-    if ((pid1 = fork()) == 0) {
-        // 파이프 읽기 포트 닫기 (쓰기만 함)
-        close(pfd[0]);
-        
-        // 표준 출력을 파이프 쓰기 포트로 연결
-        dup2(pfd[1], STDOUT_FILENO);
-        close(pfd[1]);
-
-        // 재지향 처리 및 실행
-        handle_redirection(arg1);
-        
-        if (execvp(arg1[0], arg1) < 0) {
-            fprintf(stderr, "%s: command not found\n", arg1[0]);
-            exit(1);
+    if (strcmp(argv[1], "-r") == 0) {
+        path_hash_clear();
+        return 0;
+    }
+    if (strcmp(argv[1], "-l") == 0) {
+        path_hash_print(stdout, 1);
+        return 0;
+    }
+    if (strcmp(argv[1], "-p") == 0) {
+        if (argv[2] == NULL || argv[3] == NULL) {
+            fprintf(stderr, "%shash: usage: hash -p path name%s\n", COLOR_RED, COLOR_RESET);
+            return 1;
         }
+        return path_hash_add(argv[3], argv[2]) < 0 ? 1 : 0;
     }
 
-    // 두 번째 자식 (Reader)
-    if ((pid2 = fork()) == 0) {
-        // 파이프 쓰기 포트 닫기 (읽기만 함)
-        close(pfd[1]);
-        
-        // 표준 입력을 파이프 읽기 포트로 연결
-        dup2(pfd[0], STDIN_FILENO);
-        close(pfd[0]);
-
-        // 재지향 처리 및 실행
-        handle_redirection(arg2);
-        
-        if (execvp(arg2[0], arg2) < 0) {
-            fprintf(stderr, "%s: command not found\n", arg2[0]);
-            exit(1);
+    for (int i = 1; argv[i] != NULL; i++) {
+        if (is_builtin(argv[i])) continue;
+        path_hash_forget(argv[i]);
+        if (path_hash_lookup(argv[i]) == NULL) {
+            fprintf(stderr, "%shash: %s: not found%s\n", COLOR_RED, argv[i], COLOR_RESET);
+            status = 1;
         }
     }
+    return status;
+}
 
-    // 부모 프로세스: 파이프 포트 모두 닫기 (중요: 안 닫으면 자식이 안 끝남)
-    close(pfd[0]);
-    close(pfd[1]);
+/*
+ * 내장 명령어 'jobs' 실행 함수
+ * 설명: jobs (작업 목록), jobs -l (pid, 자원 사용량, 좀비/미보고 수 포함)
+ */
+int execute_builtin_jobs(char *argv[]) {
+    int verbose = argv[1] != NULL && strcmp(argv[1], "-l") == 0;
 
-    // 백그라운드가 아니면 두 자식이 끝날 때까지 대기
-    if (!is_bg) {
-        waitpid(pid1, NULL, 0);
-        waitpid(pid2, NULL, 0);
-    } else {
-        printf("[%d] Pipe command started in background\n", pid1);
-    }
+    jobs_print(stdout, verbose);
+    return 0;
 }
 
 /*
- * 명령어 라인 처리 함수 (Main Logic)
- * 설명: 입력된 문자열을 분석하여 파이프 여부 확인 후 적절한 실행 함수 호출
+ * 내장 명령어 'fg' 실행 함수
+ * 설명: fg [%N]: 작업을 전경으로 가져와 재개하고 끝날 때까지 기다립니다.
  */
-void process_command_line(char *cmd_line) {
-    char *argv[MAX_ARG];
-    char *arg1[MAX_ARG], *arg2[MAX_ARG];
-    char *pipe_pos;
-    int argc;
-    int is_bg = 0;
+int execute_builtin_fg(char *argv[]) {
+    struct job *job;
+    int status;
 
-    // 개행 문자 제거
-    if (cmd_line[strlen(cmd_line) - 1] == '\n')
-        cmd_line[strlen(cmd_line) - 1] = '\0';
+    jobs_reap();
+    job = job_find(argv[1]);
+    if (job == NULL || job->state == JOB_DONE) {
+        fprintf(stderr, "%sfg: %s: no such job%s\n", COLOR_RED,
+                argv[1] != NULL ? argv[1] : "current", COLOR_RESET);
+        return 1;
+    }
 
-    // 빈 명령어 체크
-    if (strlen(cmd_line) == 0) return;
+    printf("%s\n", job->cmd);
+    status = decode_status(job_continue(job, 1));
+    if (job->state == JOB_STOPPED) {
+        printf("\n[%d]+  Stopped                %s\n", job->id, job->cmd);
+        job->notified = 1;
+        return status;
+    }
+    job_remove(job);
+    return status;
+}
 
-    // 1. 파이프(|) 처리 확인
-    pipe_pos = strchr(cmd_line, '|');
-    
-    if (pipe_pos != NULL) {
-        // 파이프가 있는 경우
-        *pipe_pos = '\0'; // 파이프 문자를 기준으로 문자열 분리
-        char *cmd2_str = pipe_pos + 1;
+/*
+ * 내장 명령어 'bg' 실행 함수
+ * 설명: bg [%N]: 정지된 작업을 배경에서 재개합니다.
+ */
+int execute_builtin_bg(char *argv[]) {
+    struct job *job;
+
+    jobs_reap();
+    job = job_find(argv[1]);
+    if (job == NULL || job->state == JOB_DONE) {
+        fprintf(stderr, "%sbg: %s: no such job%s\n", COLOR_RED,
+                argv[1] != NULL ? argv[1] : "current", COLOR_RESET);
+        return 1;
+    }
+
+    job_continue(job, 0);
+    printf("[%d]+ %s &\n", job->id, job->cmd);
+    return 0;
+}
+
+/*
+ * 내장 명령어 'wait' 실행 함수
+ * 설명: wait (실행 중인 모든 작업), wait %N | PID ... (지정한 작업)
+ * 반환값: 마지막으로 기다린 작업의 종료 상태
+ */
+int execute_builtin_wait(char *argv[]) {
+    int status = 0;
 
-        // 앞뒤 명령어 각각 파싱
-        tokenize_command(cmd_line, arg1);
-        int count2 = tokenize_command(cmd2_str, arg2);
+    if (argv[1] == NULL) return decode_status(jobs_wait_all());
 
-        // 백그라운드 체크 (두 번째 명령어 기준)
-        is_bg = check_background(arg2, count2);
+    for (int i = 1; argv[i] != NULL; i++) {
+        struct job *job = job_find(argv[i]);
+        if (job == NULL) {
+            fprintf(stderr, "%swait: %s: no such job%s\n", COLOR_RED, argv[i], COLOR_RESET);
+            status = 127;
+            continue;
+        }
+        status = decode_status(job_wait(job, 0));
+        if (job->state == JOB_DONE) job_remove(job);
+    }
+    return status;
+}
 
-        // 파이프 실행
-        execute_piped_command(arg1, arg2, is_bg);
-        return;
+/*
+ * 내장 명령어 'parallel' 실행 함수
+ * 설명: parallel [-j N] [-g] [-k] 명령어 [인자...] [::: 값...]
+ *       ::: 뒤의 값들(없으면 표준 입력의 각 줄)마다 명령어를 실행합니다.
+ *       인자의 {}는 값으로 바뀌며, {}가 없으면 값을 마지막 인자로 붙입니다.
+ *       -j N: 동시 실행 수 (기본값: CPU 수), -g: 작업별 출력을 모아서 출력,
+ *       -k: 작업별 출력을 입력 순서대로 출력
+ * 반환값: 실패한 작업 수 (최대 101)
+ */
+int execute_builtin_parallel(char *argv[]) {
+    struct parallel_opts opts = { 0 };
+    struct parallel_input input = { NULL, 0, stdin };
+    int i = 1, sep, status;
+    char *saved;
+    long n;
+
+    opts.max_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    opts.launch_mode = launcher_mode;
+
+    // 옵션 처리 (-j N, -jN, -gk)
+    while (argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != '\0') {
+        for (int j = 1; argv[i][j] != '\0'; j++) {
+            switch (argv[i][j]) {
+                case 'g': opts.group = 1; break;
+                case 'k': opts.keep_order = 1; break;
+                case 'j':
+                    if (argv[i][j + 1] != '\0') {
+                        n = strtol(&argv[i][j + 1], NULL, 10);
+                    } else if (argv[i + 1] != NULL) {
+                        n = strtol(argv[++i], NULL, 10);
+                    } else {
+                        n = 0;
+                    }
+                    if (n <= 0 || n > 65536) {
+                        fprintf(stderr, "%sparallel: -j: invalid number of jobs%s\n", COLOR_RED, COLOR_RESET);
+                        return 1;
+                    }
+                    opts.max_jobs = (int)n;
+                    goto next_option;
+                default:
+                    fprintf(stderr, "%sparallel: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
+                    return 1;
+            }
+        }
+    next_option:
+        i++;
     }
+    if (opts.max_jobs <= 0) opts.max_jobs = 1;
 
-    // 2. 일반 명령어 처리 (파이프 없음)
-    argc = tokenize_command(cmd_line, argv);
+    // 명령어 틀과 ::: 뒤의 값 목록 분리
+    for (sep = i; argv[sep] != NULL && strcmp(argv[sep], ":::") != 0; sep++)
+        ;
+    if (sep == i) {
+        fprintf(stderr, "%sparallel: missing command%s\n", COLOR_RED, COLOR_RESET);
+        return 1;
+    }
+    if (argv[sep] != NULL) {
+        input.list = &argv[sep + 1];
+        while (input.list[input.n] != NULL) input.n++;
+        input.in = NULL;
+    }
 
-    if (argc == 0) return; // 공백만 입력된 경우
+    if (is_builtin(argv[i])) opts.fn = run_builtin;
+    else opts.path = path_hash_lookup(argv[i]);
 
-    // 3. 백그라운드(&) 확인
-    is_bg = check_background(argv, argc);
+    saved = argv[sep];
+    argv[sep] = NULL;
+    status = parallel_run(&opts, &argv[i], &input);
+    argv[sep] = saved;
+    return status;
+}
 
-   // 4. 내장 명령어 처리
-if (strcmp(argv[0], "exit") == 0) {
-    printf("Goodbye!\n");
-    exit(0);
-} 
-else if (strcmp(argv[0], "help") == 0) {
-    print_help();
+/*
+ * 종료 상태 변환 함수
+ * 설명: waitpid가 돌려준 status를 쉘의 종료 코드(0~255)로 변환합니다.
+ *       시그널로 종료되거나 정지한 경우 bash와 같이 128 + 시그널 번호를 사용합니다.
+ */
+int decode_status(int status) {
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    if (WIFSTOPPED(status)) return 128 + WSTOPSIG(status);
+    return 1;
 }
-else if (strcmp(argv[0], "cd") == 0) {
-    execute_builtin_cd(argv);
+
+/* 표시용 문자열에 단어 하나 추가 (공백이나 특수 문자가 있으면 작은따옴표로 감쌈) */
+static void put_word(FILE *out, const char *word) {
+    if (word[0] != '\0' && strpbrk(word, " \t\n|&;<>'\"\\#") == NULL) {
+        fputs(word, out);
+        return;
+    }
+    fputc('\'', out);
+    for (; *word != '\0'; word++) {
+        if (*word == '\'') fputs("'\\''", out);
+        else fputc(*word, out);
+    }
+    fputc('\'', out);
 }
-else if (strcmp(argv[0], "cat") == 0) {
-    execute_builtin_cat(argv);
+
+/* 재지향 하나를 표시용 문자열로 출력 ("2>&1", "> out", "<<< word") */
+static void put_redir(FILE *out, const struct redir *r) {
+    static const char *const ops[] = {
+        [REDIR_IN] = "<", [REDIR_OUT] = ">", [REDIR_APPEND] = ">>",
+        [REDIR_DUP] = ">&", [REDIR_HEREDOC] = "<<", [REDIR_HERESTR] = "<<<",
+    };
+    int default_fd = (r->type == REDIR_OUT || r->type == REDIR_APPEND) ? 1 : 0;
+
+    if (r->type == REDIR_DUP) {
+        fprintf(out, "%d%s", r->fd, r->fd == 0 ? "<&" : ">&");
+        if (r->src_fd < 0) fputc('-', out);
+        else fprintf(out, "%d", r->src_fd);
+        return;
+    }
+
+    if (r->fd != default_fd) fprintf(out, "%d", r->fd);
+    fputs(ops[r->type], out);
+    if (r->type == REDIR_HEREDOC) return;   // 본문은 표시하지 않음
+    fputc(' ', out);
+    if (r->type == REDIR_HERESTR) {
+        // 끝에 붙인 개행을 빼고 표시
+        char *word = strndup(r->target, r->len - 1);
+        put_word(out, word != NULL ? word : "");
+        free(word);
+    } else {
+        put_word(out, r->target);
+    }
 }
-else if (strcmp(argv[0], "grep") == 0) {
-    execute_builtin_grep(argv);
+
+/* 단순 명령어를 표시용 문자열로 출력 ("cmd arg < in > out 2>&1") */
+static void put_command(FILE *out, const struct ast_command *cmd) {
+    for (int j = 0; j < cmd->argc; j++) {
+        if (j > 0) fputc(' ', out);
+        put_word(out, cmd->argv[j]);
+    }
+    for (int k = 0; k < cmd->nredirs; k++) {
+        fputs(cmd->argc > 0 || k > 0 ? " " : "", out);
+        put_redir(out, &cmd->redirs[k]);
+    }
 }
-// 5. 외부 명령어 실행
-else {
-    execute_single_command(argv, is_bg);
+
+/*
+ * 작업 표시용 명령어 문자열 생성 함수 ("cmd1 arg | cmd2")
+ * 반환값: malloc된 문자열, 실패 시 NULL
+ */
+char *format_pipeline(const struct ast_pipeline *pl) {
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&text, &len);
+
+    if (out == NULL) return NULL;
+    for (int k = 0; k < pl->ncmds; k++) {
+        if (k > 0) fputs(" | ", out);
+        put_command(out, &pl->cmds[k]);
+    }
+    fclose(out);
+    return text;
 }
 
+/* 한 단계를 표시용 문자열로 */
+static char *format_command(const struct ast_command *cmd) {
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&text, &len);
+
+    if (out == NULL) return NULL;
+    put_command(out, cmd);
+    fclose(out);
+    return text;
 }
 
-void execute_builtin_cat(char *argv[]) {
-    int i = 1;
-    int show_line_numbers = 0;
-    int show_nonprintable = 0;
-    int show_ends = 0;
-    int number_nonblank = 0;
-    int has_option = 0;
+/*
+ * N단계 파이프라인 실행 함수 (cmd1 | cmd2 | ... | cmdN)
+ * 설명: N-1개의 파이프로 모든 단계를 연결하여 동시에 실행합니다.
+ *       파이프는 O_CLOEXEC로 생성하고 부모는 각 단계를 실행한 직후
+ *       더 이상 필요 없는 끝을 닫으므로, 동시에 열려 있는 파이프는
+ *       최대 2개이며 다른 단계로 fd가 새지 않습니다.
+ *       파이프라인 전체가 하나의 작업(프로세스 그룹)이 되며, 자식은
+ *       SIGCHLD 핸들러가 회수하므로 배경 작업도 좀비로 남지 않습니다.
+ *       파이프 없는 포그라운드 내장 명령어는 쉘 안에서 바로 실행합니다.
+ * 반환값: 마지막 단계의 종료 상태 (백그라운드는 0)
+ */
+int execute_pipeline(const struct ast_pipeline *pl, int is_bg) {
+    const int n = pl->ncmds;
+    struct job *job;
+    char *text = NULL;
+    int prev_read = -1; // 이전 단계 파이프의 읽기 포트
+    int pipeline_status = 0;
+    int i;
 
-    // 옵션 처리
-    while (argv[i] != NULL && argv[i][0] == '-') {
-        has_option = 1;
-        for (int j = 1; argv[i][j] != '\0'; j++) {
-            switch(argv[i][j]) {
-                case 'n': show_line_numbers = 1; break;
-                case 'b': number_nonblank = 1; break;
-                case 'v': show_nonprintable = 1; break;
-                case 'E': show_ends = 1; break;
-                default:
-                    fprintf(stderr, "%scat: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
-                    return;
-            }
+    if (n == 0) return 0; // 'time' 단독
+
+    // 재지향만 있는 명령어: 파일만 만들고(열고) 끝냄
+    if (n == 1 && pl->cmds[0].argc == 0) return execute_builtin_in_shell(&pl->cmds[0]);
+    for (i = 0; i < n; i++) {
+        if (pl->cmds[i].argc == 0) {
+            fprintf(stderr, "%ssyntax error near unexpected token '|'%s\n",
+                    COLOR_RED, COLOR_RESET);
+            return 2;
         }
-        i++;
     }
 
-    // stdin 처리 (옵션만 있고 파일 없을 때)
-    if (argv[i] == NULL && has_option) {
-        char buffer[1024];
-        int line = 1;
-        while (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-            int print_line = 1;
-            if (number_nonblank) {
-                int nonblank_found = 0;
-                for (int k = 0; buffer[k] != '\0'; k++) {
-                    if (buffer[k] != '\n') { nonblank_found = 1; break; }
-                }
-                if (nonblank_found) printf("%6d  ", line++);
-            } else if (show_line_numbers) {
-                printf("%6d  ", line++);
-            }
+    // 파이프 없는 포그라운드 내장 명령어 (cd, exit 등은 쉘 자신에 적용되어야 함)
+    // 애플릿(cat, my_ls, my_mkdir 등)은 스크립트/-c 모드에서만 fork/exec 없이 쉘 안에서 실행하고,
+    // 대화형 모드에서는 fork만 하여 Ctrl-C/Ctrl-Z가 쉘이 아닌 명령어에 전달되도록 함
+    if (n == 1 && !is_bg && (find_builtin(pl->cmds[0].argv[0]) >= 0 ||
+                             (!interactive && find_applet(pl->cmds[0].argv[0]) != NULL))) {
+        if (!pl->timed && !profile_enabled()) return execute_builtin_in_shell(&pl->cmds[0]);
+
+        // 쉘 안에서 실행되므로 쉘 자신의 자원 사용량 차이로 측정
+        struct shell_timer t;
+        text = format_pipeline(pl);
+        shell_timer_start(&t);
+        pipeline_status = execute_builtin_in_shell(&pl->cmds[0]);
+        time_report_shell(pl->timed ? stderr : NULL, &t,
+                          text != NULL ? text : pl->cmds[0].argv[0], pipeline_status);
+        free(text);
+        return pipeline_status;
+    }
 
-            for (int k = 0; buffer[k] != '\0'; k++) {
-                unsigned char c = buffer[k];
-                if (c == '\n' && show_ends) putchar('$');
-                if (show_nonprintable) {
-                    if (c < 32 && c != '\n' && c != '\t') printf("^%c", c+64);
-                    else putchar(c);
-                } else putchar(c);
-            }
-        }
-        return;
+    text = format_pipeline(pl);
+    job = (text != NULL) ? job_create(text, is_bg) : NULL;
+    free(text);
+    if (job == NULL) {
+        perror("malloc failed");
+        return 1;
     }
 
-    // 파일 처리
-    for (; argv[i] != NULL; i++) {
-        FILE *fp = fopen(argv[i], "r");
-        if (!fp) {
-            fprintf(stderr, "%scat: %s: %s%s\n", COLOR_RED, argv[i], strerror(errno), COLOR_RESET);
-            continue;
+    for (i = 0; i < n; i++) {
+        const struct ast_command *cmd = &pl->cmds[i];
+        int pfd[2] = { -1, -1 };
+        struct launch_spec spec;
+        struct timespec started;
+        pid_t pid;
+
+        // 마지막 단계가 아니면 다음 단계로 가는 파이프 생성
+        if (i < n - 1 && pipe2(pfd, O_CLOEXEC) < 0) {
+            perror("pipe failed");
+            break;
         }
 
-        char buffer[1024];
-        int line = 1;
-
-        while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-            int print_line = 1;
-            if (number_nonblank) {
-                int nonblank_found = 0;
-                for (int k = 0; buffer[k] != '\0'; k++) {
-                    if (buffer[k] != '\n') { nonblank_found = 1; break; }
-                }
-                if (nonblank_found) printf("%6d  ", line++);
-            } else if (show_line_numbers) {
-                printf("%6d  ", line++);
-            }
+        // here 문서/문자열 내용을 담은 fd 준비 (실행 직후 부모 쪽은 닫음)
+        if (redir_prepare(cmd->redirs, cmd->nredirs) < 0) {
+            if (pfd[0] >= 0) { close(pfd[0]); close(pfd[1]); }
+            break;
+        }
 
-            for (int k = 0; buffer[k] != '\0'; k++) {
-                unsigned char c = buffer[k];
-                if (c == '\n' && show_ends) putchar('$');
-                if (show_nonprintable) {
-                    if (c < 32 && c != '\n' && c != '\t') printf("^%c", c+64);
-                    else putchar(c);
-                } else putchar(c);
-            }
+        // 표준 입출력을 앞뒤 파이프로 연결
+        // (원래 파이프 fd는 O_CLOEXEC이므로 exec 시 자동으로 닫힘)
+        spec.argv = cmd->argv;
+        spec.path = NULL;
+        spec.in_fd = prev_read;
+        spec.out_fd = pfd[1];
+        spec.redirs = cmd->redirs;
+        spec.nredirs = cmd->nredirs;
+        spec.fn = NULL;
+        spec.pgid = job_next_pgid(job);
+
+        // 내장 명령어는 외부 프로그램 대신 fork한 자식 안에서 바로 실행
+        if (is_builtin(cmd->argv[0])) spec.fn = run_builtin;
+        else spec.path = path_hash_lookup(cmd->argv[0]);
+
+        clock_gettime(CLOCK_MONOTONIC, &started);
+        pid = launch(&spec, launcher_mode);
+        redir_release(cmd->redirs, cmd->nredirs);
+        if (pid < 0) {
+            perror("fork failed");
+            if (pfd[0] >= 0) { close(pfd[0]); close(pfd[1]); }
+            break;
         }
 
-        fclose(fp);
+        // [부모 프로세스] 이번 단계에 넘겨준 포트는 즉시 닫기
+        text = format_command(cmd);
+        job_add_proc(job, pid, text, &started);
+        free(text);
+        if (prev_read >= 0) close(prev_read);
+        if (pfd[1] >= 0) close(pfd[1]);
+        prev_read = pfd[0];
     }
 
-    // 확장 옵션: 여러 파일 처리, 반복문 세분화, 에러 처리, stdin 파일 혼합 등
-    // 각종 조건문, 반복문, 라인 체크, 옵션 조합 처리 추가
-    
-}
+    if (prev_read >= 0) close(prev_read);
 
-
-    
-void execute_builtin_grep(char *argv[]) {
-    int i = 1;
-    int ignore_case = 0;
-    int show_line_numbers = 0;
-    int invert_match = 0;
-    int count_only = 0;
-    int list_files = 0;
-    int has_option = 0;
-
-    // 옵션 처리
-    while (argv[i] != NULL && argv[i][0] == '-') {
-        has_option = 1;
-        for (int j = 1; argv[i][j] != '\0'; j++) {
-            switch (argv[i][j]) {
-                case 'i': ignore_case = 1; break;
-                case 'n': show_line_numbers = 1; break;
-                case 'v': invert_match = 1; break;
-                case 'c': count_only = 1; break;
-                case 'l': list_files = 1; break;
-                default:
-                    fprintf(stderr, "%sgrep: invalid option -- '%c'%s\n", COLOR_RED, argv[i][j], COLOR_RESET);
-                    return;
-            }
-        }
-        i++;
+    if (job->nprocs == 0) {
+        job_remove(job);
+        return 1;
     }
 
-    // 패턴 확인
-    if (argv[i] == NULL) {
-        fprintf(stderr, "%sgrep: missing search pattern%s\n", COLOR_RED, COLOR_RESET);
-        return;
+    if (is_bg) {
+        printf("[%d] %d\n", job->id, (int)job->procs[job->nprocs - 1].pid);
+        return 0;
     }
 
-    char *pattern = argv[i++];
-
-    // 파일이 없으면 stdin 처리
-    if (argv[i] == NULL) {
-        char buffer[1024];
-        int line = 1;
-        int match_count = 0;
+    // 전경 작업: 끝나거나 (Ctrl-Z로) 정지할 때까지 대기
+    int raw = job_wait(job, 1);
+    pipeline_status = decode_status(raw);
+    if (interactive && WIFSIGNALED(raw) && WTERMSIG(raw) == SIGINT) printf("\n");
+    if (job->state == JOB_STOPPED) {
+        printf("\n[%d]+  Stopped                %s\n", job->id, job->cmd);
+        job->notified = 1;
+        return pipeline_status;
+    }
 
-        while (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-            int match = 0;
-            char *p = buffer;
+    // time 키워드: 단계별 시간, 최대 RSS, 문맥 교환 횟수 출력
+    if (pl->timed) time_report_job(stderr, job);
 
-            // 문자열 검색: 대소문자 무시
-            if (ignore_case) {
-                for (int k = 0; buffer[k] != '\0'; k++) buffer[k] = tolower(buffer[k]);
-                char lower_pattern[256];
-                strncpy(lower_pattern, pattern, sizeof(lower_pattern));
-                for (int k = 0; lower_pattern[k] != '\0'; k++) lower_pattern[k] = tolower(lower_pattern[k]);
-                if (strstr(buffer, lower_pattern) != NULL) match = 1;
-            } else {
-                if (strstr(buffer, pattern) != NULL) match = 1;
-            }
+    // 캐시된 경로로 실행하지 못한 단계(127)는 캐시에서 제거
+    for (i = 0; i < job->nprocs; i++) {
+        if (decode_status(job->procs[i].status) == 127) path_hash_forget(pl->cmds[i].argv[0]);
+    }
 
-            if (invert_match) match = !match;
+    // 마지막 단계를 실행하지 못했다면 실패로 처리
+    if (job->nprocs < n) pipeline_status = 1;
 
-            if (match) {
-                match_count++;
-                if (!count_only && !list_files) {
-                    if (show_line_numbers) printf("%6d: ", line);
-                    fputs(buffer, stdout);
-                }
-            }
-            line++;
-        }
+    job_remove(job);
+    return pipeline_status;
+}
 
-        if (count_only) printf("%d\n", match_count);
-        return;
+/*
+ * and-or 목록 실행 함수 (p1 && p2 || p3)
+ * 설명: &&는 앞 파이프라인이 성공(0)했을 때만, ||는 실패했을 때만 다음을 실행합니다.
+ * 반환값: 마지막으로 실행한 파이프라인의 종료 상태
+ */
+int execute_and_or(const struct ast_and_or *ao) {
+    int status = last_status;
+
+    for (int k = 0; k < ao->npipes; k++) {
+        if (ao->ops[k] == AST_AND && status != 0) continue;
+        if (ao->ops[k] == AST_OR && status == 0) continue;
+        status = execute_pipeline(&ao->pipes[k], 0);
+        last_status = status;
     }
+    return status;
+}
 
-    // 파일 처리
-    for (; argv[i] != NULL; i++) {
-        FILE *fp = fopen(argv[i], "r");
-        if (!fp) {
-            fprintf(stderr, "%sgrep: %s: %s%s\n", COLOR_RED, argv[i], strerror(errno), COLOR_RESET);
-            continue;
-        }
+/*
+ * 백그라운드 and-or 목록 실행 함수 (p1 && p2 &)
+ * 설명: 파이프라인이 여러 개이면 쉘을 fork한 자식(서브쉘)이 차례로 실행하고,
+ *       그 자식 하나를 배경 작업으로 등록합니다.
+ * 반환값: 0 (실패 시 1)
+ */
+int execute_background_and_or(const struct ast_and_or *ao) {
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out;
+    struct job *job;
+    struct timespec started;
+    pid_t pid;
 
-        char buffer[1024];
-        int line = 1;
-        int match_count = 0;
-        int file_matched = 0;
-
-        while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-            int match = 0;
-            char original_line[1024];
-            strncpy(original_line, buffer, sizeof(original_line));
-
-            // 대소문자 옵션 처리
-            if (ignore_case) {
-                for (int k = 0; buffer[k] != '\0'; k++) buffer[k] = tolower(buffer[k]);
-                char lower_pattern[256];
-                strncpy(lower_pattern, pattern, sizeof(lower_pattern));
-                for (int k = 0; lower_pattern[k] != '\0'; k++) lower_pattern[k] = tolower(lower_pattern[k]);
-                if (strstr(buffer, lower_pattern) != NULL) match = 1;
-            } else {
-                if (strstr(buffer, pattern) != NULL) match = 1;
-            }
+    if (ao->npipes == 1) return execute_pipeline(&ao->pipes[0], 1);
 
-            // 역매치 옵션
-            if (invert_match) match = !match;
+    out = open_memstream(&text, &len);
+    if (out == NULL) {
+        perror("malloc failed");
+        return 1;
+    }
+    for (int k = 0; k < ao->npipes; k++) {
+        char *pt = format_pipeline(&ao->pipes[k]);
+        if (k > 0) fputs(ao->ops[k] == AST_AND ? " && " : " || ", out);
+        fputs(pt != NULL ? pt : "", out);
+        free(pt);
+    }
+    fclose(out);
 
-            if (match) {
-                match_count++;
-                file_matched = 1;
-                if (!count_only && !list_files) {
-                    if (show_line_numbers) printf("%6d: ", line);
-                    fputs(original_line, stdout);
-                }
-            }
+    job = (text != NULL) ? job_create(text, 1) : NULL;
+    free(text);
+    if (job == NULL) {
+        perror("malloc failed");
+        return 1;
+    }
 
-            line++;
-        }
+    fflush(NULL);
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    pid = fork();
+    if (pid < 0) {
+        perror("fork failed");
+        job_remove(job);
+        return 1;
+    }
+    if (pid == 0) {
+        // [서브쉘] 작업 제어 없이 순서대로 실행하고 마지막 상태로 종료
+        if (job_next_pgid(job) >= 0) setpgid(0, 0);
+        interactive = 0;
+        signal(SIGINT, SIG_DFL);
+        signal(SIGQUIT, SIG_DFL);
+        signal(SIGTSTP, SIG_DFL);
+        signal(SIGTTIN, SIG_DFL);
+        signal(SIGTTOU, SIG_DFL);
+        jobs_init(0);
+        int status = execute_and_or(ao);
+        fflush(NULL);
+        _exit(status);
+    }
 
-        if (count_only) printf("%d\n", match_count);
-        if (list_files && file_matched) printf("%s\n", argv[i]);
+    job_add_proc(job, pid, job->cmd, &started);
+    printf("[%d] %d\n", job->id, (int)pid);
+    return 0;
+}
+
+/*
+ * 명령어 목록 실행 함수 (item ; item & ...)
+ * 반환값: 마지막 항목의 종료 상태
+ */
+int execute_list(const struct ast_list *list) {
+    for (int k = 0; k < list->nitems; k++) {
+        const struct ast_item *item = &list->items[k];
 
-        fclose(fp);
+        if (item->bg) last_status = execute_background_and_or(&item->and_or);
+        else last_status = execute_and_or(&item->and_or);
     }
+    return last_status;
+}
 
-    // 추가 반복문 및 조건문으로 코드 확장
-    // - 여러 옵션 조합 반복 처리
-    // - 파일 존재 여부, stdin 혼합 처리
-    // - 라인 번호, 역매치, 대소문자 무시, 출력 옵션 등
-    // - 각 조건마다 중첩 반복문, 문자열 비교, 출력 처리
-   
+/*
+ * 명령어 라인 처리 함수 (Main Logic)
+ * 설명: 한 줄을 AST로 파싱한 뒤 실행합니다. 줄과 인자 개수에 제한이 없습니다.
+ *       따옴표가 줄을 넘기거나 here 문서(<<)가 있으면 next로 다음 줄들을 읽습니다.
+ * 반환값: 명령어의 종료 상태 (빈 줄이면 이전 상태 유지, 문법 오류는 2)
+ */
+int process_command_line(char *cmd_line, line_reader next, void *ctx) {
+    struct ast_list *list;
+    size_t len = strlen(cmd_line);
+
+    // 개행 문자 제거
+    if (len > 0 && cmd_line[len - 1] == '\n')
+        cmd_line[--len] = '\0';
+
+    list = parse_lines(&parser, cmd_line, len, next, ctx);
+    if (list == NULL) return 2;
+    if (parse_heredocs(&parser, next, ctx) < 0) return 1;
+    if (list->nitems == 0) return last_status;
+    return execute_list(list);
 }
@@ -0,0 +1,71 @@
+/* mybox.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+
+#include "applets.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+/*
+ * 애플릿 링크 설치 함수 (mybox --install [디렉토리])
+ * 설명: 디렉토리에 my_<이름> 심볼릭 링크를 만들어 mybox를 가리키게 합니다.
+ *       따로 빌드한 11개 실행 파일 대신 바이너리 하나로 같은 이름을 쓸 수 있습니다.
+ * 반환값: 0(성공), 1(하나라도 실패)
+ */
+static int install_links(const char *dir) {
+    char self[PATH_MAX], link[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    int status = 0;
+
+    if (n < 0) {
+        perror("mybox: readlink");
+        return 1;
+    }
+    self[n] = '\0';
+
+    for (int k = 0; k < num_applets; k++) {
+        snprintf(link, sizeof(link), "%s/my_%s", dir, applets[k].name);
+        if (unlink(link) < 0 && errno != ENOENT) {
+            fprintf(stderr, "%smybox: cannot replace '%s': %s%s\n", COLOR_RED, link, strerror(errno), COLOR_RESET);
+            status = 1;
+            continue;
+        }
+        if (symlink(self, link) < 0) {
+            fprintf(stderr, "%smybox: cannot create '%s': %s%s\n", COLOR_RED, link, strerror(errno), COLOR_RESET);
+            status = 1;
+        }
+    }
+    return status;
+}
+
+/*
+ * 다중 호출 바이너리의 진입점
+ * 설명: argv[0]의 이름(my_ls, ls 등)으로 애플릿을 고르고, 이름이 mybox이면
+ *       "mybox ls -l"처럼 첫 인자를 애플릿 이름으로 씁니다.
+ */
+int main(int argc, char *argv[]) {
+    const struct applet *a = applet_find(argv[0]);
+
+    if (a == NULL && argc > 1) {
+        if (strcmp(argv[1], "--install") == 0) return install_links(argc > 2 ? argv[2] : ".");
+        a = applet_find(argv[1]);
+        if (a == NULL) {
+            fprintf(stderr, "%smybox: %s: applet not found%s\n", COLOR_RED, argv[1], COLOR_RESET);
+            return 127;
+        }
+        argc--;
+        argv++;
+    }
+    if (a == NULL) {
+        fprintf(stderr, "Usage: mybox <applet> [args...] | mybox --install [dir]\nApplets: ");
+        applet_list(stderr);
+        return 1;
+    }
+    return a->main(argc, argv);
+}
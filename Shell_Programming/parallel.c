@@ -0,0 +1,253 @@
+/* parallel.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "parallel.h"
+#include "jobs.h"
+#include "cat_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define PARALLEL_MAX_FAILED 101   // 실패한 작업 수를 종료 상태로 돌려줄 때의 상한 (GNU parallel과 같음)
+
+/*
+ * 실행 자리 하나
+ * 설명: 실행 중인 자식, 또는 (-k) 끝났지만 앞선 작업의 출력을 기다리는 자식
+ */
+struct slot {
+    int used;
+    int running;
+    size_t seq;         // 입력 순서
+    int proc;           // job->procs 인덱스 (배열이 늘어나도 변하지 않음), 아직 없으면 -1
+    int out_fd;         // 모아 둔 표준 출력 (memfd), 모으지 않으면 -1
+};
+
+/* 다음 인자 꺼내기 (줄 입력이면 끝의 개행 제거, 더 없으면 NULL) */
+static char *next_arg(struct parallel_input *input, size_t *used, char **line, size_t *cap) {
+    if (input->list != NULL)
+        return *used < input->n ? input->list[(*used)++] : NULL;
+
+    ssize_t n = getline(line, cap, input->in);
+    if (n < 0) return NULL;
+    if (n > 0 && (*line)[n - 1] == '\n') (*line)[n - 1] = '\0';
+    return *line;
+}
+
+/* word 안의 모든 "{}"를 arg로 바꾼 새 문자열 */
+static char *substitute(const char *word, const char *arg) {
+    size_t count = 0, alen = strlen(arg);
+    const char *s;
+    char *out, *d;
+
+    for (s = word; (s = strstr(s, "{}")) != NULL; s += 2) count++;
+    out = malloc(strlen(word) + count * alen + 1);
+    if (out == NULL) return NULL;
+
+    for (d = out, s = word; *s != '\0'; ) {
+        if (s[0] == '{' && s[1] == '}') {
+            memcpy(d, arg, alen);
+            d += alen;
+            s += 2;
+        } else {
+            *d++ = *s++;
+        }
+    }
+    *d = '\0';
+    return out;
+}
+
+/* 표시/프로파일용으로 단어들을 공백으로 이어 붙임 */
+static char *join_words(char **words) {
+    size_t len = 1;
+    char *text, *d;
+
+    for (int k = 0; words[k] != NULL; k++) len += strlen(words[k]) + 1;
+    text = malloc(len);
+    if (text == NULL) return NULL;
+    d = text;
+    for (int k = 0; words[k] != NULL; k++) {
+        size_t l = strlen(words[k]);
+        if (k > 0) *d++ = ' ';
+        memcpy(d, words[k], l);
+        d += l;
+    }
+    *d = '\0';
+    return text;
+}
+
+/* 모아 둔 출력을 표준 출력으로 내보내고 자리를 비움 */
+static void flush_slot(struct slot *s) {
+    if (s->out_fd >= 0) {
+        fflush(stdout);
+        if (lseek(s->out_fd, 0, SEEK_SET) < 0 || cat_plain(s->out_fd, STDOUT_FILENO) < 0)
+            perror("parallel: output");
+        close(s->out_fd);
+    }
+    s->used = 0;
+    s->out_fd = -1;
+}
+
+/*
+ * 병렬 실행 함수 (parallel 내장 명령어)
+ * 설명: 인자마다 명령어 틀(tmpl)의 "{}"를 인자로 바꾸어(없으면 끝에 붙여서)
+ *       최대 max_jobs개까지 동시에 실행합니다. 자식은 하나의 작업으로 등록되어
+ *       SIGCHLD 핸들러가 회수하며, 빈 자리가 없으면 jobs_wait_event로 잠들었다가
+ *       자식이 끝나는 즉시 다음 인자를 실행합니다 (폴링 없음).
+ *       -g/-k이면 각 자식의 표준 출력을 memfd에 모았다가 한 번에 내보내므로
+ *       여러 작업의 출력이 섞이지 않습니다. 자식은 쉘의 프로세스 그룹에서 실행되어
+ *       Ctrl-C가 함께 전달되며, 그러면 새 작업을 시작하지 않고 멈춥니다.
+ * 반환값: 실패한 작업 수 (최대 101), 인터럽트되면 130
+ */
+int parallel_run(const struct parallel_opts *opts, char **tmpl, struct parallel_input *input) {
+    const int nslots = opts->keep_order ? opts->max_jobs * 2 : opts->max_jobs;
+    const int grouped = opts->group || opts->keep_order;
+    struct redir null_in = { REDIR_IN, STDIN_FILENO, "/dev/null", 0, -1 };
+    struct slot *slots;
+    struct job *job;
+    char **argv;
+    char *line = NULL, *text;
+    size_t cap = 0, used = 0, seq = 0, next_print = 0;
+    int ntmpl = 0, placeholder = 0;
+    int running = 0, failed = 0, eof = 0, stop = 0, interrupted = 0;
+
+    for (; tmpl[ntmpl] != NULL; ntmpl++)
+        if (strstr(tmpl[ntmpl], "{}") != NULL) placeholder = 1;
+
+    slots = calloc(nslots, sizeof(*slots));
+    argv = malloc((ntmpl + 2) * sizeof(*argv));
+    text = join_words(tmpl);
+    job = (text != NULL) ? job_create(text, 0) : NULL;
+    free(text);
+    if (slots == NULL || argv == NULL || job == NULL) {
+        perror("malloc failed");
+        free(slots);
+        free(argv);
+        if (job != NULL) job_remove(job);
+        return 1;
+    }
+    job->pgid = -1;   // 쉘의 그룹에서 실행 (작업마다 그룹을 만들지 않음)
+    for (int k = 0; k < nslots; k++) slots[k].proc = -1;
+
+    for (;;) {
+        // 1. 빈 자리가 있는 동안 다음 인자 실행
+        while (!eof && !stop && running < opts->max_jobs) {
+            struct launch_spec spec;
+            struct slot *s = NULL;
+            char *arg;
+            struct timespec started;
+            pid_t pid;
+
+            if (opts->keep_order && seq >= next_print + nslots) break;
+            for (int k = 0; k < nslots && s == NULL; k++)
+                if (!slots[k].used) s = &slots[k];
+            if (s == NULL) break;
+
+            arg = next_arg(input, &used, &line, &cap);
+            if (arg == NULL) {
+                eof = 1;
+                break;
+            }
+
+            for (int k = 0; k < ntmpl; k++)
+                argv[k] = strstr(tmpl[k], "{}") != NULL ? substitute(tmpl[k], arg) : tmpl[k];
+            argv[ntmpl] = placeholder ? NULL : arg;
+            argv[ntmpl + 1] = NULL;
+
+            s->out_fd = -1;
+            if (grouped && (s->out_fd = memfd_create("parallel", MFD_CLOEXEC)) < 0)
+                perror("parallel: memfd_create");
+
+            spec.argv = argv;
+            spec.path = opts->path;
+            spec.in_fd = -1;
+            spec.out_fd = s->out_fd;
+            spec.redirs = input->list == NULL ? &null_in : NULL;   // 자식이 인자 목록을 읽지 않도록
+            spec.nredirs = input->list == NULL ? 1 : 0;
+            spec.fn = opts->fn;
+            spec.pgid = job_next_pgid(job);
+
+            clock_gettime(CLOCK_MONOTONIC, &started);
+            pid = launch(&spec, opts->launch_mode);
+            text = (pid > 0) ? join_words(argv) : NULL;
+            for (int k = 0; k < ntmpl; k++)
+                if (argv[k] != tmpl[k]) free(argv[k]);
+
+            // 자리마다 procs 항목 하나를 계속 다시 씀 (끝난 자식이 작업에 쌓이지 않도록)
+            if (pid > 0 && s->proc >= 0) job_reuse_proc(job, s->proc, pid, text, &started);
+            else if (pid > 0 && job_add_proc(job, pid, text, &started) == 0) s->proc = job->nprocs - 1;
+            else {
+                perror(pid < 0 ? "fork failed" : "malloc failed");
+                if (s->out_fd >= 0) close(s->out_fd);
+                free(text);
+                failed++;
+                stop = 1;
+                break;
+            }
+            free(text);
+
+            s->used = 1;
+            s->running = 1;
+            s->seq = seq++;
+            running++;
+        }
+
+        // 2. 끝난 자식 정리
+        int progress = 0;
+        jobs_reap();
+        for (int k = 0; k < nslots; k++) {
+            struct slot *s = &slots[k];
+            if (!s->used || !s->running) continue;
+
+            struct job_proc *p = &job->procs[s->proc];
+            if (p->state == JOB_STOPPED) {
+                kill(p->pid, SIGCONT);   // Ctrl-Z는 쉘 그룹 전체에 가므로 무시하고 계속 실행
+                continue;
+            }
+            if (p->state != JOB_DONE) continue;
+
+            s->running = 0;
+            running--;
+            progress = 1;
+            if (!WIFEXITED(p->status) || WEXITSTATUS(p->status) != 0) failed++;
+            if (WIFSIGNALED(p->status) && WTERMSIG(p->status) == SIGINT) {
+                stop = 1;
+                interrupted = 1;
+            }
+            if (!opts->keep_order) flush_slot(s);
+        }
+
+        // 3. -k: 입력 순서상 다음 작업이 끝났으면 이어서 출력
+        for (int k = 0; opts->keep_order && k < nslots; k++) {
+            struct slot *s = &slots[k];
+            if (s->used && !s->running && s->seq == next_print) {
+                flush_slot(s);
+                next_print++;
+                k = -1;
+            }
+        }
+
+        if (running == 0 && (eof || stop)) break;
+        if (!progress) jobs_wait_event();
+    }
+
+    // 중단된 경우 (-k) 아직 출력하지 못한 작업
+    for (int k = 0; k < nslots; k++)
+        if (slots[k].used) flush_slot(&slots[k]);
+
+    fflush(stdout);
+    job_remove(job);
+    free(line);
+    free(argv);
+    free(slots);
+    if (input->in != NULL) clearerr(input->in);
+    if (interrupted) return 128 + SIGINT;
+    return failed > PARALLEL_MAX_FAILED ? PARALLEL_MAX_FAILED : failed;
+}
@@ -0,0 +1,32 @@
+/* parallel.h */
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdio.h>
+
+#include "launch.h"
+
+/*
+ * parallel 옵션
+ */
+struct parallel_opts {
+    int max_jobs;           // -j N: 동시에 실행할 최대 자식 수
+    int group;              // -g: 작업별 출력을 모아서 끝난 순서대로 출력
+    int keep_order;         // -k: 작업별 출력을 모아서 입력 순서대로 출력
+    int launch_mode;        // enum launch_mode
+    launch_fn fn;           // 명령어가 내장 명령어이면 그 실행 함수 (fork로 실행)
+    const char *path;       // 외부 명령어의 실행 파일 경로 (NULL: PATH 검색)
+};
+
+/*
+ * 인자 목록: list가 NULL이 아니면 list[0..n), 아니면 in에서 한 줄씩 읽음
+ */
+struct parallel_input {
+    char **list;
+    size_t n;
+    FILE *in;
+};
+
+int parallel_run(const struct parallel_opts *opts, char **tmpl, struct parallel_input *input);
+
+#endif
@@ -0,0 +1,186 @@
+/* path_hash.c */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "path_hash.h"
+
+#define HASH_BUCKETS 64   // 해시 표 버킷 수
+
+/*
+ * 명령어 위치 캐시 (bash의 hash 와 같은 역할)
+ * 설명: argv[0]을 PATH에서 한 번만 찾고 절대 경로를 기억해 두어,
+ *       execvp가 매번 PATH의 모든 디렉토리에 execve를 시도하는 비용을 없앱니다.
+ */
+struct hash_entry {
+    char *name;
+    char *path;
+    unsigned hits;
+    struct hash_entry *next;
+};
+
+static struct hash_entry *buckets[HASH_BUCKETS];
+static char *hashed_path_env;   // 캐시를 만들 때의 PATH 값
+
+static unsigned hash_name(const char *s) {
+    unsigned h = 5381;
+    while (*s) h = h * 33 + (unsigned char)*s++;
+    return h % HASH_BUCKETS;
+}
+
+static struct hash_entry *find_entry(const char *name) {
+    struct hash_entry *e;
+    for (e = buckets[hash_name(name)]; e != NULL; e = e->next) {
+        if (strcmp(e->name, name) == 0) return e;
+    }
+    return NULL;
+}
+
+void path_hash_clear(void) {
+    for (int b = 0; b < HASH_BUCKETS; b++) {
+        struct hash_entry *e = buckets[b];
+        while (e != NULL) {
+            struct hash_entry *next = e->next;
+            free(e->name);
+            free(e->path);
+            free(e);
+            e = next;
+        }
+        buckets[b] = NULL;
+    }
+}
+
+/* PATH가 바뀌었으면 캐시 전체를 무효화 */
+static void check_path_env(void) {
+    const char *path = getenv("PATH");
+    if (path == NULL) path = "";
+
+    if (hashed_path_env != NULL && strcmp(hashed_path_env, path) == 0) return;
+
+    path_hash_clear();
+    free(hashed_path_env);
+    hashed_path_env = strdup(path);
+}
+
+int path_hash_add(const char *name, const char *path) {
+    struct hash_entry *e;
+
+    check_path_env();
+    e = find_entry(name);
+    if (e != NULL) {
+        char *copy = strdup(path);
+        if (copy == NULL) return -1;
+        free(e->path);
+        e->path = copy;
+        return 0;
+    }
+
+    e = malloc(sizeof(*e));
+    if (e == NULL) return -1;
+    e->name = strdup(name);
+    e->path = strdup(path);
+    if (e->name == NULL || e->path == NULL) {
+        free(e->name);
+        free(e->path);
+        free(e);
+        return -1;
+    }
+    e->hits = 0;
+    e->next = buckets[hash_name(name)];
+    buckets[hash_name(name)] = e;
+    return 0;
+}
+
+/* PATH의 디렉토리를 순서대로 검사하여 실행 가능한 파일 찾기 */
+static char *search_path(const char *name) {
+    const char *p = hashed_path_env;
+    size_t nlen = strlen(name);
+
+    while (p != NULL) {
+        const char *colon = strchr(p, ':');
+        size_t dlen = colon ? (size_t)(colon - p) : strlen(p);
+        char *full = malloc(dlen + nlen + 3);
+        struct stat st;
+
+        if (full == NULL) return NULL;
+        if (dlen == 0) {
+            strcpy(full, "./"); // 빈 항목은 현재 디렉토리
+        } else {
+            memcpy(full, p, dlen);
+            full[dlen] = '/';
+            full[dlen + 1] = '\0';
+        }
+        strcat(full, name);
+
+        if (stat(full, &st) == 0 && S_ISREG(st.st_mode) && access(full, X_OK) == 0)
+            return full;
+        free(full);
+        p = colon ? colon + 1 : NULL;
+    }
+    return NULL;
+}
+
+/*
+ * 명령어 위치 조회 함수
+ * 설명: '/'가 들어 있는 이름은 그대로 사용하고, 그 외에는 캐시를 먼저 확인한 뒤
+ *       없으면 PATH를 검색하여 결과를 캐시에 저장합니다.
+ * 반환값: 실행할 경로, 찾지 못하면 NULL
+ */
+const char *path_hash_lookup(const char *name) {
+    struct hash_entry *e;
+
+    if (strchr(name, '/') != NULL) return name;
+
+    check_path_env();
+    e = find_entry(name);
+    if (e == NULL) {
+        char *full = search_path(name);
+        if (full == NULL) return NULL;
+        if (path_hash_add(name, full) < 0) {
+            free(full);
+            return NULL;
+        }
+        free(full);
+        e = find_entry(name);
+    }
+    e->hits++;
+    return e->path;
+}
+
+/* 캐시된 경로가 더 이상 유효하지 않을 때 (ENOENT 등) 항목 삭제 */
+void path_hash_forget(const char *name) {
+    struct hash_entry **pp = &buckets[hash_name(name)];
+
+    while (*pp != NULL) {
+        if (strcmp((*pp)->name, name) == 0) {
+            struct hash_entry *e = *pp;
+            *pp = e->next;
+            free(e->name);
+            free(e->path);
+            free(e);
+            return;
+        }
+        pp = &(*pp)->next;
+    }
+}
+
+/*
+ * 캐시 내용 출력 (hash, hash -l)
+ * 설명: reusable이면 다시 입력할 수 있는 'hash -p 경로 이름' 형식으로 출력합니다.
+ */
+void path_hash_print(FILE *out, int reusable) {
+    int empty = 1;
+
+    check_path_env();
+    for (int b = 0; b < HASH_BUCKETS; b++) {
+        for (struct hash_entry *e = buckets[b]; e != NULL; e = e->next) {
+            if (empty && !reusable) fprintf(out, "hits\tcommand\n");
+            empty = 0;
+            if (reusable) fprintf(out, "hash -p %s %s\n", e->path, e->name);
+            else fprintf(out, "%4u\t%s\n", e->hits, e->path);
+        }
+    }
+    if (empty) fprintf(out, "hash: hash table empty\n");
+}
@@ -0,0 +1,13 @@
+/* path_hash.h */
+#ifndef PATH_HASH_H
+#define PATH_HASH_H
+
+#include <stdio.h>
+
+const char *path_hash_lookup(const char *name);
+int path_hash_add(const char *name, const char *path);
+void path_hash_forget(const char *name);
+void path_hash_clear(void);
+void path_hash_print(FILE *out, int reusable);
+
+#endif
@@ -0,0 +1,130 @@
+#!/bin/sh
+# train.sh
+# 설명: PGO 학습 워크로드 (make pgo가 계측 빌드 뒤에 실행)
+#       큰 생성 파일에 grep/cat/cp, 작은 파일이 많은 트리에 ls/cp -r/mv/rm -r,
+#       그리고 파이프라인이 많은 my_shell 스크립트를 실행합니다.
+#       입력은 고정된 시드로 만들어 매번 같은 프로파일이 나옵니다.
+#
+# 사용: ./pgo/train.sh <빌드 디렉토리>   (PGO_SIZE_MB: 큰 파일 크기, 기본 64)
+set -e
+
+BIN=$(cd "$1" && pwd)
+SIZE_MB=${PGO_SIZE_MB:-64}
+W=$(mktemp -d "${TMPDIR:-/tmp}/pgo.XXXXXX")
+trap 'rm -rf "$W"' EXIT
+export LC_ALL=C
+
+# 1MB 분량의 텍스트 (고정 시드 LCG로 단어를 고르고, 가끔 제어 문자와 빈 줄을 섞음)
+awk 'BEGIN {
+    split("error warning info debug request response timeout connection socket kernel " \
+          "process thread memory buffer cache pipeline shell signal handler Error WARNING", w, " ");
+    x = 1; bytes = 0;
+    while (bytes < 1048576) {
+        x = (x * 69069 + 1) % 4294967296;
+        n = 3 + x % 12; line = "";
+        for (k = 0; k < n; k++) {
+            x = (x * 69069 + 1) % 4294967296;
+            line = line (k ? " " : "") w[1 + int(x / 65536) % 20];
+        }
+        if (x % 97 == 0) line = line sprintf("%c", 1 + x % 26);
+        if (x % 31 == 0) line = "";
+        print line; bytes += length(line) + 1;
+    }
+}' > "$W/chunk.txt"
+
+i=0
+: > "$W/big.txt"
+while [ $i -lt "$SIZE_MB" ]; do cat "$W/chunk.txt" >> "$W/big.txt"; i=$((i + 1)); done
+
+# 작은 파일이 많은 트리 (ls -lR, cp -r, rm -r, grep 여러 파일)
+mkdir -p "$W/tree"
+d=0
+while [ $d -lt 20 ]; do
+    mkdir -p "$W/tree/d$d/sub"
+    f=0
+    while [ $f -lt 50 ]; do
+        head -c $((f * 97 + 1)) "$W/chunk.txt" > "$W/tree/d$d/f$f.txt"
+        f=$((f + 1))
+    done
+    cp "$W/chunk.txt" "$W/tree/d$d/sub/chunk.txt"
+    d=$((d + 1))
+done
+
+cd "$W"
+
+# grep: 옵션 조합, 단일 스레드/병렬, 표준 입력
+for opts in "" -i -n -v -c -l -in -vc -ic; do
+    "$BIN/my_grep" $opts -j1 timeout big.txt > /dev/null || true
+    "$BIN/my_grep" $opts error big.txt chunk.txt > /dev/null || true
+done
+"$BIN/my_grep" -c -j4 kernel tree/d*/f*.txt > /dev/null || true
+"$BIN/my_grep" -n signal < big.txt > /dev/null || true
+"$BIN/my_grep" -c notfoundanywhere big.txt > /dev/null || true
+# 정규식: 리터럴 전처리가 있는 패턴, 없는 패턴 (DFA만), 앵커, 표준 입력
+for re in 'time(out)?' 'kernel|signal' '[0-9]{3,}' '^[a-z]+ err' 'e[a-z]*r$'; do
+    "$BIN/my_grep" -E -c -j1 "$re" big.txt > /dev/null || true
+    "$BIN/my_grep" -E -iv -j1 "$re" chunk.txt > /dev/null || true
+done
+"$BIN/my_grep" -G -n 'sig\(nal\)*' < big.txt > /dev/null || true
+# 여러 패턴: 작은 집합(-e, SIMD 거르기)과 큰 집합(-f, Aho-Corasick), 정규식 집합
+"$BIN/my_grep" -c -j1 -e timeout -e deadlock -e panic big.txt > /dev/null || true
+awk '{ for (k = 1; k <= NF; k += 7) print $k }' chunk.txt | sort -u | head -n 2000 > pats.txt
+"$BIN/my_grep" -c -j1 -f pats.txt big.txt > /dev/null || true
+"$BIN/my_grep" -ci -j1 -f pats.txt chunk.txt > /dev/null || true
+"$BIN/my_grep" -E -c -j1 -e 'err(or)?' -e '[0-9]+ms' chunk.txt > /dev/null || true
+# 재귀 검색: 순회 스레드 여러 개와 하나, 이름 거르기, 작은 파일(read)과 큰 파일(mmap)
+"$BIN/my_grep" -r -c -j4 kernel tree > /dev/null || true
+"$BIN/my_grep" -r -l -j1 --include='f1*' --exclude-dir=sub timeout . > /dev/null || true
+# 트라이그램 색인: 처음 만들기, 파일 하나를 바꾼 뒤 갱신, 색인 검색 (뒤의 ls/cp 학습 전에 지움)
+"$BIN/my_grep" --build-index tree
+echo "kernel timeout" >> tree/d3/f7.txt
+"$BIN/my_grep" --build-index tree
+"$BIN/my_grep" --index -l -j1 timeout tree > /dev/null || true
+"$BIN/my_grep" --index -c -E 'kernel|signal' tree > /dev/null || true
+rm -f tree/.my_grep.idx
+
+# cat: 변환 없음(splice/sendfile), -n -b -v -E, 표준 입력
+"$BIN/my_cat" big.txt > /dev/null
+"$BIN/my_cat" big.txt | "$BIN/my_cat" > /dev/null
+for opts in -n -b -v -E -nE -bvE; do
+    "$BIN/my_cat" $opts big.txt > /dev/null
+done
+"$BIN/my_cat" -vE < chunk.txt > /dev/null
+
+# cp/mv/ln/rm/ls: 큰 파일 하나, 트리 전체
+"$BIN/my_cp" big.txt big2.txt
+"$BIN/my_cp" -r tree tree2
+"$BIN/my_ls" -laR tree2 > /dev/null
+"$BIN/my_ls" tree2/d0 > /dev/null
+"$BIN/my_mv" tree2 tree3
+"$BIN/my_ln" -s tree3 link
+"$BIN/my_ln" -sfn tree link
+"$BIN/my_mkdir" -p a/b/c
+"$BIN/my_rmdir" a/b/c a/b a
+"$BIN/my_pwd" > /dev/null
+"$BIN/my_rm" -rf tree3 big2.txt link
+"$BIN/mybox" grep -c error chunk.txt > /dev/null
+
+# my_shell: 파이프라인이 많은 스크립트 (쉘 안 애플릿, posix_spawn, fork 세 경로 모두)
+{
+    n=0
+    while [ $n -lt 200 ]; do
+        echo "cat chunk.txt | grep -i error | grep -v debug | grep -c WARNING > /dev/null"
+        echo "grep -n kernel chunk.txt | head -n 5 | cat -n > out.txt && cat out.txt > /dev/null || echo failed"
+        echo "my_ls -l tree/d$((n % 20)) | grep txt | sort -k5 -n | tail -n 3 > /dev/null"
+        echo "echo 'a b' \"c d\" line$n | tr a-z A-Z | cat -E >> log.txt 2>&1"
+        echo "grep -c socket <<< 'socket one socket' > /dev/null; true"
+        echo "my_pwd > /dev/null; my_mkdir -p t/$n; my_rmdir t/$n"
+        n=$((n + 1))
+    done
+    echo "cat <<EOF | grep -c here"
+    echo "here document"
+    echo "EOF"
+    echo "parallel -j4 -k grep -c error ::: tree/d1/f1.txt tree/d2/f2.txt tree/d3/f3.txt > /dev/null"
+    echo "sleep 0.01 & wait"
+    echo "my_rm -rf t log.txt out.txt"
+} > pipelines.sh
+
+PATH="$BIN:$PATH" "$BIN/my_shell" pipelines.sh > /dev/null
+PATH="$BIN:$PATH" MYSHELL_APPLETS=0 "$BIN/my_shell" pipelines.sh > /dev/null
+PATH="$BIN:$PATH" MYSHELL_APPLETS=0 MYSHELL_LAUNCHER=fork "$BIN/my_shell" pipelines.sh > /dev/null
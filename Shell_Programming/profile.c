@@ -0,0 +1,213 @@
+/* profile.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include "profile.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+static int profile_fd = -1;   // MYSHELL_PROFILE 파일 (O_APPEND)
+
+static double ts_diff(struct timespec a, struct timespec b) {
+    return (b.tv_sec - a.tv_sec) + (b.tv_nsec - a.tv_nsec) / 1e9;
+}
+
+/* 경과 시간 (시계 해상도 때문에 음수가 나오면 0) */
+static double ts_span(struct timespec a, struct timespec b) {
+    double d = ts_diff(a, b);
+    return d > 0 ? d : 0;
+}
+
+static double tv_sec(struct timeval tv) {
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static double tv_diff(struct timeval a, struct timeval b) {
+    return tv_sec(b) - tv_sec(a);
+}
+
+/* 원시 wait 상태를 쉘 종료 코드로 (my_shell.c의 decode_status와 같은 규칙) */
+static int exit_code(int status) {
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return 1;
+}
+
+/*
+ * 프로파일 초기화 함수
+ * 설명: MYSHELL_PROFILE이 설정되어 있으면 그 파일을 추가 모드로 엽니다.
+ * 반환값: 1(프로파일 사용), 0(사용 안 함), -1(파일 열기 실패)
+ */
+int profile_init(void) {
+    const char *path = getenv("MYSHELL_PROFILE");
+
+    if (path == NULL || path[0] == '\0') return 0;
+    profile_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (profile_fd < 0) {
+        fprintf(stderr, "%smy_shell: MYSHELL_PROFILE: %s: %s%s\n",
+                COLOR_RED, path, strerror(errno), COLOR_RESET);
+        return -1;
+    }
+    return 1;
+}
+
+int profile_enabled(void) {
+    return profile_fd >= 0;
+}
+
+/* JSON 문자열 출력 (따옴표, 역슬래시, 제어 문자 이스케이프) */
+static void json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; s != NULL && *s != '\0'; s++) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+/* 작업 전체의 벽시계 시간 (첫 단계 시작 ~ 마지막 회수) */
+static double job_wall(const struct job *job) {
+    struct timespec first = job->procs[0].start, last = job->procs[0].end;
+
+    for (int k = 1; k < job->nprocs; k++) {
+        const struct job_proc *p = &job->procs[k];
+        if (ts_diff(p->start, first) > 0) first = p->start;
+        if (ts_diff(last, p->end) > 0) last = p->end;
+    }
+    return ts_span(first, last);
+}
+
+/*
+ * 프로파일 기록 함수 (jobs_set_done_hook으로 등록)
+ * 설명: 끝난 작업마다 JSON 한 줄을 기록합니다. 한 줄을 메모리에서 만든 뒤
+ *       write 한 번으로 추가하므로 여러 쉘이 같은 파일을 써도 줄이 섞이지 않습니다.
+ */
+void profile_job(const struct job *job) {
+    struct timeval now;
+    char *line = NULL;
+    size_t len = 0;
+    FILE *out;
+
+    if (profile_fd < 0 || job->nprocs == 0) return;
+    out = open_memstream(&line, &len);
+    if (out == NULL) return;
+
+    gettimeofday(&now, NULL);
+    fprintf(out, "{\"time\":%.6f,\"cmd\":", tv_sec(now));
+    json_string(out, job->cmd);
+    fprintf(out, ",\"bg\":%s,\"status\":%d,\"wall\":%.6f,\"stages\":[",
+            job->bg ? "true" : "false",
+            exit_code(job->procs[job->nprocs - 1].status), job_wall(job));
+
+    for (int k = 0; k < job->nprocs; k++) {
+        const struct job_proc *p = &job->procs[k];
+        fprintf(out, "%s{\"cmd\":", k > 0 ? "," : "");
+        json_string(out, p->cmd);
+        fprintf(out, ",\"pid\":%d,\"status\":%d,\"wall\":%.6f,\"user\":%.6f,\"sys\":%.6f,"
+                     "\"maxrss_kb\":%ld,\"vcsw\":%ld,\"ivcsw\":%ld}",
+                (int)p->pid, exit_code(p->status), ts_span(p->start, p->end),
+                tv_sec(p->ru.ru_utime), tv_sec(p->ru.ru_stime),
+                p->ru.ru_maxrss, p->ru.ru_nvcsw, p->ru.ru_nivcsw);
+    }
+    fprintf(out, "]}\n");
+    fclose(out);
+
+    if (line != NULL) {
+        ssize_t n = write(profile_fd, line, len);
+        (void)n;
+    }
+    free(line);
+}
+
+static void time_header(FILE *out) {
+    fprintf(out, "  %-5s %9s %9s %9s %10s %6s %6s  %s\n",
+            "stage", "real", "user", "sys", "maxrss", "vcsw", "ivcsw", "command");
+}
+
+/*
+ * time 결과 출력 함수 (파이프라인)
+ * 설명: 전체 real/user/sys와 단계별 real/user/sys 시간, 최대 RSS,
+ *       자발적/비자발적 문맥 교환 횟수를 출력합니다.
+ */
+void time_report_job(FILE *out, const struct job *job) {
+    double user = 0, sys = 0;
+
+    if (job->nprocs == 0) return;
+    for (int k = 0; k < job->nprocs; k++) {
+        user += tv_sec(job->procs[k].ru.ru_utime);
+        sys += tv_sec(job->procs[k].ru.ru_stime);
+    }
+
+    fprintf(out, "\nreal\t%.3fs\nuser\t%.3fs\nsys\t%.3fs\n", job_wall(job), user, sys);
+    time_header(out);
+    for (int k = 0; k < job->nprocs; k++) {
+        const struct job_proc *p = &job->procs[k];
+        fprintf(out, "  %-5d %8.3fs %8.3fs %8.3fs %8ldKB %6ld %6ld  %s\n",
+                k + 1, ts_span(p->start, p->end),
+                tv_sec(p->ru.ru_utime), tv_sec(p->ru.ru_stime),
+                p->ru.ru_maxrss, p->ru.ru_nvcsw, p->ru.ru_nivcsw,
+                p->cmd != NULL ? p->cmd : "");
+    }
+}
+
+/* 쉘 내부 실행 측정 시작 (RUSAGE_SELF 기준) */
+void shell_timer_start(struct shell_timer *t) {
+    getrusage(RUSAGE_SELF, &t->ru);
+    clock_gettime(CLOCK_MONOTONIC, &t->start);
+}
+
+/*
+ * time 결과 출력 함수 (쉘 안에서 실행된 내장 명령어)
+ * 설명: 쉘 프로세스 자신의 자원 사용량 차이를 출력하고, 프로파일에도 기록합니다.
+ */
+void time_report_shell(FILE *out, const struct shell_timer *t, const char *cmd, int status) {
+    struct timespec end;
+    struct rusage ru;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    getrusage(RUSAGE_SELF, &ru);
+
+    double wall = ts_span(t->start, end);
+    double user = tv_diff(t->ru.ru_utime, ru.ru_utime);
+    double sys = tv_diff(t->ru.ru_stime, ru.ru_stime);
+    long vcsw = ru.ru_nvcsw - t->ru.ru_nvcsw;
+    long ivcsw = ru.ru_nivcsw - t->ru.ru_nivcsw;
+
+    if (out != NULL) {
+        fprintf(out, "\nreal\t%.3fs\nuser\t%.3fs\nsys\t%.3fs\n", wall, user, sys);
+        time_header(out);
+        fprintf(out, "  %-5s %8.3fs %8.3fs %8.3fs %8ldKB %6ld %6ld  %s\n",
+                "shell", wall, user, sys, ru.ru_maxrss, vcsw, ivcsw, cmd);
+    }
+
+    if (profile_fd >= 0) {
+        struct timeval now;
+        char *line = NULL;
+        size_t len = 0;
+        FILE *js = open_memstream(&line, &len);
+
+        if (js == NULL) return;
+        gettimeofday(&now, NULL);
+        fprintf(js, "{\"time\":%.6f,\"cmd\":", tv_sec(now));
+        json_string(js, cmd);
+        fprintf(js, ",\"builtin\":true,\"status\":%d,\"wall\":%.6f,\"user\":%.6f,\"sys\":%.6f,"
+                    "\"maxrss_kb\":%ld,\"vcsw\":%ld,\"ivcsw\":%ld}\n",
+                status, wall, user, sys, ru.ru_maxrss, vcsw, ivcsw);
+        fclose(js);
+        if (line != NULL) {
+            ssize_t n = write(profile_fd, line, len);
+            (void)n;
+        }
+        free(line);
+    }
+}
@@ -0,0 +1,24 @@
+/* profile.h */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "jobs.h"
+
+/* 쉘 안에서 실행한 내장 명령어의 측정 시작점 (time cd ...) */
+struct shell_timer {
+    struct timespec start;
+    struct rusage ru;
+};
+
+int profile_init(void);
+int profile_enabled(void);
+void profile_job(const struct job *job);
+void time_report_job(FILE *out, const struct job *job);
+void shell_timer_start(struct shell_timer *t);
+void time_report_shell(FILE *out, const struct shell_timer *t, const char *cmd, int status);
+
+#endif
@@ -0,0 +1,291 @@
+/* remove_core.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#include "remove_core.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define RM_DENTS_SIZE  (256 * 1024)   // getdents64 한 번에 읽을 버퍼 크기 (스레드마다)
+
+/*
+ * 삭제할 디렉토리 하나
+ * 설명: 부모 디렉토리의 fd를 기준으로 이름만 기억하므로 경로를 다시 해석하지 않습니다.
+ *       pending은 "자신의 탐색 + 끝나지 않은 하위 디렉토리 수"이며, 0이 되는 순간
+ *       디렉토리가 비었으므로 그 스레드가 rmdir 하고 부모의 pending을 줄입니다.
+ *       부모의 fd는 모든 하위 디렉토리가 끝날 때까지 열려 있습니다.
+ */
+struct rm_dir {
+    struct rm_dir *parent;
+    struct rm_dir *next;       // 작업 스택
+    char *name;                // 부모 기준 이름 (최상위는 인자 경로)
+    int fd;
+    atomic_int pending;
+};
+
+struct rm_ctx {
+    const struct remove_opts *opts;
+    pthread_mutex_t lock;
+    pthread_cond_t cv;
+    struct rm_dir *stack;      // 탐색을 기다리는 디렉토리 (깊은 것부터 처리)
+    int done;                  // 최상위 디렉토리까지 끝남
+    atomic_int errors;
+};
+
+/* 오류 메시지용 경로 만들기 (오류가 났을 때만 부모를 따라 올라가며 조립) */
+static char *dir_path(const struct rm_dir *d, const char *name) {
+    size_t len = name != NULL ? strlen(name) + 1 : 0;
+    char *path, *end;
+
+    for (const struct rm_dir *p = d; p != NULL; p = p->parent) len += strlen(p->name) + 1;
+    path = malloc(len + 1);
+    if (path == NULL) return NULL;
+
+    end = path + len;
+    *end = '\0';
+    if (name != NULL) {
+        end -= strlen(name);
+        memcpy(end, name, strlen(name));
+        *--end = '/';
+    }
+    for (const struct rm_dir *p = d; p != NULL; p = p->parent) {
+        size_t l = strlen(p->name);
+        end -= l;
+        memcpy(end, p->name, l);
+        if (p->parent != NULL) *--end = '/';
+    }
+    memmove(path, end, strlen(end) + 1);
+    return path;
+}
+
+static void report(struct rm_ctx *ctx, const struct rm_dir *d, const char *name, int err) {
+    char *path = dir_path(d, name);
+
+    fprintf(stderr, "%srm: cannot remove '%s': %s%s\n", COLOR_RED,
+            path != NULL ? path : (name != NULL ? name : d->name), strerror(err), COLOR_RESET);
+    free(path);
+    atomic_fetch_add(&ctx->errors, 1);
+}
+
+static void push_dir(struct rm_ctx *ctx, struct rm_dir *d) {
+    pthread_mutex_lock(&ctx->lock);
+    d->next = ctx->stack;
+    ctx->stack = d;
+    pthread_cond_signal(&ctx->cv);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+/*
+ * 디렉토리 하나 마무리
+ * 설명: pending이 0이 되면 rmdir 하고, 부모도 같은 방식으로 마무리합니다.
+ *       최상위까지 끝나면 대기 중인 스레드를 모두 깨웁니다.
+ */
+static void finish_dir(struct rm_ctx *ctx, struct rm_dir *d) {
+    while (d != NULL && atomic_fetch_sub(&d->pending, 1) == 1) {
+        struct rm_dir *parent = d->parent;
+
+        if (d->fd >= 0) close(d->fd);
+        if (unlinkat(parent != NULL ? parent->fd : AT_FDCWD, d->name, AT_REMOVEDIR) < 0 &&
+            !(errno == ENOENT && ctx->opts->force))
+            report(ctx, parent, d->name, errno);
+
+        if (parent == NULL) {
+            pthread_mutex_lock(&ctx->lock);
+            ctx->done = 1;
+            pthread_cond_broadcast(&ctx->cv);
+            pthread_mutex_unlock(&ctx->lock);
+        }
+        free(d->name);
+        free(d);
+        d = parent;
+    }
+}
+
+/* 하위 디렉토리 작업 만들기 (부모의 pending을 먼저 늘림) */
+static int add_subdir(struct rm_ctx *ctx, struct rm_dir *parent, const char *name) {
+    struct rm_dir *d = calloc(1, sizeof(*d));
+
+    if (d == NULL || (d->name = strdup(name)) == NULL) {
+        free(d);
+        return -1;
+    }
+    d->parent = parent;
+    d->fd = -1;
+    atomic_init(&d->pending, 1);
+    atomic_fetch_add(&parent->pending, 1);
+    push_dir(ctx, d);
+    return 0;
+}
+
+/*
+ * 디렉토리 하나 비우기
+ * 설명: 파일은 이 디렉토리의 fd 기준 unlinkat으로 바로 지우고, 하위 디렉토리는
+ *       작업 스택에 넣어 다른 스레드가 동시에 처리할 수 있게 합니다.
+ *       d_type이 없는 파일 시스템에서는 unlinkat이 EISDIR을 돌려주면 디렉토리로 봅니다.
+ */
+static void scan_dir(struct rm_ctx *ctx, struct rm_dir *d, char *buf) {
+    int parent_fd = d->parent != NULL ? d->parent->fd : AT_FDCWD;
+
+    d->fd = openat(parent_fd, d->name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (d->fd < 0) {
+        report(ctx, d->parent, d->name, errno);
+        finish_dir(ctx, d);
+        return;
+    }
+
+    for (;;) {
+        ssize_t n = getdents64(d->fd, buf, RM_DENTS_SIZE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) report(ctx, d, NULL, errno);
+        if (n <= 0) break;
+
+        for (ssize_t off = 0; off < n; ) {
+            struct dirent64 *e = (struct dirent64 *)(buf + off);
+            const char *name = e->d_name;
+            int is_dir = e->d_type == DT_DIR;
+
+            off += e->d_reclen;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+            if (!is_dir && unlinkat(d->fd, name, 0) < 0) {
+                int err = errno;
+                if (err == EISDIR || err == EPERM) {
+                    struct stat st;
+                    is_dir = fstatat(d->fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+                }
+                if (!is_dir) {
+                    if (err != ENOENT) report(ctx, d, name, err);
+                    continue;
+                }
+            }
+            if (is_dir && add_subdir(ctx, d, name) < 0) report(ctx, d, name, ENOMEM);
+        }
+    }
+    finish_dir(ctx, d);
+}
+
+/* 삭제 스레드: 최상위 디렉토리가 끝날 때까지 스택에서 디렉토리를 꺼내 비움 */
+static void *remove_worker(void *arg) {
+    struct rm_ctx *ctx = arg;
+    char *buf = malloc(RM_DENTS_SIZE);
+
+    if (buf == NULL) return NULL;   // 다른 스레드(최소한 호출한 스레드)가 계속 처리
+    for (;;) {
+        pthread_mutex_lock(&ctx->lock);
+        while (ctx->stack == NULL && !ctx->done)
+            pthread_cond_wait(&ctx->cv, &ctx->lock);
+        if (ctx->done) {
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        struct rm_dir *d = ctx->stack;
+        ctx->stack = d->next;
+        pthread_mutex_unlock(&ctx->lock);
+
+        scan_dir(ctx, d, buf);
+    }
+    free(buf);
+    return NULL;
+}
+
+/*
+ * 디렉토리 트리 삭제 (rm -r)
+ * 설명: 독립된 하위 트리를 jobs개의 스레드가 동시에 삭제합니다.
+ *       열려 있는 디렉토리 fd는 대략 깊이 × 스레드 수이므로 fd 한도를 올려 두고,
+ *       쉘 안에서 실행되는 경우를 위해 끝나면 원래 한도로 되돌립니다.
+ * 반환값: 오류 개수
+ */
+static int remove_tree(const char *path, const struct remove_opts *opts) {
+    struct rm_ctx ctx;
+    struct rm_dir *root = calloc(1, sizeof(*root));
+    struct rlimit rl, saved;
+    int raised = 0;
+    int jobs = opts->jobs > 0 ? opts->jobs : 1;
+    pthread_t *tids = malloc(jobs * sizeof(*tids));
+    int started = 0;
+
+    if (root == NULL || tids == NULL || (root->name = strdup(path)) == NULL) {
+        fprintf(stderr, "%srm: %s%s\n", COLOR_RED, strerror(ENOMEM), COLOR_RESET);
+        free(root);
+        free(tids);
+        return 1;
+    }
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        saved = rl;
+        rl.rlim_cur = rl.rlim_max;
+        raised = setrlimit(RLIMIT_NOFILE, &rl) == 0;
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.opts = opts;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cv, NULL);
+    atomic_init(&ctx.errors, 0);
+    root->fd = -1;
+    atomic_init(&root->pending, 1);
+    ctx.stack = root;
+
+    for (int k = 1; k < jobs; k++)
+        if (pthread_create(&tids[started], NULL, remove_worker, &ctx) == 0) started++;
+    remove_worker(&ctx);
+    for (int k = 0; k < started; k++) pthread_join(tids[k], NULL);
+
+    pthread_mutex_destroy(&ctx.lock);
+    pthread_cond_destroy(&ctx.cv);
+    free(tids);
+    if (raised) setrlimit(RLIMIT_NOFILE, &saved);
+    return atomic_load(&ctx.errors);
+}
+
+/*
+ * 경로 하나 삭제
+ * 설명: 파일과 심볼릭 링크는 unlink, 디렉토리는 -r일 때만 트리째 삭제합니다.
+ * 반환값: 오류 개수 (0이면 성공)
+ */
+int remove_path(const char *path, const struct remove_opts *opts) {
+    const char *base = strrchr(path, '/');
+    struct stat st;
+
+    // '.', '..'은 (경로 끝이라도) 지우지 않음
+    base = (base != NULL) ? base + 1 : path;
+    if (strcmp(base, ".") == 0 || strcmp(base, "..") == 0) {
+        fprintf(stderr, "%srm: refusing to remove '.' or '..' directory: skipping '%s'%s\n",
+                COLOR_RED, path, COLOR_RESET);
+        return 1;
+    }
+
+    if (lstat(path, &st) < 0) {
+        if (errno == ENOENT && opts->force) return 0;
+        fprintf(stderr, "%srm: cannot remove '%s': %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+        return 1;
+    }
+
+    if (!S_ISDIR(st.st_mode)) {
+        if (unlink(path) < 0 && !(errno == ENOENT && opts->force)) {
+            fprintf(stderr, "%srm: cannot remove '%s': %s%s\n", COLOR_RED, path, strerror(errno), COLOR_RESET);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!opts->recursive) {
+        fprintf(stderr, "%srm: cannot remove '%s': Is a directory%s\n", COLOR_RED, path, COLOR_RESET);
+        return 1;
+    }
+    if (strcmp(path, "/") == 0) {
+        fprintf(stderr, "%srm: it is dangerous to operate recursively on '/'%s\n", COLOR_RED, COLOR_RESET);
+        return 1;
+    }
+    return remove_tree(path, opts);
+}
@@ -0,0 +1,16 @@
+/* remove_core.h */
+#ifndef REMOVE_CORE_H
+#define REMOVE_CORE_H
+
+/*
+ * rm 옵션 (-r -f -j N)
+ */
+struct remove_opts {
+    int recursive;   // -r, -R: 디렉토리 트리 삭제
+    int force;       // -f: 없는 파일은 무시
+    int jobs;        // 하위 트리를 동시에 삭제할 스레드 수
+};
+
+int remove_path(const char *path, const struct remove_opts *opts);
+
+#endif
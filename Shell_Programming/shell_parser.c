@@ -0,0 +1,673 @@
+/* shell_parser.c */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "shell_parser.h"
+
+#define COLOR_RED    "\x1b[31m"
+#define COLOR_RESET  "\x1b[0m"
+
+#define ARENA_BLOCK_SIZE (64 * 1024)   // 첫 아레나 블록 크기
+#define ARENA_ALIGN      8
+
+/* ================================ 아레나 ================================ */
+
+static struct arena_block *block_new(size_t size) {
+    struct arena_block *b = malloc(sizeof(*b) + size);
+    if (b == NULL) return NULL;
+    b->next = NULL;
+    b->size = size;
+    b->used = 0;
+    return b;
+}
+
+void arena_init(struct arena *a) {
+    a->head = NULL;
+    a->cur = NULL;
+}
+
+/*
+ * 아레나 할당 함수
+ * 설명: 현재 블록에서 잘라 주고, 모자라면 두 배 크기의 블록을 뒤에 붙입니다.
+ * 반환값: 8바이트 정렬된 메모리, 실패 시 NULL
+ */
+void *arena_alloc(struct arena *a, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (a->cur == NULL || a->cur->used + size > a->cur->size) {
+        size_t bsize = a->cur != NULL ? a->cur->size * 2 : ARENA_BLOCK_SIZE;
+        if (bsize < size) bsize = size;
+
+        struct arena_block *b = block_new(bsize);
+        if (b == NULL) return NULL;
+        if (a->cur != NULL) a->cur->next = b;
+        else a->head = b;
+        a->cur = b;
+    }
+
+    void *mem = a->cur->data + a->cur->used;
+    a->cur->used += size;
+    return mem;
+}
+
+/*
+ * 아레나 초기화 함수 (다음 줄 파싱 전에 호출)
+ * 설명: 블록이 여러 개로 늘어났다면 전체 크기의 블록 하나로 합쳐 두므로,
+ *       같은 크기의 줄이 반복되면 더 이상 malloc이 일어나지 않습니다.
+ */
+void arena_reset(struct arena *a) {
+    if (a->head == NULL) return;
+
+    if (a->head->next != NULL) {
+        size_t total = 0;
+        for (struct arena_block *b = a->head; b != NULL; ) {
+            struct arena_block *next = b->next;
+            total += b->size;
+            free(b);
+            b = next;
+        }
+        a->head = block_new(total);
+    }
+    if (a->head != NULL) a->head->used = 0;
+    a->cur = a->head;
+}
+
+void arena_free(struct arena *a) {
+    for (struct arena_block *b = a->head; b != NULL; ) {
+        struct arena_block *next = b->next;
+        free(b);
+        b = next;
+    }
+    a->head = NULL;
+    a->cur = NULL;
+}
+
+/* ================================ 렉서 ================================ */
+
+enum tok_type {
+    TOK_WORD,
+    TOK_PIPE,      // |
+    TOK_OR_IF,     // ||
+    TOK_AMP,       // &
+    TOK_AND_IF,    // &&
+    TOK_SEMI,      // ; 또는 개행
+    TOK_REDIR,     // < > >> <& >& &> &>> << <<- <<< (앞에 fd 번호 가능)
+    TOK_END,       // 줄 끝 (또는 주석)
+    TOK_ERROR      // 닫히지 않은 따옴표, 메모리 부족
+};
+
+struct token {
+    int type;
+    char *text;    // TOK_WORD: 따옴표/역슬래시를 처리한 단어 (아레나), TOK_REDIR: 연산자
+    int quoted;    // 단어에 따옴표나 역슬래시가 있었는지 ('time' 키워드 판별용)
+    int rtype;     // TOK_REDIR: enum redir_type
+    int rfd;       // TOK_REDIR: 대상 fd (-1: &>, &>> 처럼 표준 출력과 표준 오류 모두)
+    int strip;     // TOK_REDIR: <<- (here 문서의 앞쪽 탭 제거)
+};
+
+static const char *tok_name(const struct token *tok) {
+    switch (tok->type) {
+        case TOK_WORD:   return tok->text;
+        case TOK_PIPE:   return "|";
+        case TOK_OR_IF:  return "||";
+        case TOK_AMP:    return "&";
+        case TOK_AND_IF: return "&&";
+        case TOK_SEMI:   return ";";
+        case TOK_REDIR:  return tok->text;
+        default:         return "newline";
+    }
+}
+
+static void syntax_error(struct shell_parser *p, const struct token *tok) {
+    if (p->quiet) return;
+    fprintf(stderr, "%ssyntax error near unexpected token '%s'%s\n",
+            COLOR_RED, tok_name(tok), COLOR_RESET);
+}
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/* 따옴표 밖에서 단어를 끝내는 문자 */
+static int is_meta(char c) {
+    return is_blank(c) || c == '\n' || c == '|' || c == '&' || c == ';' || c == '<' || c == '>';
+}
+
+/*
+ * 단어 하나 읽기
+ * 설명: 1단계에서 따옴표를 고려하여 단어의 끝을 찾고, 2단계에서 그 길이만큼
+ *       아레나에 할당한 뒤 따옴표와 역슬래시를 제거하며 복사합니다 (둘 다 선형).
+ *       '...'는 그대로, "..." 안에서는 \" \\ \$ \` 만 이스케이프입니다.
+ */
+static int lex_word(struct shell_parser *p, struct token *tok) {
+    const char *s = p->pos, *end = p->end;
+    const char *q = s;
+    int quoted = 0;
+
+    // 1단계: 단어 끝 찾기
+    while (q < end && !is_meta(*q)) {
+        if (*q == '\'' || *q == '"') {
+            char quote = *q++;
+            quoted = 1;
+            while (q < end && *q != quote) {
+                if (quote == '"' && *q == '\\' && q + 1 < end) q++;
+                q++;
+            }
+            if (q == end) {
+                p->open_quote = quote;
+                if (!p->quiet && !p->more)
+                    fprintf(stderr, "%sunexpected EOF while looking for matching '%c'%s\n",
+                            COLOR_RED, quote, COLOR_RESET);
+                tok->type = TOK_ERROR;
+                return -1;
+            }
+            q++;
+        } else if (*q == '\\') {
+            quoted = 1;
+            q += (q + 1 < end) ? 2 : 1;
+        } else {
+            q++;
+        }
+    }
+
+    // 2단계: 따옴표를 제거하며 아레나로 복사
+    char *out = arena_alloc(&p->arena, (size_t)(q - s) + 1);
+    char *w = out;
+    if (out == NULL) {
+        perror("malloc failed");
+        tok->type = TOK_ERROR;
+        return -1;
+    }
+    if (!quoted) {
+        memcpy(out, s, q - s);
+        w += q - s;
+    } else {
+        const char *r = s;
+        while (r < q) {
+            if (*r == '\'') {
+                const char *close = memchr(r + 1, '\'', q - r - 1);
+                memcpy(w, r + 1, close - r - 1);
+                w += close - r - 1;
+                r = close + 1;
+            } else if (*r == '"') {
+                for (r++; *r != '"'; r++) {
+                    if (*r == '\\' && (r[1] == '"' || r[1] == '\\' || r[1] == '$' || r[1] == '`'))
+                        r++;
+                    *w++ = *r;
+                }
+                r++;
+            } else if (*r == '\\') {
+                if (r + 1 < q) *w++ = r[1];
+                r += 2;
+            } else {
+                *w++ = *r++;
+            }
+        }
+    }
+    *w = '\0';
+
+    p->pos = q;
+    tok->type = TOK_WORD;
+    tok->text = out;
+    tok->quoted = quoted;
+    return 0;
+}
+
+/* s에서 연산자 op가 시작하는지 확인 */
+static int match(const char *s, const char *end, const char *op) {
+    size_t len = strlen(op);
+    return (size_t)(end - s) >= len && memcmp(s, op, len) == 0;
+}
+
+/* 재지향 연산자 표: 긴 것부터 비교 */
+static const struct {
+    const char *op;
+    int rtype;
+    int rfd;
+    int strip;
+} redir_ops[] = {
+    { "<<<", REDIR_HERESTR, 0, 0 },
+    { "<<-", REDIR_HEREDOC, 0, 1 },
+    { "<<",  REDIR_HEREDOC, 0, 0 },
+    { "<&",  REDIR_DUP,     0, 0 },
+    { "<",   REDIR_IN,      0, 0 },
+    { ">>",  REDIR_APPEND,  1, 0 },
+    { ">&",  REDIR_DUP,     1, 0 },
+    { ">|",  REDIR_OUT,     1, 0 },
+    { ">",   REDIR_OUT,     1, 0 },
+    { "&>>", REDIR_APPEND, -1, 0 },
+    { "&>",  REDIR_OUT,    -1, 0 },
+};
+
+#define NUM_REDIR_OPS (int)(sizeof(redir_ops) / sizeof(redir_ops[0]))
+
+/* 다음 토큰 읽기 */
+static int lex_next(struct shell_parser *p, struct token *tok) {
+    const char *s = p->pos, *end = p->end;
+    int io_fd = -1;
+
+    while (s < end && is_blank(*s)) s++;
+    p->pos = s;
+
+    if (s == end || *s == '#') {   // 단어 시작 위치의 '#'부터는 주석
+        p->pos = end;
+        tok->type = TOK_END;
+        return 0;
+    }
+
+    // fd 번호: 숫자 바로 뒤에 '<' 또는 '>'가 오면 재지향 대상 fd (2>file, 2>&1)
+    const char *d = s;
+    while (d < end && d - s < 5 && *d >= '0' && *d <= '9') d++;
+    if (d > s && d < end && (*d == '<' || *d == '>')) {
+        io_fd = 0;
+        for (const char *c = s; c < d; c++) io_fd = io_fd * 10 + (*c - '0');
+        s = d;
+    }
+
+    if (*s == '<' || *s == '>' || (*s == '&' && s + 1 < end && s[1] == '>')) {
+        for (int k = 0; k < NUM_REDIR_OPS; k++) {
+            if (!match(s, end, redir_ops[k].op)) continue;
+            if (io_fd >= 0 && redir_ops[k].rfd < 0) break; // 2&> 같은 형태는 없음
+
+            tok->type = TOK_REDIR;
+            tok->text = (char *)redir_ops[k].op;
+            tok->rtype = redir_ops[k].rtype;
+            tok->rfd = io_fd >= 0 ? io_fd : redir_ops[k].rfd;
+            tok->strip = redir_ops[k].strip;
+            p->pos = s + strlen(redir_ops[k].op);
+            return 0;
+        }
+    }
+
+    switch (*s) {
+        case '\n':
+        case ';':
+            tok->type = TOK_SEMI;
+            break;
+        case '|':
+            tok->type = (s + 1 < end && s[1] == '|') ? TOK_OR_IF : TOK_PIPE;
+            break;
+        case '&':
+            tok->type = (s + 1 < end && s[1] == '&') ? TOK_AND_IF : TOK_AMP;
+            break;
+        default:
+            return lex_word(p, tok);
+    }
+
+    p->pos = s + ((tok->type == TOK_OR_IF || tok->type == TOK_AND_IF) ? 2 : 1);
+    return 0;
+}
+
+/* ================================ 파서 ================================ */
+
+void parser_init(struct shell_parser *p) {
+    memset(p, 0, sizeof(*p));
+    arena_init(&p->arena);
+}
+
+void parser_free(struct shell_parser *p) {
+    arena_free(&p->arena);
+    free(p->words);
+    free(p->redirs);
+    free(p->cmds);
+    free(p->pipes);
+    free(p->ops);
+    free(p->items);
+    free(p->heredocs);
+    free(p->text);
+    free(p->joined);
+    memset(p, 0, sizeof(*p));
+}
+
+/* 임시 배열에 한 칸 확보 (부족할 때만 두 배로 늘림) */
+static int reserve(void **arr, size_t *cap, size_t n, size_t elem) {
+    if (n < *cap) return 0;
+
+    size_t ncap = *cap ? *cap * 2 : 16;
+    void *grown = realloc(*arr, ncap * elem);
+    if (grown == NULL) {
+        perror("malloc failed");
+        return -1;
+    }
+    *arr = grown;
+    *cap = ncap;
+    return 0;
+}
+
+/* 임시 배열의 앞 n개를 아레나로 복사 (extra: 뒤에 덧붙일 빈 칸 수) */
+static void *arena_copy(struct arena *a, const void *src, size_t n, size_t elem, size_t extra) {
+    void *dst = arena_alloc(a, (n + extra) * elem);
+    if (dst == NULL) {
+        perror("malloc failed");
+        return NULL;
+    }
+    if (n > 0) memcpy(dst, src, n * elem);
+    return dst;
+}
+
+#define RESERVE(p, field, n) \
+    reserve((void **)&(p)->field, &(p)->field##_cap, (n), sizeof(*(p)->field))
+
+/* 모두 숫자인지 확인 (n>&m 의 m) */
+static int is_number(const char *s) {
+    if (*s == '\0') return 0;
+    for (; *s != '\0'; s++)
+        if (*s < '0' || *s > '9') return 0;
+    return 1;
+}
+
+/*
+ * 재지향 하나를 임시 배열에 추가
+ * 설명: &> file 과 >& file 은 "> file 2>&1" 두 개로 펼칩니다.
+ *       here 문자열은 끝에 개행을 붙인 내용을 아레나에 만들고, here 문서는
+ *       본문을 나중에 읽으므로 src_fd에 <<- 여부만 잠시 기록해 둡니다.
+ */
+static int add_redir(struct shell_parser *p, size_t *n, const struct token *op,
+                     const struct token *word) {
+    struct redir r = { op->rtype, op->rfd, word->text, 0, -1 };
+    int both = op->rfd < 0;
+
+    if (r.type == REDIR_DUP) {
+        if (strcmp(word->text, "-") == 0) {
+            r.src_fd = -1;
+        } else if (is_number(word->text)) {
+            r.src_fd = atoi(word->text);
+        } else if (r.fd == 1 && op->text[0] == '>') {
+            r.type = REDIR_OUT; // >& file
+            both = 1;
+        } else {
+            if (!p->quiet)
+                fprintf(stderr, "%s%s: ambiguous redirect%s\n", COLOR_RED, word->text, COLOR_RESET);
+            return -1;
+        }
+    } else if (r.type == REDIR_HERESTR) {
+        size_t len = strlen(word->text);
+        char *body = arena_alloc(&p->arena, len + 2);
+        if (body == NULL) {
+            perror("malloc failed");
+            return -1;
+        }
+        memcpy(body, word->text, len);
+        body[len] = '\n';
+        body[len + 1] = '\0';
+        r.target = body;
+        r.len = len + 1;
+    } else if (r.type == REDIR_HEREDOC) {
+        r.src_fd = op->strip;
+    }
+
+    if (both) r.fd = STDOUT_FILENO;
+    if (RESERVE(p, redirs, *n + 1) < 0) return -1;
+    p->redirs[(*n)++] = r;
+    if (both) {
+        struct redir dup = { REDIR_DUP, STDERR_FILENO, NULL, 0, STDOUT_FILENO };
+        p->redirs[(*n)++] = dup;
+    }
+    return 0;
+}
+
+/*
+ * 단순 명령어 파싱: (단어 | 재지향)+
+ * 설명: tok은 명령어의 첫 토큰이며, 끝나면 명령어 다음 토큰이 들어 있습니다.
+ */
+static int parse_command(struct shell_parser *p, struct token *tok, struct ast_command *cmd) {
+    size_t nwords = 0, nredirs = 0;
+
+    for (;;) {
+        if (tok->type == TOK_WORD) {
+            if (RESERVE(p, words, nwords) < 0) return -1;
+            p->words[nwords++] = tok->text;
+        } else if (tok->type == TOK_REDIR) {
+            struct token op = *tok;
+
+            if (lex_next(p, tok) < 0) return -1;
+            if (tok->type != TOK_WORD) {
+                syntax_error(p, tok);
+                return -1;
+            }
+            if (add_redir(p, &nredirs, &op, tok) < 0) return -1;
+        } else {
+            break;
+        }
+        if (lex_next(p, tok) < 0) return -1;
+    }
+
+    if (nwords == 0 && nredirs == 0) {
+        syntax_error(p, tok);
+        return -1;
+    }
+
+    cmd->argv = arena_copy(&p->arena, p->words, nwords, sizeof(char *), 1);
+    cmd->redirs = arena_copy(&p->arena, p->redirs, nredirs, sizeof(struct redir), 0);
+    if (cmd->argv == NULL || cmd->redirs == NULL) return -1;
+    cmd->argv[nwords] = NULL;
+    cmd->argc = (int)nwords;
+    cmd->nredirs = (int)nredirs;
+
+    // here 문서는 줄을 다 파싱한 뒤 parse_heredocs가 본문을 채움
+    for (size_t k = 0; k < nredirs; k++) {
+        struct redir *r = &cmd->redirs[k];
+        if (r->type != REDIR_HEREDOC) continue;
+        if (RESERVE(p, heredocs, p->nheredocs) < 0) return -1;
+        p->heredocs[p->nheredocs].redir = r;
+        p->heredocs[p->nheredocs].strip_tabs = r->src_fd;
+        p->nheredocs++;
+        r->src_fd = -1;
+    }
+    return 0;
+}
+
+/* 파이프라인 파싱: [time] command ('|' command)* */
+static int parse_pipeline(struct shell_parser *p, struct token *tok, struct ast_pipeline *pl) {
+    size_t n = 0;
+
+    pl->timed = 0;
+    if (tok->type == TOK_WORD && !tok->quoted && strcmp(tok->text, "time") == 0) {
+        pl->timed = 1;
+        if (lex_next(p, tok) < 0) return -1;
+        // 'time' 단독 (측정할 명령어 없음)
+        if (tok->type == TOK_END || tok->type == TOK_SEMI || tok->type == TOK_AMP) {
+            pl->cmds = NULL;
+            pl->ncmds = 0;
+            return 0;
+        }
+    }
+
+    for (;;) {
+        struct ast_command cmd;
+
+        if (parse_command(p, tok, &cmd) < 0) return -1;
+        if (RESERVE(p, cmds, n) < 0) return -1;
+        p->cmds[n++] = cmd;
+
+        if (tok->type != TOK_PIPE) break;
+        if (lex_next(p, tok) < 0) return -1;
+    }
+
+    pl->cmds = arena_copy(&p->arena, p->cmds, n, sizeof(struct ast_command), 0);
+    if (pl->cmds == NULL) return -1;
+    pl->ncmds = (int)n;
+    return 0;
+}
+
+/* and-or 목록 파싱: pipeline (('&&' | '||') pipeline)* */
+static int parse_and_or(struct shell_parser *p, struct token *tok, struct ast_and_or *ao) {
+    size_t n = 0;
+    int op = AST_SEQ;
+
+    for (;;) {
+        struct ast_pipeline pl;
+
+        if (parse_pipeline(p, tok, &pl) < 0) return -1;
+        if (RESERVE(p, pipes, n) < 0 || RESERVE(p, ops, n) < 0) return -1;
+        p->pipes[n] = pl;
+        p->ops[n] = op;
+        n++;
+
+        if (tok->type == TOK_AND_IF) op = AST_AND;
+        else if (tok->type == TOK_OR_IF) op = AST_OR;
+        else break;
+        if (lex_next(p, tok) < 0) return -1;
+    }
+
+    ao->pipes = arena_copy(&p->arena, p->pipes, n, sizeof(struct ast_pipeline), 0);
+    ao->ops = arena_copy(&p->arena, p->ops, n, sizeof(int), 0);
+    if (ao->pipes == NULL || ao->ops == NULL) return -1;
+    ao->npipes = (int)n;
+    return 0;
+}
+
+/*
+ * 한 줄 파싱 함수
+ * 설명: list := and_or ((';' | '&') and_or)* [';' | '&']
+ *       이전 줄의 AST는 아레나와 함께 무효화됩니다. 줄과 인자 개수에 제한이 없고,
+ *       토큰마다 malloc 하지 않으며 입력 길이에 선형으로 동작합니다.
+ * 반환값: AST (빈 줄이면 항목 0개), 문법 오류면 NULL (오류 메시지 출력됨)
+ */
+struct ast_list *parse_line(struct shell_parser *p, const char *line, size_t len) {
+    struct ast_list *list;
+    struct token tok;
+    size_t n = 0;
+
+    arena_reset(&p->arena);
+    p->nheredocs = 0;
+    p->open_quote = 0;
+    p->pos = line;
+    p->end = line + len;
+
+    list = arena_alloc(&p->arena, sizeof(*list));
+    if (list == NULL) {
+        perror("malloc failed");
+        return NULL;
+    }
+
+    if (lex_next(p, &tok) < 0) return NULL;
+    while (tok.type != TOK_END) {
+        struct ast_item item;
+
+        if (parse_and_or(p, &tok, &item.and_or) < 0) return NULL;
+        item.bg = 0;
+        if (tok.type == TOK_AMP) {
+            item.bg = 1;
+            if (lex_next(p, &tok) < 0) return NULL;
+        } else if (tok.type == TOK_SEMI) {
+            if (lex_next(p, &tok) < 0) return NULL;
+        } else if (tok.type != TOK_END) {
+            syntax_error(p, &tok);
+            return NULL;
+        }
+
+        if (RESERVE(p, items, n) < 0) return NULL;
+        p->items[n++] = item;
+    }
+
+    list->items = arena_copy(&p->arena, p->items, n, sizeof(struct ast_item), 0);
+    if (list->items == NULL) return NULL;
+    list->nitems = (int)n;
+    return list;
+}
+
+/* 이어 붙이는 버퍼의 len 위치에 s를 복사 (부족하면 두 배로 늘림) */
+static int joined_put(struct shell_parser *p, size_t len, const char *s, size_t l) {
+    while (len + l + 1 > p->joined_cap) {
+        size_t cap = p->joined_cap ? p->joined_cap * 2 : 4096;
+        char *grown = realloc(p->joined, cap);
+        if (grown == NULL) {
+            perror("malloc failed");
+            return -1;
+        }
+        p->joined = grown;
+        p->joined_cap = cap;
+    }
+    memcpy(p->joined + len, s, l);
+    p->joined[len + l] = '\0';
+    return 0;
+}
+
+/*
+ * 여러 줄 명령어 파싱 함수
+ * 설명: 줄 끝까지 따옴표가 닫히지 않으면 here 문서 본문처럼 next로 다음 줄을 읽어
+ *       개행과 함께 이어 붙인 뒤 처음부터 다시 파싱합니다 (echo "a<개행>b").
+ *       이어 붙인 개행은 모두 따옴표 안에 있으므로 단어의 일부가 됩니다.
+ *       next가 EOF를 돌려주면 그때 닫히지 않은 따옴표 오류를 보고합니다.
+ * 반환값: parse_line과 같음
+ */
+struct ast_list *parse_lines(struct shell_parser *p, const char *line, size_t len,
+                             line_reader next, void *ctx) {
+    struct ast_list *list;
+    char *more;
+
+    p->more = next != NULL;
+    while ((list = parse_line(p, line, len)) == NULL && p->open_quote && p->more) {
+        if ((more = next(ctx)) == NULL) {
+            if (!p->quiet)
+                fprintf(stderr, "%sunexpected EOF while looking for matching '%c'%s\n",
+                        COLOR_RED, p->open_quote, COLOR_RESET);
+            break;
+        }
+        if (line != p->joined && joined_put(p, 0, line, len) < 0) break;
+        p->joined[len++] = '\n';
+        if (joined_put(p, len, more, strlen(more)) < 0) break;
+        len += strlen(more);
+        line = p->joined;
+    }
+    p->more = 0;
+    return list;
+}
+
+/*
+ * here 문서 본문 읽기 함수 (parse_line 다음에 호출)
+ * 설명: 줄에 나온 순서대로 각 here 문서의 본문을 구분자 줄까지 읽어
+ *       아레나에 저장합니다. 본문 줄에는 따옴표/주석 처리를 하지 않습니다.
+ *       구분자 없이 EOF를 만나면 bash와 같이 경고만 하고 읽은 데까지 사용합니다.
+ * 반환값: 0(성공), -1(메모리 부족)
+ */
+int parse_heredocs(struct shell_parser *p, line_reader next, void *ctx) {
+    for (size_t k = 0; k < p->nheredocs; k++) {
+        struct pending_heredoc *h = &p->heredocs[k];
+        const char *delim = h->redir->target;
+        size_t len = 0;
+
+        for (;;) {
+            char *line = next != NULL ? next(ctx) : NULL;
+            if (line == NULL) {
+                if (!p->quiet)
+                    fprintf(stderr, "%swarning: here-document delimited by end-of-file (wanted '%s')%s\n",
+                            COLOR_RED, delim, COLOR_RESET);
+                break;
+            }
+            if (h->strip_tabs) while (*line == '\t') line++;
+            if (strcmp(line, delim) == 0) break;
+
+            size_t l = strlen(line);
+            while (len + l + 1 > p->text_cap) {
+                size_t cap = p->text_cap ? p->text_cap * 2 : 4096;
+                char *grown = realloc(p->text, cap);
+                if (grown == NULL) {
+                    perror("malloc failed");
+                    return -1;
+                }
+                p->text = grown;
+                p->text_cap = cap;
+            }
+            memcpy(p->text + len, line, l);
+            p->text[len + l] = '\n';
+            len += l + 1;
+        }
+
+        char *body = arena_alloc(&p->arena, len + 1);
+        if (body == NULL) {
+            perror("malloc failed");
+            return -1;
+        }
+        memcpy(body, p->text, len);
+        body[len] = '\0';
+        h->redir->target = body;
+        h->redir->len = len;
+    }
+    p->nheredocs = 0;
+    return 0;
+}
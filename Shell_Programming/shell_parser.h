@@ -0,0 +1,112 @@
+/* shell_parser.h */
+#ifndef SHELL_PARSER_H
+#define SHELL_PARSER_H
+
+#include <stddef.h>
+
+#include "launch.h"
+
+/*
+ * 아레나: 한 줄을 파싱하는 동안 필요한 모든 메모리를 큰 블록에서 잘라 씁니다.
+ * 다음 줄을 파싱할 때는 해제하지 않고 처음으로 되돌려 재사용합니다.
+ */
+struct arena_block {
+    struct arena_block *next;
+    size_t size;
+    size_t used;
+    char data[];
+};
+
+struct arena {
+    struct arena_block *head;   // 첫 블록 (reset 시 여기서부터 다시 사용)
+    struct arena_block *cur;    // 현재 할당 중인 블록
+};
+
+void arena_init(struct arena *a);
+void *arena_alloc(struct arena *a, size_t size);
+void arena_reset(struct arena *a);
+void arena_free(struct arena *a);
+
+/* 단순 명령어: 인자와 재지향 (cmd arg... < in > out) */
+struct ast_command {
+    char **argv;                // NULL로 끝남
+    int argc;
+    struct redir *redirs;
+    int nredirs;
+};
+
+/* 파이프라인: cmd1 | cmd2 | ... (time 키워드 포함) */
+struct ast_pipeline {
+    struct ast_command *cmds;
+    int ncmds;
+    int timed;                  // 'time' 키워드
+};
+
+/* 파이프라인 사이의 연결자 */
+enum ast_connector {
+    AST_SEQ,                    // 첫 파이프라인
+    AST_AND,                    // &&: 앞이 성공하면 실행
+    AST_OR                      // ||: 앞이 실패하면 실행
+};
+
+/* and-or 목록: pipeline && pipeline || pipeline ... */
+struct ast_and_or {
+    struct ast_pipeline *pipes;
+    int *ops;                   // ops[i]: pipes[i] 앞의 연결자 (enum ast_connector)
+    int npipes;
+};
+
+/* 명령어 목록의 항목 (';' 또는 '&'로 끝남) */
+struct ast_item {
+    struct ast_and_or and_or;
+    int bg;                     // '&'로 끝나면 1
+};
+
+/* 한 줄 전체: item ; item & item ... */
+struct ast_list {
+    struct ast_item *items;
+    int nitems;
+};
+
+/* 본문을 아직 읽지 않은 here 문서 (target에는 구분자가 들어 있음) */
+struct pending_heredoc {
+    struct redir *redir;
+    int strip_tabs;             // <<-: 본문과 구분자 줄의 앞쪽 탭 제거
+};
+
+/*
+ * 파서: 아레나와 단계별 임시 배열을 줄 사이에서 재사용합니다.
+ * 임시 배열은 부족할 때만 두 배로 늘어나므로 토큰마다 malloc 하지 않습니다.
+ */
+struct shell_parser {
+    struct arena arena;
+
+    char **words;           size_t words_cap;
+    struct redir *redirs;   size_t redirs_cap;
+    struct ast_command *cmds; size_t cmds_cap;
+    struct ast_pipeline *pipes; size_t pipes_cap;
+    int *ops;               size_t ops_cap;
+    struct ast_item *items; size_t items_cap;
+    struct pending_heredoc *heredocs; size_t heredocs_cap;
+    size_t nheredocs;
+    char *text;             size_t text_cap;        // here 문서 본문을 모으는 버퍼
+    char *joined;           size_t joined_cap;      // 따옴표가 여러 줄에 걸친 명령어를 이어 붙이는 버퍼
+
+    const char *pos;        // 렉서 현재 위치
+    const char *end;
+    int quiet;              // 1이면 문법 오류 메시지를 출력하지 않음 (벤치마크용)
+    int more;               // 1이면 닫히지 않은 따옴표를 오류로 보지 않고 다음 줄을 기다림
+    char open_quote;        // 줄 끝까지 닫히지 않은 따옴표 (없으면 0)
+};
+
+/* 다음 줄을 읽어 오는 함수 (here 문서 본문, 여러 줄 따옴표용, 개행 제외, EOF면 NULL) */
+typedef char *(*line_reader)(void *ctx);
+
+void parser_init(struct shell_parser *p);
+void parser_free(struct shell_parser *p);
+struct ast_list *parse_line(struct shell_parser *p, const char *line, size_t len);
+struct ast_list *parse_lines(struct shell_parser *p, const char *line, size_t len,
+                             line_reader next, void *ctx);
+int parse_heredocs(struct shell_parser *p, line_reader next, void *ctx);
+
+#endif